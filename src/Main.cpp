@@ -18,7 +18,7 @@ using namespace std;  // So that we can write `vector` rather than `std::vector`
 // Very Uncool Global Variable
 // Fixme: Bonus points for making this go away.
 SDL_Window * g_window;
-SDL_Renderer * g_renderer;
+shared_ptr<SFRenderer> g_renderer;
 
 enum userEvents{UPDATE_EVENT};
 
@@ -32,7 +32,7 @@ Uint32 PushUpdateEvent(Uint32 interval, void *param) {
   return interval;
 }
 
-SFError InitGraphics() {
+SFError InitGraphics(SFRENDERER renderer, bool vsync) {
   // Setup screen height and width
   Uint32 width = 640;
   Uint32 height = 480;
@@ -41,6 +41,17 @@ SFError InitGraphics() {
   Uint32 colour_depth = 16; // in bits
   Uint32 delay = 1000/60; // in milliseconds
 
+  // The software renderer draws into memory, so it needs no window (or video at all)
+  if (renderer == SFRENDERER_SOFTWARE) {
+    if (SDL_Init(SDL_INIT_TIMER|SDL_INIT_EVENTS)<0) {
+      cerr << "Failed to initialise SDL: " << SDL_GetError() << endl;
+      throw SF_ERROR_INIT;
+    }
+    g_window = nullptr;
+    g_renderer = SFRenderer::Create(SFRENDERER_SOFTWARE, nullptr);
+    return SF_ERROR_NONE;
+  }
+
   // Initialise SDL - when using C/C++ it's common to have to
   // initialise libraries by calling a function within them.
   if (SDL_Init(SDL_INIT_VIDEO|SDL_INIT_AUDIO|SDL_INIT_TIMER)<0) {
@@ -60,14 +71,14 @@ SFError InitGraphics() {
     throw SF_ERROR_VIDEOMODE;
   }
 
-  g_renderer = SDL_CreateRenderer(g_window, -1, 0);
+  g_renderer = SFRenderer::Create(SFRENDERER_SDL, g_window, vsync);
   if (!g_renderer) {
     cerr << "Failed to create renderer: " << SDL_GetError() << endl;
     throw SF_ERROR_VIDEOMODE;
   }
 
-  //SDL_SetRenderDrawColor(g_renderer, 0, 67, 171, 255);
-	SDL_SetRenderDrawColor(g_renderer, 000, 000, 000, 255);
+  //g_renderer->SetDrawColour(0, 67, 171, 255);
+	g_renderer->SetDrawColour(000, 000, 000, 255);
 
   return SF_ERROR_NONE;
 }
@@ -75,9 +86,15 @@ SFError InitGraphics() {
 int main(int arc, char ** argv) {
   shared_ptr<SFApp> sfapp = nullptr;   
 
+  // Read any command line settings (see SFOptions.h)
+  SFOptions options;
+  if(!options.Parse(arc, argv)) {
+    return SF_ERROR_INIT;
+  }
+
   // Initialise graphics context
   try {
-    InitGraphics();
+    InitGraphics(options.renderer, options.vsync);
   }
   catch (SFError e) {
     return e;
@@ -85,12 +102,23 @@ int main(int arc, char ** argv) {
 
   // Initialise world, setup window and make a new SFApp object (window).
   std::shared_ptr<SFWindow> window = make_shared<SFWindow>(g_window, g_renderer);
-  sfapp = shared_ptr<SFApp>(new SFApp(window));
+  try {
+    sfapp = shared_ptr<SFApp>(new SFApp(window, options));
+  }
+  catch (SFError e) {
+    if (e == SF_ERROR_HANDLES) {
+      cerr << "Too many things in the world to give them all handles" << endl;
+    }
+    return e;
+  }
 
   // Set up top-level timer to UpdateWorld
   // Call the function "display" every delay milliseconds
+  // (the stress test doesn't wait for the timer)
   int delay = 1000/60; // 1000 milis in a second, divide by 60 - the framerate
-  SDL_AddTimer(delay, PushUpdateEvent, NULL);
+  if(!options.stress) {
+    SDL_AddTimer(delay, PushUpdateEvent, NULL);
+  }
 
   // Start game loop
   sfapp->OnExecute();
@@ -0,0 +1,499 @@
+/*********************************************************
+  Dynamic AABB tree broadphase (see SFAABBTree.h).
+
+  The insertion cost and the tree rotations follow the
+  dynamic tree in Box2D: a new leaf goes next to whichever
+  sibling grows the total perimeter of the tree the least,
+  and any node whose children differ in height by more
+  than one is rotated.
+*********************************************************/
+
+#include <algorithm>
+
+#include "SFAABBTree.h"
+
+SFAABBTree::SFAABBTree(float margin, float predict) : root(SF_NULL_PROXY), freeList(SF_NULL_PROXY), proxyCount(0), margin(margin), predict(predict), refits(0), reinserts(0) {
+}
+
+/*********************************************************
+  Nodes are kept in one array and reused through a free
+  list, so a proxy id is just the index of its leaf.
+*********************************************************/
+int SFAABBTree::AllocateNode() {
+  if(freeList == SF_NULL_PROXY) {
+    Node node;
+    node.height = -1;
+    node.parent = SF_NULL_PROXY;
+    nodes.push_back(node);
+    freeList = nodes.size() - 1;
+  }
+
+  int id = freeList;
+  freeList = nodes[id].parent;
+
+  Node & node = nodes[id];
+  node.userData = nullptr;
+  node.parent = SF_NULL_PROXY;
+  node.child1 = SF_NULL_PROXY;
+  node.child2 = SF_NULL_PROXY;
+  node.height = 0;
+  return id;
+}
+
+void SFAABBTree::FreeNode(int id) {
+  nodes[id].parent = freeList;
+  nodes[id].height = -1;
+  freeList = id;
+}
+
+SFProxyId SFAABBTree::CreateProxy(const SFAABB & aabb, void * userData, SFFACTION faction) {
+  int id = AllocateNode();
+  nodes[id].aabb = aabb.Fattened(margin);
+  nodes[id].userData = userData;
+  nodes[id].faction = faction;
+  InsertLeaf(id);
+  proxyCount++;
+  return id;
+}
+
+void SFAABBTree::DestroyProxy(SFProxyId id) {
+  RemoveLeaf(id);
+  FreeNode(id);
+  proxyCount--;
+}
+
+/*********************************************************
+  Called every tick with where the entity is now. Nothing
+  happens while it is still inside its fat box.
+*********************************************************/
+void SFAABBTree::MoveProxy(SFProxyId id, const SFAABB & aabb, const Vector2 & displacement) {
+  if(nodes[id].aabb.Contains(aabb)) {
+    return;
+  }
+
+  // Make a new fat box, stretched ahead in the direction of movement
+  SFAABB fat = aabb.Fattened(margin);
+  Vector2 ahead = displacement * predict;
+  if(ahead.getX() < 0.0f) {
+    fat.lo_x += ahead.getX();
+  }
+  else {
+    fat.hi_x += ahead.getX();
+  }
+  if(ahead.getY() < 0.0f) {
+    fat.lo_y += ahead.getY();
+  }
+  else {
+    fat.hi_y += ahead.getY();
+  }
+
+  if(fat.Overlaps(nodes[id].aabb)) {
+    // Only crept out of the old box, so the leaf stays where it is
+    nodes[id].aabb = fat;
+    Refit(nodes[id].parent);
+    refits++;
+  }
+  else {
+    RemoveLeaf(id);
+    nodes[id].aabb = fat;
+    InsertLeaf(id);
+    reinserts++;
+  }
+}
+
+// Recalculate the boxes from this node up, until one doesn't change
+void SFAABBTree::Refit(int index) {
+  while(index != SF_NULL_PROXY) {
+    Node & node = nodes[index];
+    SFAABB aabb = Union(nodes[node.child1].aabb, nodes[node.child2].aabb);
+    if(aabb.lo_x == node.aabb.lo_x && aabb.lo_y == node.aabb.lo_y && aabb.hi_x == node.aabb.hi_x && aabb.hi_y == node.aabb.hi_y) {
+      return;
+    }
+    node.aabb = aabb;
+    index = node.parent;
+  }
+}
+
+void * SFAABBTree::GetUserData(SFProxyId id) const {
+  return nodes[id].userData;
+}
+
+SFFACTION SFAABBTree::GetFaction(SFProxyId id) const {
+  return nodes[id].faction;
+}
+
+int SFAABBTree::GetProxyCount() const {
+  return proxyCount;
+}
+
+const SFAABB & SFAABBTree::GetFatAABB(SFProxyId id) const {
+  return nodes[id].aabb;
+}
+
+/*********************************************************
+  Puts a leaf next to the sibling that makes the tree's
+  boxes grow the least, then walks back up fixing boxes
+  and heights and rebalancing.
+*********************************************************/
+void SFAABBTree::InsertLeaf(int leaf) {
+  if(root == SF_NULL_PROXY) {
+    root = leaf;
+    nodes[root].parent = SF_NULL_PROXY;
+    return;
+  }
+
+  // Find the best sibling
+  SFAABB leafAABB = nodes[leaf].aabb;
+  int index = root;
+  while(!nodes[index].IsLeaf()) {
+    const Node & node = nodes[index];
+    float area = node.aabb.Perimeter();
+    float combined = Union(node.aabb, leafAABB).Perimeter();
+
+    // Cost of making a new parent for this node and the leaf
+    float cost = 2.0f * combined;
+
+    // Minimum cost of pushing the leaf further down the tree
+    float inheritance = 2.0f * (combined - area);
+
+    float childCost[2];
+    int children[2] = { node.child1, node.child2 };
+    for(int i = 0; i < 2; i++) {
+      const Node & child = nodes[children[i]];
+      childCost[i] = Union(leafAABB, child.aabb).Perimeter() + inheritance;
+      if(!child.IsLeaf()) {
+        childCost[i] -= child.aabb.Perimeter();
+      }
+    }
+
+    if(cost < childCost[0] && cost < childCost[1]) {
+      break;
+    }
+    index = childCost[0] < childCost[1] ? children[0] : children[1];
+  }
+  int sibling = index;
+
+  // Make a new parent for the leaf and its sibling
+  int oldParent = nodes[sibling].parent;
+  int newParent = AllocateNode();
+  nodes[newParent].parent = oldParent;
+  nodes[newParent].aabb = Union(leafAABB, nodes[sibling].aabb);
+  nodes[newParent].height = nodes[sibling].height + 1;
+  nodes[newParent].child1 = sibling;
+  nodes[newParent].child2 = leaf;
+  nodes[sibling].parent = newParent;
+  nodes[leaf].parent = newParent;
+
+  if(oldParent != SF_NULL_PROXY) {
+    if(nodes[oldParent].child1 == sibling) {
+      nodes[oldParent].child1 = newParent;
+    }
+    else {
+      nodes[oldParent].child2 = newParent;
+    }
+  }
+  else {
+    root = newParent;
+  }
+
+  // Fix up the boxes and heights above
+  index = nodes[leaf].parent;
+  while(index != SF_NULL_PROXY) {
+    index = Balance(index);
+
+    Node & node = nodes[index];
+    node.height = 1 + max(nodes[node.child1].height, nodes[node.child2].height);
+    node.aabb = Union(nodes[node.child1].aabb, nodes[node.child2].aabb);
+    index = node.parent;
+  }
+}
+
+/*********************************************************
+  Takes a leaf out of the tree. Its parent goes too and
+  the sibling takes the parent's place.
+*********************************************************/
+void SFAABBTree::RemoveLeaf(int leaf) {
+  if(leaf == root) {
+    root = SF_NULL_PROXY;
+    return;
+  }
+
+  int parent = nodes[leaf].parent;
+  int grandParent = nodes[parent].parent;
+  int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+  if(grandParent == SF_NULL_PROXY) {
+    root = sibling;
+    nodes[sibling].parent = SF_NULL_PROXY;
+    FreeNode(parent);
+    return;
+  }
+
+  if(nodes[grandParent].child1 == parent) {
+    nodes[grandParent].child1 = sibling;
+  }
+  else {
+    nodes[grandParent].child2 = sibling;
+  }
+  nodes[sibling].parent = grandParent;
+  FreeNode(parent);
+
+  int index = grandParent;
+  while(index != SF_NULL_PROXY) {
+    index = Balance(index);
+
+    Node & node = nodes[index];
+    node.height = 1 + max(nodes[node.child1].height, nodes[node.child2].height);
+    node.aabb = Union(nodes[node.child1].aabb, nodes[node.child2].aabb);
+    index = node.parent;
+  }
+}
+
+/*********************************************************
+  If one child of A is more than one level taller than the
+  other, rotate it up to take A's place. Returns whichever
+  node is now where A was.
+
+        A            C
+       / \          / \
+      B   C   =>   A   F/G
+         / \      / \
+        F   G    B   G/F
+*********************************************************/
+int SFAABBTree::Balance(int iA) {
+  Node & A = nodes[iA];
+  if(A.IsLeaf() || A.height < 2) {
+    return iA;
+  }
+
+  int iB = A.child1, iC = A.child2;
+  Node & B = nodes[iB];
+  Node & C = nodes[iC];
+  int balance = C.height - B.height;
+
+  // Rotate C up
+  if(balance > 1) {
+    int iF = C.child1, iG = C.child2;
+    Node & F = nodes[iF];
+    Node & G = nodes[iG];
+
+    C.child1 = iA;
+    C.parent = A.parent;
+    A.parent = iC;
+
+    if(C.parent != SF_NULL_PROXY) {
+      if(nodes[C.parent].child1 == iA) {
+        nodes[C.parent].child1 = iC;
+      }
+      else {
+        nodes[C.parent].child2 = iC;
+      }
+    }
+    else {
+      root = iC;
+    }
+
+    // Keep the taller of F and G up with C
+    if(F.height > G.height) {
+      C.child2 = iF;
+      A.child2 = iG;
+      G.parent = iA;
+      A.aabb = Union(B.aabb, G.aabb);
+      C.aabb = Union(A.aabb, F.aabb);
+      A.height = 1 + max(B.height, G.height);
+      C.height = 1 + max(A.height, F.height);
+    }
+    else {
+      C.child2 = iG;
+      A.child2 = iF;
+      F.parent = iA;
+      A.aabb = Union(B.aabb, F.aabb);
+      C.aabb = Union(A.aabb, G.aabb);
+      A.height = 1 + max(B.height, F.height);
+      C.height = 1 + max(A.height, G.height);
+    }
+    return iC;
+  }
+
+  // Rotate B up
+  if(balance < -1) {
+    int iD = B.child1, iE = B.child2;
+    Node & D = nodes[iD];
+    Node & E = nodes[iE];
+
+    B.child1 = iA;
+    B.parent = A.parent;
+    A.parent = iB;
+
+    if(B.parent != SF_NULL_PROXY) {
+      if(nodes[B.parent].child1 == iA) {
+        nodes[B.parent].child1 = iB;
+      }
+      else {
+        nodes[B.parent].child2 = iB;
+      }
+    }
+    else {
+      root = iB;
+    }
+
+    // Keep the taller of D and E up with B
+    if(D.height > E.height) {
+      B.child2 = iD;
+      A.child1 = iE;
+      E.parent = iA;
+      A.aabb = Union(C.aabb, E.aabb);
+      B.aabb = Union(A.aabb, D.aabb);
+      A.height = 1 + max(C.height, E.height);
+      B.height = 1 + max(A.height, D.height);
+    }
+    else {
+      B.child2 = iE;
+      A.child1 = iD;
+      D.parent = iA;
+      A.aabb = Union(C.aabb, D.aabb);
+      B.aabb = Union(A.aabb, E.aabb);
+      A.height = 1 + max(C.height, D.height);
+      B.height = 1 + max(A.height, E.height);
+    }
+    return iB;
+  }
+
+  return iA;
+}
+
+/*********************************************************
+  Queries. Each walks down from the root, skipping any
+  node whose box the query misses.
+*********************************************************/
+void SFAABBTree::Query(const SFAABB & aabb, vector<SFProxyId> & out) {
+  if(root == SF_NULL_PROXY) {
+    return;
+  }
+
+  stack.clear();
+  stack.push_back(root);
+  while(!stack.empty()) {
+    int index = stack.back();
+    stack.pop_back();
+
+    const Node & node = nodes[index];
+    if(!node.aabb.Overlaps(aabb)) {
+      continue;
+    }
+    if(node.IsLeaf()) {
+      out.push_back(index);
+    }
+    else {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+void SFAABBTree::QueryPoint(const Point2 & p, vector<SFProxyId> & out) {
+  SFAABB aabb = { p.getX(), p.getY(), p.getX(), p.getY() };
+  Query(aabb, out);
+}
+
+void SFAABBTree::RayCast(const Point2 & from, const Point2 & to, vector<SFRayHit> & out) {
+  if(root == SF_NULL_PROXY) {
+    return;
+  }
+
+  Vector2 d = to - from;
+  stack.clear();
+  stack.push_back(root);
+  while(!stack.empty()) {
+    int index = stack.back();
+    stack.pop_back();
+
+    const Node & node = nodes[index];
+    float fraction;
+    if(!node.aabb.RayHit(from, d, fraction)) {
+      continue;
+    }
+    if(node.IsLeaf()) {
+      SFRayHit hit = { index, fraction };
+      out.push_back(hit);
+    }
+    else {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+/*********************************************************
+  Queries the tree with every leaf's box. Each pair would
+  be found from both ends, so it's only kept from the end
+  in the lower numbered faction (and leaves that are never
+  that end don't query at all).
+*********************************************************/
+void SFAABBTree::FindPairs(vector<SFProxyPair> & out) {
+  // Factions that can't hit anything in a higher faction never need to ask
+  bool asks[SFFACTION_LAST];
+  for(int f = 0; f < SFFACTION_LAST; f++) {
+    asks[f] = false;
+    for(int g = f + 1; g < SFFACTION_LAST; g++) {
+      asks[f] = asks[f] || SFFactionsMeet((SFFACTION) f, (SFFACTION) g);
+    }
+  }
+
+  for(size_t i = 0; i < nodes.size(); i++) {
+    if(nodes[i].height != 0 || !asks[nodes[i].faction]) {
+      continue;
+    }
+
+    found.clear();
+    Query(nodes[i].aabb, found);
+    for(auto id : found) {
+      if(nodes[i].faction < nodes[id].faction && SFFactionsMeet(nodes[i].faction, nodes[id].faction)) {
+        SFProxyPair pair = { (SFProxyId) i, id };
+        out.push_back(pair);
+      }
+    }
+  }
+}
+
+const char * SFAABBTree::GetName() const {
+  return "tree";
+}
+
+int SFAABBTree::GetHeight() const {
+  return root == SF_NULL_PROXY ? 0 : nodes[root].height;
+}
+
+int SFAABBTree::GetRefits() const {
+  return refits;
+}
+
+int SFAABBTree::GetReinserts() const {
+  return reinserts;
+}
+
+/*********************************************************
+  Checks the tree is put together properly: parents and
+  children agree, heights add up and every box holds its
+  children. Only meant for tests.
+*********************************************************/
+bool SFAABBTree::Validate() const {
+  if(root == SF_NULL_PROXY) {
+    return proxyCount == 0;
+  }
+  return nodes[root].parent == SF_NULL_PROXY && ValidateNode(root);
+}
+
+bool SFAABBTree::ValidateNode(int index) const {
+  const Node & node = nodes[index];
+  if(node.IsLeaf()) {
+    return node.height == 0 && node.child2 == SF_NULL_PROXY;
+  }
+
+  const Node & c1 = nodes[node.child1];
+  const Node & c2 = nodes[node.child2];
+  return c1.parent == index && c2.parent == index
+    && node.height == 1 + max(c1.height, c2.height)
+    && node.aabb.Contains(c1.aabb) && node.aabb.Contains(c2.aabb)
+    && ValidateNode(node.child1) && ValidateNode(node.child2);
+}
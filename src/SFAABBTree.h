@@ -0,0 +1,92 @@
+#ifndef SFAABBTREE_H
+#define SFAABBTREE_H
+
+#include <vector>
+
+using namespace std;
+
+#include "SFBroadphase.h"
+
+// How much bigger than the entity a box in the tree is, in pixels
+const float SF_AABB_MARGIN = 4.0f;
+
+// How many ticks of movement a box in the tree is stretched ahead by
+const float SF_AABB_PREDICT = 4.0f;
+
+/**
+ * Dynamic bounding volume hierarchy. Every proxy is a leaf holding a
+ * "fat" box: a little bigger than the entity and stretched in the
+ * direction it is moving, so most ticks the entity is still inside it
+ * and MoveProxy has nothing to do.
+ *
+ * When an entity does leave its fat box and the new one overlaps the old
+ * one (it crept out of the edge, which is how everything in this game
+ * moves) the leaf keeps its place and the boxes above it are refit.
+ * Anything that jumps further is taken out and inserted again, with
+ * rotations to keep the tree balanced.
+ *
+ * Boxes of wildly different sizes (the 700x700 stars next to 19x18
+ * projectiles) are no trouble, unlike a grid with a fixed cell size.
+ */
+class SFAABBTree : public SFBroadphase {
+public:
+  SFAABBTree(float margin = SF_AABB_MARGIN, float predict = SF_AABB_PREDICT);
+
+  SFProxyId CreateProxy(const SFAABB &, void * userData, SFFACTION);
+  void      DestroyProxy(SFProxyId);
+  void      MoveProxy(SFProxyId, const SFAABB &, const Vector2 & displacement);
+  void *    GetUserData(SFProxyId) const;
+  SFFACTION GetFaction(SFProxyId) const;
+  int       GetProxyCount() const;
+
+  void      Query(const SFAABB &, vector<SFProxyId> &);
+  void      QueryPoint(const Point2 &, vector<SFProxyId> &);
+  void      RayCast(const Point2 & from, const Point2 & to, vector<SFRayHit> &);
+  void      FindPairs(vector<SFProxyPair> &);
+
+  const char * GetName() const;
+
+  const SFAABB & GetFatAABB(SFProxyId) const;
+  int       GetHeight() const;
+  int       GetRefits() const;
+  int       GetReinserts() const;
+  bool      Validate() const;
+
+private:
+  struct Node {
+    SFAABB    aabb;
+    void    * userData;
+    SFFACTION faction;
+    int       parent;   // Next free node when this one isn't used
+    int       child1, child2;
+    int       height;   // 0 for leaves, -1 when free
+
+    bool IsLeaf() const { return child1 == SF_NULL_PROXY; }
+  };
+
+  int   AllocateNode();
+  void  FreeNode(int);
+  void  InsertLeaf(int);
+  void  RemoveLeaf(int);
+  int   Balance(int);
+  void  Refit(int);
+  bool  ValidateNode(int) const;
+
+  vector<Node>  nodes;
+  int           root;
+  int           freeList;
+  int           proxyCount;
+
+  float         margin;
+  float         predict;
+
+  int           refits;
+  int           reinserts;
+
+  // Nodes still to visit during a query, and what FindPairs found for
+  // each leaf, kept so queries don't allocate
+  vector<int>       stack;
+  vector<SFProxyId> found;
+};
+
+#endif
@@ -14,6 +14,7 @@
 
 #include "SFApp.h"
 #include "SFEvent.h"
+#include "SFSoftwareRenderer.h"
 
 /***********************************************************
   This is the initial constructor for the class.
@@ -21,10 +22,31 @@
   This will setup the spawning positions of the objects
   such as players, enemies and any other instances in-game
 ***********************************************************/
-SFApp::SFApp(std::shared_ptr<SFWindow> window) : fire(0), is_running(true), sf_window(window) {
-  int canvas_w, canvas_h;
-  SDL_GetRendererOutputSize(sf_window->getRenderer(), &canvas_w, &canvas_h);
+// The level's walls are made before the constructor can ask the renderer anything
+static int CanvasHeight(shared_ptr<SFWindow> window) {
+  int w, h;
+  window->getRenderer()->GetOutputSize(w, h);
+  return h;
+}
 
+SFApp::SFApp(std::shared_ptr<SFWindow> window, const SFOptions & opts) : fire(0), is_running(true), options(opts), sf_window(window),
+  pProjectilePool(SFASSET_PROJECTILE, window, 32), eProjectilePool(SFASSET_EPROJECTILE, window, 32), alienPool(SFASSET_ALIEN, window, 32),
+  coinPool(SFASSET_COIN, window, 16), powerPool(SFASSET_POWERUP, window, 16),
+  hudGreenPool(SFASSET_HEALTHBLOCKG, window, 10), hudYellowPool(SFASSET_HEALTHBLOCKY, window, 10), hudRedPool(SFASSET_HEALTHBLOCKR, window, 10),
+  background(window, opts.starLayers, opts.stars),
+  effects(window, opts.particles), tiles(1, CanvasHeight(window)), tileLayer(window, tiles), layers(window), waves(opts.spawnsPerFrame, opts.record.empty() ? opts.spawnBudgetUs / 1000.0 : 0.0),
+  tracker(SDL_GetPerformanceFrequency()), latency(SDL_GetPerformanceFrequency()), present(opts.vsync ? SFPRESENT_VSYNC : SFPRESENT_IMMEDIATE),
+  governor(opts.frameBudgetMs), recorder(opts.hitchMs), frameArena(64 * 1024) {
+  int canvas_w, canvas_h;
+  sf_window->getRenderer()->GetOutputSize(canvas_w, canvas_h);
+
+  overlay = make_shared<SFOverlay>(sf_window);
+  broadphase = SFBroadphase::Create(options.broadphase);
+  SFAsset::SetPixelCollisions(options.pixelCollisions);
+  events.Subscribe(this);
+  events.Subscribe(&stats);
+  events.Subscribe(&effects);
+  SFProfiler::SetMemoryLog(options.memoryLog);
   app_box = make_shared<SFBoundingBox>(Vector2(canvas_w, canvas_h), canvas_w, canvas_h);
   player  = make_shared<SFAsset>(SFASSET_PLAYER, sf_window);
 
@@ -34,41 +56,38 @@ SFApp::SFApp(std::shared_ptr<SFWindow> window) : fire(0), is_running(true), sf_w
   player->SetHealth(100);
   player->SetScore(10);
 
-  const int number_of_aliens = 10;
+  // The stress test sets up its own (much bigger) world
+  const int number_of_aliens = options.stress ? 0 : 10;
   for(int i = 0; i < number_of_aliens; i++) {
-    // place an alien at width/number_of_aliens * i
-    auto alien = make_shared<SFAsset>(SFASSET_ALIEN, sf_window);
-    auto pos  = Point2(rand() % 600 + 32, rand() % 400 + 600);
-
-    // Make enemy at position and set it's health
-    alien->SetPosition(pos);
-    alien->SetHealth(15);
-    alien->SetFired(0);
-
-    aliens.push_back(alien);
-
-    cout << "Created enemy with " << alien->GetHealth() << endl;
+    SpawnAlien();
   }
 
-  for(int i = 0; i < 2; i++) {
+  for(int i = 0; i < (options.stress ? 0 : 2); i++) {
     // Spawn in coins
-    auto coin = make_shared<SFAsset>(SFASSET_COIN, sf_window);
+    auto coin = coinPool.Spawn();
     auto pos  = Point2(rand() % 600 + 32, rand() % 400 + 600); 
     coins.push_back(coin);
   }
 
-  for(int i = 0; i < 2; i++){
-    auto star = make_shared<SFAsset>(SFASSET_STARS, sf_window);
-    auto pos = (i == 0 ? Point2(320, 1000) : Point2(320, 1600));
-    star->SetPosition(pos);
-    stars.push_back(star);
-  }
-
   auto hpBar = make_shared<SFAsset>(SFASSET_HEALTHBAR, sf_window);
   auto pos = Point2(92, 488);
   hpBar->SetPosition(pos);
   healthBar.push_back(hpBar);
 
+  // The HUD is all down the left, no wider than the health bar. Drawing in software costs by
+  // the pixel rather than the draw call, so there copying a layer costs more than the handful
+  // of sprites it saves. The stars are one batch already, which is less to fill than copying
+  // a screen sized texture of them would be.
+  if(options.layerCache && options.renderer == SFRENDERER_SDL) {
+    SFRect bar = hpBar->GetScreenRect();
+    layers.Cache(SFLAYER_HUD, bar.x + bar.w, canvas_h, false);
+  }
+
+  if(options.stress) {
+    SpawnStress();
+    return;
+  }
+
   cout << endl << "Welcome to the game, you have " << player->GetHealth() << " HP." << endl;
   cout << "You start with " << player->GetScore() << " points, use these points wisely as each bullet will use 1 point." << endl;
   cout << "Hitting enemy will give you back the point, killing will give you 10 points." << endl << "Running out of points or death is game over!" << endl << endl;
@@ -102,16 +121,19 @@ void SFApp::OnEvent(SFEvent& event) {
   switch(the_event) {
     // This is the update event returned from Point2(rand() % 600 + 32, rand() % 400 + 600);SFEvent::GetCode();
     case SFEVENT_UPDATE: {
-      // Update world and renderer.
-      
-      // Check if the game is paused
-      if(!is_paused){
-        // Not paused, update world.
-        OnUpdateWorld();
+      // Everything pressed or let go since the last frame (presses of fire don't count while paused),
+      // tagged so the frame that shows them can say how long they took (see SFLatency.h)
+      uint64_t now = SDL_GetPerformanceCounter();
+      input = tracker.Tick(keys, now);
+      if(is_paused) {
+        input.fires = 0;
+      }
+      else {
+        latency.Consume(tracker.GetArrivals(), now);
       }
 
-      // Render objects
-      OnRender();
+      // Update world and renderer.
+      StepFrame();
 
       // Break out of switch statement.
       break;
@@ -128,22 +150,19 @@ void SFApp::OnEvent(SFEvent& event) {
       PauseGame();
       break;
     }
-    // This handles the firing of projectiles, this has been left here so it only checks and delays rapid firing.
+    // Show or hide the performance overlay
+    case SFEVENT_OVERLAY: {
+      overlay->Toggle();
+      break;
+    }
+    // Switch vsync, to compare how long keys take to show up
+    case SFEVENT_VSYNC: {
+      ToggleVSync();
+      break;
+    }
+    // The presses of fire are counted from the key queue when the next frame starts (see SFInputQueue.h),
+    // so the shot goes at the start of the next frame and a recorded session fires on the same frame.
     case SFEVENT_FIRE: {
-      // Make sure game is not paused
-      if(!is_paused){
-        // Check if we can fire (maxProjectiles limits the total on screen allowed)
-        if(fire < maxProjectiles){
-          // Count how many projectiles were fired in the entire session.
-          totalProjectiles++;
-
-          // Add to the fire limit counter.
-          fire++;
-
-          // Fire a projectile.
-          FireProjectile(player->GetPosition(), true);
-        }
-      }
       // Break out of statement.
       break;
     }
@@ -161,9 +180,17 @@ void SFApp::OnEvent(SFEvent& event) {
   and keeps it running while the is_running var is true
 ***********************************************************/
 int SFApp::OnExecute() {
+  // The stress test runs flat out rather than waiting for timer events
+  if(options.stress) {
+    return RunStress();
+  }
+
   // Setup SDL event
   SDL_Event event;
 
+  // Queue the keys as SDL reads them, for the update event to pick up
+  SFKeyWatch watch(keys);
+
   // While our program is running and waiting for events
   while (SDL_WaitEvent(&event) && is_running) {
     // Process the event as an SFEvent (SFEvent.cpp)
@@ -172,6 +199,104 @@ int SFApp::OnExecute() {
     // Now process our event in the SFApp::OnEvent(); method (SFApp.cpp)
     OnEvent(sfevent);
   }
+  return 0;
+}
+
+/***********************************************************
+  One whole frame: update the world (unless paused), draw
+  it, and tell the profiler and flight recorder how it
+  went. The game loop, the stress test and the performance
+  gate all run frames through here.
+***********************************************************/
+void SFApp::StepFrame() {
+  SFProfiler::BeginFrame();
+
+  // Check if the game is paused
+  if(!is_paused){
+    // Not paused, update world.
+    OnUpdateWorld();
+  }
+
+  // Render objects, unless --fps-cap skips this tick's
+  if(DrawDue()) {
+    OnRender();
+  }
+
+  // That's the end of a frame as far as the profiler is concerned
+  SFProfiler::EndFrame();
+  SFProfiler::TrackEntities(GetEntityCounts());
+  RecordFrame();
+  overlay->OnFrame(SFProfiler::GetFrameIntervalMs());
+
+  // What the frame cost to update and draw, not counting waiting for the display
+  double workMs = SFProfiler::GetUpdateMs() + SFProfiler::GetPhaseMs(SFPHASE_RENDER) - presentMs;
+  presentMs = 0.0;
+  if(governor.AddFrame(workMs)) {
+    cout << "Quality " << SFGovernor::GetName(governor.GetQuality()) << " (90% of frames within "
+         << governor.GetP90Ms() << " ms, budget " << governor.GetBudgetMs() << " ms)" << endl;
+    SetQuality(governor.GetQuality());
+  }
+}
+
+/***********************************************************
+  The optional work each quality does. Only scenery is
+  cut, nothing that changes what happens in the game.
+***********************************************************/
+void SFApp::SetQuality(SFQUALITY quality) {
+  switch(quality) {
+    case SFQUALITY_HIGH:
+      background.SetLayersDrawn(options.starLayers);
+      effects.SetDensity(1.0f);
+      overlay->SetGraph(true);
+      break;
+    case SFQUALITY_MEDIUM:
+      background.SetLayersDrawn(max(1, options.starLayers - 1));
+      effects.SetDensity(0.5f);
+      overlay->SetGraph(true);
+      break;
+    default:
+      background.SetLayersDrawn(min(1, options.starLayers));
+      effects.SetDensity(0.25f);
+      overlay->SetGraph(false);
+      break;
+  }
+}
+
+/***********************************************************
+  Whether this tick draws a frame. With --fps-cap each tick
+  earns the cap's worth of credit and a draw costs a
+  second's worth of ticks, so the draws are spread evenly
+  and never more than the cap.
+***********************************************************/
+bool SFApp::DrawDue() {
+  if(options.fpsCap <= 0 || options.fpsCap >= SF_TICKS_PER_SECOND) {
+    return true;
+  }
+  drawCredit += options.fpsCap;
+  if(drawCredit < SF_TICKS_PER_SECOND) {
+    return false;
+  }
+  drawCredit -= SF_TICKS_PER_SECOND;
+  return true;
+}
+
+void SFApp::ToggleVSync() {
+  SFPRESENT next = present == SFPRESENT_VSYNC ? SFPRESENT_IMMEDIATE : SFPRESENT_VSYNC;
+  if(!sf_window->getRenderer()->SetVSync(next == SFPRESENT_VSYNC)) {
+    cout << "Vsync can't be switched with this renderer" << endl;
+    return;
+  }
+  present = next;
+  cout << "Presenting " << SFLatencyTracer::GetName(present) << endl;
+}
+
+// What the player does next frame, for playing back a session
+void SFApp::SetInput(const SFInputState & next) {
+  input = next;
+}
+
+bool SFApp::IsRunning() {
+  return is_running;
 }
 
 /***********************************************************
@@ -187,42 +312,48 @@ int SFApp::OnExecute() {
 void SFApp::OnUpdateWorld() {
   // Get the width and height of our renderer
   int w, h;
-  SDL_GetRendererOutputSize(sf_window->getRenderer(), &w, &h);
+  sf_window->getRenderer()->GetOutputSize(w, h);
 
-	player->HandleInput();
+  // Start a new step so collisions sweep over this tick's movement only
+  SFAsset::BeginStep();
 
-  // Handle game-over conditions
-  if(player->GetHealth() <= 0 || player->GetScore() <= 0){
-    cout << endl <<  "Game Over! " << (player->GetHealth() <= 0 ? "You have died!" : (player->GetScore() <= 0 ? "No more points left!" : "")) << endl << "Check your statistics below!" << endl;
-    EndGame();
-    is_running = false;
-  }
-
-  if(player->GetScore() > 1200 && gameDifficulty != 5) {
-    gameDifficulty = 5;
-    GameDifficultyModifier(gameDifficulty);
-  }
-  if(player->GetScore() > 1000 && player->GetScore() < 1200 && gameDifficulty != 4) {
-    gameDifficulty = 4;
-    GameDifficultyModifier(gameDifficulty);
+  SFProfiler::BeginPhase(SFPHASE_INPUT);
+  Point2 before = player->GetPosition();
+  if(options.stress) {
+    StressInput();
   }
-  if(player->GetScore() > 850 && player->GetScore() < 1000 && gameDifficulty != 3) {
-    gameDifficulty = 3;
-    GameDifficultyModifier(gameDifficulty);
-  }
-  if(player->GetScore() > 600 && player->GetScore() < 850 && gameDifficulty != 2) {
-    gameDifficulty = 2;
-    GameDifficultyModifier(gameDifficulty);
+  else {
+	  player->HandleInput(input);
+    for(int i = 0; i < input.fires; i++) {
+      PlayerFire();
+    }
+    if(!options.record.empty()) {
+      session.Record(input);
+    }
   }
-  if(player->GetScore() > 300 && player->GetScore() < 600 && gameDifficulty != 1) {
-    gameDifficulty = 1;
-    GameDifficultyModifier(gameDifficulty);
+  input.fires = 0;
+  KeepOutOfWalls(before);
+
+  SFProfiler::BeginPhase(SFPHASE_OTHER);
+
+  // The stress test keeps the world as it was set up, no stages or game over
+  if(!options.stress) {
+    // Handle game-over conditions
+    if(player->GetHealth() <= 0 || player->GetScore() <= 0){
+      cout << endl <<  "Game Over! " << (player->GetHealth() <= 0 ? "You have died!" : (player->GetScore() <= 0 ? "No more points left!" : "")) << endl << "Check your statistics below!" << endl;
+      EndGame();
+      is_running = false;
+    }
+
+    // (the stage follows the score in OnScoreChanges)
+    if(player->GetScore() >= 1500){
+      cout << endl <<  "Game Over! You have won the game and saved Earth's code!" << endl;
+      EndGame();
+      is_running = false;
+    }
   }
-	if(player->GetScore() >= 1500){
-		cout << endl <<  "Game Over! You have won the game and saved Earth's code!" << endl;
-		EndGame();
-		is_running = false;	
-	}
+
+  SFProfiler::BeginPhase(SFPHASE_MOVEMENT);
 
   // Update projectile positions
   for(auto pp: pProjectiles) {
@@ -234,129 +365,99 @@ void SFApp::OnUpdateWorld() {
     ep->MoveVertical(-5.0f - gameDifficulty);
   }
 
-  for(auto s : stars){ 
-    s->MoveVertical(-0.5f - (gameDifficulty / 2));
-  }
+  // The stars scroll faster the harder the stage (the background is drawn every frame, it isn't cached)
+  background.Scroll(0.5f + (gameDifficulty / 2));
 
   for(auto power: powers){
     power->MoveVertical(-3.0f);
-
-    if(player->CollidesWith(power)){
-      firePower = 1;
-      firePowerTime = 300;
-      power->HandleCollision();
-    }
   }
 
-  if(firePower == 1){
-    if(firePowerTime > 1){
-      firePowerTime--;
-    }
-    else{
-      firePower = 0;
-    }
-  }
-
-  // Update collectible positions and check collisions
+  // Update collectible positions
   for(auto c : coins) {
     // Move collectible coin south
 		c->MoveVertical(-1.0f);
-
-    // Check player collision with coin
-    if(player->CollidesWith(c)) {
-      // Output a message
-      cout << "Power up! You can now fire more projectiles!" << endl;
-      
-      // Handle the collision
-      if(c->HandleCollision()){
-        // Add to our counter for this session
-        coinsCollected++;
-
-        // allow more firepower for the player
-        maxProjectiles += 1;
-      }
-    }
   }
 
-  // Update enemy positions and check player collisions
+  // Update enemy positions
   for(auto a : aliens) {
     // Move the enemy south
     a->MoveVertical(-2.0f - gameDifficulty);
+  }
 
-    if(a->HandleProjectile()){
-      FireProjectile(a->GetPosition(), false);
-      cout << "Enemy fired projectile" << endl;
-    }
+  // Enemy fire, power up expiry and waves are all timers, so only the ones due now cost anything
+  fired.clear();
+  timers.Advance(currTick, fired);
+  for(auto & f : fired) {
+    OnTimer(f);
+  }
 
-    // Check if player collides with enemy
-    if(player->CollidesWith(a)) {
-      // Remove 10 health
-      player->SetHealth(player->GetHealth() - 10);
-      
-      // Special collisions detection for player colliding with enemies (instant kill enemy + removed 10HP from player)
-      if(a->IsAlive()){
-        a->HandlePlayerCollision();
-      }
+  // Carry on with any waves that are still arriving, as much as this frame's budget allows
+  waves.Update(*this);
 
-      // Add one to enemy kill counter
-      enemiesKilled++;
+  effects.Update();
 
-      // Output left over health after collision
-      cout << "Crashed with an enemy " << a->GetId() << "! Taking 10 damage. (PlayerHP: " << player->GetHealth() << ")" << endl;
-    }
+  // The walls come down at the speed of the coins
+  if(options.walls) {
+    tiles.Advance(1.0f);
+    PushOutOfWalls();
   }
 
-  // Check for collisions on projectiles
+  SFProfiler::BeginPhase(SFPHASE_COLLISION);
+
+  // Bring everything's box in the broadphase up to date with where it went this step
+  UpdateProxy(player.get(), SFFACTION_PLAYER);
   for(auto p : pProjectiles) {
-    // Check through all enemies
-    for(auto a : aliens) {
-      // If the projectile collides with the alien
-      if(p->CollidesWith(a)) {
-        // Get the alien position
-        auto aPos = a->GetPosition();
-        
-        // Handle the collisions for both projectile and enemy
-        p->HandleCollision();
-
-        // Set the score back up as the projectile hit
-        player->SetScore(player->GetScore() + 1);
-        
-        // If HandleCollision returns a special value (1) to show enemy run out of HP
-        if(a->HandleCollision() == 1){
-          // Add 10 points to score
-          player->SetScore(player->GetScore() + 10);
-
-          // Add to our counter for the kill
-          enemiesKilled++;
-
-          // Decide if a collectible should be dropped
-          int check = (rand() % 600 + 32);
-          if(check >= 0 && check <= 200){
-            // Output some message
-            cout << "Coin dropped!" << endl;
-
-            // Drop some loot
-            auto coin = make_shared<SFAsset>(SFASSET_COIN, sf_window);
-            auto pos  = Point2(aPos);
-            coin->SetPosition(pos);
-            coins.push_back(coin);
-          }
-          else if(check >= 200 && check <= 300) {
-            cout << "Powerup dropped!" << endl;
-
-            // Drop some loot
-            auto power = make_shared<SFAsset>(SFASSET_POWERUP, sf_window);
-            auto pos  = Point2(aPos);
-            power->SetPosition(pos);
-            powers.push_back(power);
-          }
-        }
-      }
+    UpdateProxy(p.get(), SFFACTION_PPROJECTILE);
+  }
+  for(auto a : aliens) {
+    UpdateProxy(a.get(), SFFACTION_ALIEN);
+  }
+  for(auto p : eProjectiles) {
+    UpdateProxy(p.get(), SFFACTION_EPROJECTILE);
+  }
+  for(auto c : coins) {
+    UpdateProxy(c.get(), SFFACTION_PICKUP);
+  }
+  for(auto power : powers) {
+    UpdateProxy(power.get(), SFFACTION_PICKUP);
+  }
+
+  // Only the pairs the broadphase finds need the exact (swept) check
+  pairs.clear();
+  broadphase->FindPairs(pairs);
+  for(auto & pair : pairs) {
+    auto a = (SFAsset *) broadphase->GetUserData(pair.a);
+    auto b = (SFAsset *) broadphase->GetUserData(pair.b);
+    if(!a->CollidesWith(b)) {
+      continue;
+    }
+
+    SFCollisionEvent hit = { a->GetId(), b->GetId(), broadphase->GetFaction(pair.a), broadphase->GetFaction(pair.b) };
+    events.Post(hit);
+
+    // The pair's first asset is always the player or a player projectile
+    if(hit.factionA == SFFACTION_PLAYER) {
+      PlayerHit(b, hit.factionB);
+    }
+    else {
+      ProjectileHit(a, b);
     }
   }
 
-  // Removing dead enemies from the array (long method, could be quicker using a list, maybe...)
-  list<shared_ptr<SFAsset>> alienTemp;
+  // Shots that didn't hit anything else stop at the walls
+  ShootWalls(pProjectiles);
+  ShootWalls(eProjectiles);
+
+  // Everything that reacts to what happened this tick (score, stage, loot, HUD, stats)
+  SFProfiler::BeginPhase(SFPHASE_EVENTS);
+  events.Dispatch();
+
+  SFProfiler::BeginPhase(SFPHASE_CLEANUP);
+
+  // Removing dead enemies from the array. The temp arrays live in the frame
+  // arena so building them doesn't touch the heap.
+  SFFrameVector<shared_ptr<SFAsset>> alienTemp(frameArena);
+  alienTemp.reserve(aliens.size());
   // For each enemy in the array
   for(auto a : aliens) {
     // Check if it is alive
@@ -364,14 +465,18 @@ void SFApp::OnUpdateWorld() {
       // If alive, push it to the new temp array
       alienTemp.push_back(a);
     }
+    else {
+      // Dead ones don't need to be in the broadphase any more, and go back to the pool
+      RemoveProxy(a.get());
+      alienPool.Release(a);
+    }
   }
-  // Any leftover enemies will be cleared
-  aliens.clear();
-  // Set the alive enemies back into the main array
-  aliens = list<shared_ptr<SFAsset>>(alienTemp);
+  // Set the alive enemies back into the main array (any leftover enemies are cleared)
+  aliens.assign(alienTemp.begin(), alienTemp.end());
 
   // Remove all dead (player) projectiles
-  list<shared_ptr<SFAsset>> pProjTemp;
+  SFFrameVector<shared_ptr<SFAsset>> pProjTemp(frameArena);
+  pProjTemp.reserve(pProjectiles.size());
   // For each projectile
   for(auto p : pProjectiles) {
     // Check if alive
@@ -382,14 +487,16 @@ void SFApp::OnUpdateWorld() {
     else{
       // Decrease the counter for total bullets on screen
       fire--;
+      RemoveProxy(p.get());
+      pProjectilePool.Release(p);
     }
   }
   // Clear old bullets and set alive ones back to array
-  pProjectiles.clear();
-  pProjectiles = list<shared_ptr<SFAsset>>(pProjTemp);
+  pProjectiles.assign(pProjTemp.begin(), pProjTemp.end());
 
-  // Remove all dead (enemy) projectiles
-  list<shared_ptr<SFAsset>>eProjTemp;
+  // Remove all dead (enemy) projectiles, these don't count towards the player's fire limit
+  SFFrameVector<shared_ptr<SFAsset>> eProjTemp(frameArena);
+  eProjTemp.reserve(eProjectiles.size());
   // For each projectile
   for(auto p : eProjectiles) {
     // Check if alive
@@ -397,17 +504,17 @@ void SFApp::OnUpdateWorld() {
       // Add alive to new temp array
       eProjTemp.push_back(p);
     }
-    else{
-      // Decrease the counter for total bullets on screen
-      fire--;
+    else {
+      RemoveProxy(p.get());
+      eProjectilePool.Release(p);
     }
   }
   // Clear old bullets and set alive ones back to array
-  eProjectiles.clear();
-  eProjectiles = list<shared_ptr<SFAsset>>(eProjTemp);
+  eProjectiles.assign(eProjTemp.begin(), eProjTemp.end());
 
   // Remove all dead collectibles
-  list<shared_ptr<SFAsset>> collTemp;
+  SFFrameVector<shared_ptr<SFAsset>> collTemp(frameArena);
+  collTemp.reserve(coins.size());
   // For each coin
   for(auto c : coins) {
     // Check if alive
@@ -415,14 +522,18 @@ void SFApp::OnUpdateWorld() {
       // Add alive to new temp array
       collTemp.push_back(c);
     }
+    else {
+      RemoveProxy(c.get());
+      coinPool.Release(c);
+    }
   }
   // Clear old coins and set alive ones back to array
-  coins.clear();
-  coins = list<shared_ptr<SFAsset>>(collTemp);
+  coins.assign(collTemp.begin(), collTemp.end());
 
 
   // Remove all dead powerups
-  list<shared_ptr<SFAsset>> powTemp;
+  SFFrameVector<shared_ptr<SFAsset>> powTemp(frameArena);
+  powTemp.reserve(powers.size());
   // For each powerup
   for(auto power : powers) {
     // Check if alive
@@ -430,18 +541,387 @@ void SFApp::OnUpdateWorld() {
       // Add alive to new temp array
       powTemp.push_back(power);
     }
+    else {
+      RemoveProxy(power.get());
+      powerPool.Release(power);
+    }
   }
   // Clear old powerups and set alive ones back to array
-  powers.clear();
-  powers = list<shared_ptr<SFAsset>>(powTemp);
+  powers.assign(powTemp.begin(), powTemp.end());
 
-  // Clear-out the HPBlock list and update it
-  healthBlocks.clear();
-  stage.clear();
+  // Update the HP blocks and stage indicator if they changed
+  SFProfiler::BeginPhase(SFPHASE_HUD);
   DrawHud();
 
   // Increase the tick counter (used to calculate time played)
   currTick++;
+
+  // Everything in the frame arena is finished with now
+  frameArena.Reset();
+  SFProfiler::BeginPhase(SFPHASE_OTHER);
+}
+
+/***********************************************************
+  Does whatever a timer that just went off was set for.
+  Timers for an alien hold its ID, so if it died in the
+  meantime Find gives nullptr and the timer is ignored.
+***********************************************************/
+void SFApp::OnTimer(const SFTimerFired & f) {
+  switch(f.kind) {
+    case SFTIMER_POWER_EXPIRE:
+      firePower = 0;
+      break;
+    case SFTIMER_ENEMY_FIRE: {
+      SFAsset * alien = SFAsset::Find(f.target);
+      if(alien && alien->IsAlive() && alien->GetFired() < 1) {
+        alien->SetFired(alien->GetFired() + 1);
+        FireProjectile(alien->GetPosition(), false);
+        cout << "Enemy fired projectile" << endl;
+      }
+      break;
+    }
+    case SFTIMER_EMITTER_FIRE:
+      FireProjectile(emitters[f.data], false);
+      break;
+  }
+}
+
+/***********************************************************
+  Puts a new alien in the spawn band above the screen and,
+  in the stress test, decides when it will fire.
+
+  In the game the aliens' fire roll could never come up, so
+  they don't fire and that's left alone. The stress test
+  gives them the 1 in 200 chance a tick the roll looks like
+  it meant, to load the engine with enemy shots. The wait
+  before it first comes up is drawn here (the same
+  geometric distribution), so the alien costs nothing until
+  its timer goes off.
+***********************************************************/
+void SFApp::SpawnAlien() {
+  auto pos  = Point2(rand() % 600 + 32, rand() % 400 + 600);
+  SpawnWaveAlien(pos);
+}
+
+void SFApp::SpawnWaveAlien(const Point2 & where) {
+  auto alien = alienPool.Spawn();
+  auto pos  = Point2(where);
+
+  // Make enemy at position and set it's health
+  alien->SetPosition(pos);
+  alien->SetHealth(15);
+  alien->SetFired(0);
+
+  aliens.push_back(alien);
+
+  if(options.stress) {
+    double roll = rand() / (RAND_MAX + 1.0);
+    int wait = 1 + (int) (log(1.0 - roll) / log(1.0 - SF_ALIEN_FIRE_CHANCE));
+    timers.Schedule(wait, SFTIMER_ENEMY_FIRE, alien->GetId());
+  }
+  else {
+    cout << "Created enemy with " << alien->GetHealth() << endl;
+  }
+}
+
+int SFApp::GetAlienCount() {
+  return aliens.size();
+}
+
+/***********************************************************
+  The script for the wave that arrives with each stage.
+  Waves spawn a few aliens a frame (see SFWaveRunner), so
+  a big one never lands all in the same tick.
+***********************************************************/
+SFWave SFApp::StageWave(int stage) {
+  SFWave wave("stage");
+  switch(stage) {
+    case 1:
+      wave.Spawn(2);
+      break;
+    case 2:
+      wave.Spawn(3, SFWAVE_LINE);
+      break;
+    case 3:
+      wave.Spawn(5, SFWAVE_VEE);
+      break;
+    case 4:
+      // A vee, then a line behind it once the vee is on its way down
+      wave.Spawn(5, SFWAVE_VEE).Wait(90).Spawn(4, SFWAVE_LINE);
+      break;
+    default:
+      // Stage 5 is only faster, it doesn't bring any more aliens
+      break;
+  }
+  return wave;
+}
+
+/***********************************************************
+  Gives an asset a box in the broadphase the first time
+  it's seen, after that just moves it.
+***********************************************************/
+void SFApp::UpdateProxy(SFAsset * asset, SFFACTION faction) {
+  if(asset->GetProxy() == SF_NULL_PROXY) {
+    asset->SetProxy(broadphase->CreateProxy(asset->GetSweptBounds(), asset, faction));
+  }
+  else {
+    broadphase->MoveProxy(asset->GetProxy(), asset->GetSweptBounds(), asset->GetDisplacement());
+  }
+}
+
+void SFApp::RemoveProxy(SFAsset * asset) {
+  if(asset->GetProxy() != SF_NULL_PROXY) {
+    broadphase->DestroyProxy(asset->GetProxy());
+    asset->SetProxy(SF_NULL_PROXY);
+  }
+}
+
+// Every change to the player's health goes through here, so the HUD always shows it
+void SFApp::HurtPlayer(int damage) {
+  player->SetHealth(player->GetHealth() - damage);
+  hudDirty = true;
+}
+
+/***********************************************************
+  The player ran into something: an enemy, an enemy
+  projectile or a pickup.
+***********************************************************/
+void SFApp::PlayerHit(SFAsset * other, SFFACTION faction) {
+  if(faction == SFFACTION_ALIEN) {
+    // Remove 10 health
+    HurtPlayer(10);
+
+    // Special collisions detection for player colliding with enemies (instant kill enemy + removed 10HP from player)
+    SFKillEvent kill = { other->GetId(), other->GetPosition(), SFFACTION_PLAYER };
+    if(other->IsAlive()){
+      other->HandlePlayerCollision();
+    }
+    events.Post(kill);
+
+    // Output left over health after collision
+    cout << "Crashed with an enemy " << SFHandleIndex(other->GetId()) << "! Taking 10 damage. (PlayerHP: " << player->GetHealth() << ")" << endl;
+  }
+  else if(faction == SFFACTION_EPROJECTILE && other->IsAlive()) {
+    HurtPlayer(5);
+    other->HandleCollision();
+    cout << "Hit by an enemy projectile! Taking 5 damage. (PlayerHP: " << player->GetHealth() << ")" << endl;
+  }
+  else if(faction == SFFACTION_PICKUP && other->IsAlive()) {
+    SFPickupEvent pickup = { other->GetId(), other->GetType() == SFASSET_POWERUP, other->GetPosition() };
+    if(pickup.powerup) {
+      other->HandleCollision();
+      events.Post(pickup);
+    }
+    else {
+      // Output a message
+      cout << "Power up! You can now fire more projectiles!" << endl;
+
+      // Handle the collision
+      if(other->HandleCollision()){
+        events.Post(pickup);
+      }
+    }
+  }
+}
+
+/***********************************************************
+  Walls stop the player. If a move took them into one, it
+  goes back, trying to keep the sideways or up and down
+  part of it so they slide along the wall.
+***********************************************************/
+void SFApp::KeepOutOfWalls(const Point2 & before) {
+  if(!options.walls || !tiles.IsSolid(player->GetBounds())) {
+    return;
+  }
+
+  Point2 now = player->GetPosition();
+  Point2 tries[3] = { Point2(now.getX(), before.getY()), Point2(before.getX(), now.getY()), before };
+  for(auto & at : tries) {
+    player->SetPosition(at);
+    if(!tiles.IsSolid(player->GetBounds())) {
+      return;
+    }
+  }
+}
+
+/***********************************************************
+  The walls scrolled down into the player, so they get
+  pushed down too. If the bottom of the screen or another
+  wall is in the way they're crushed, and lose 1 HP each
+  tick until they get out.
+***********************************************************/
+void SFApp::PushOutOfWalls() {
+  if(!tiles.IsSolid(player->GetBounds())) {
+    crushed = false;
+    return;
+  }
+
+  Point2 at = player->GetPosition();
+  Point2 down(at.getX(), at.getY() - 1.0f);
+  player->SetPosition(down);
+  if(player->GetBounds().lo_y >= 0.0f && !tiles.IsSolid(player->GetBounds())) {
+    crushed = false;
+    return;
+  }
+  player->SetPosition(at);
+
+  if(!crushed) {
+    cout << "Crushed against a wall! Losing 1 HP a tick until you get out. (PlayerHP: " << player->GetHealth() << ")" << endl;
+  }
+  crushed = true;
+  HurtPlayer(1);
+}
+
+// Each shot still going is one tile lookup, however many walls there are
+void SFApp::ShootWalls(vector<shared_ptr<SFAsset>> & shots) {
+  if(!options.walls) {
+    return;
+  }
+  for(auto & p : shots) {
+    if(p->IsAlive() && tiles.IsSolid(p->GetPosition().getX(), p->GetPosition().getY())) {
+      p->HandleCollision();
+      effects.Emit(SFEFFECT_FLASH, p->GetPosition());
+    }
+  }
+}
+
+/***********************************************************
+  A player projectile hit an enemy.
+***********************************************************/
+void SFApp::ProjectileHit(SFAsset * p, SFAsset * a) {
+  // Get the alien position
+  auto aPos = a->GetPosition();
+
+  // Handle the collisions for both projectile and enemy
+  p->HandleCollision();
+
+  // Set the score back up as the projectile hit
+  AddScore(1);
+
+  // If HandleCollision returns a special value (1) to show enemy run out of HP
+  if(a->HandleCollision() == 1){
+    SFKillEvent kill = { a->GetId(), aPos, SFFACTION_PPROJECTILE };
+    events.Post(kill);
+  }
+}
+
+/***********************************************************
+  Changes the score and lets everything that depends on
+  it know.
+***********************************************************/
+void SFApp::AddScore(int change) {
+  player->SetScore(player->GetScore() + change);
+  SFScoreEvent e = { player->GetScore(), change };
+  events.Post(e);
+}
+
+/***********************************************************
+  The player crashed into something or was hit. Only
+  the HUD cares here, everything else has its own event.
+***********************************************************/
+void SFApp::OnCollisions(const vector<SFCollisionEvent> & hits) {
+  for(auto & hit : hits) {
+    if(hit.factionA == SFFACTION_PLAYER) {
+      hudDirty = true;
+      return;
+    }
+  }
+}
+
+/***********************************************************
+  Aliens the player shot are worth 10 points and might
+  drop a coin or a powerup where they were.
+***********************************************************/
+void SFApp::OnKills(const vector<SFKillEvent> & kills) {
+  for(auto & kill : kills) {
+    if(kill.killer != SFFACTION_PPROJECTILE) {
+      continue;
+    }
+
+    // Add 10 points to score
+    AddScore(10);
+
+    // Decide if a collectible should be dropped
+    int check = (rand() % 600 + 32);
+    if(check >= 0 && check <= 200){
+      // Output some message
+      cout << "Coin dropped!" << endl;
+
+      // Drop some loot
+      auto coin = coinPool.Spawn();
+      auto pos  = Point2(kill.where);
+      coin->SetPosition(pos);
+      coins.push_back(coin);
+    }
+    else if(check >= 200 && check <= 300) {
+      cout << "Powerup dropped!" << endl;
+
+      // Drop some loot
+      auto power = powerPool.Spawn();
+      auto pos  = Point2(kill.where);
+      power->SetPosition(pos);
+      powers.push_back(power);
+    }
+  }
+}
+
+/***********************************************************
+  A powerup doubles the player's shots for a while (and
+  picking up another one starts the time again), a coin
+  lets them have one more shot on screen.
+***********************************************************/
+void SFApp::OnPickups(const vector<SFPickupEvent> & pickups) {
+  for(auto & pickup : pickups) {
+    if(pickup.powerup) {
+      firePower = 1;
+      timers.Cancel(powerTimer);
+      powerTimer = timers.Schedule(SF_POWER_TICKS, SFTIMER_POWER_EXPIRE);
+    }
+    else {
+      maxProjectiles += 1;
+    }
+  }
+}
+
+/***********************************************************
+  Moves the game to the stage for the player's score. Only
+  the latest score in the batch matters. The stress test
+  stays on the stage it started on.
+***********************************************************/
+void SFApp::OnScoreChanges(const vector<SFScoreEvent> & scores) {
+  if(options.stress) {
+    return;
+  }
+
+  int score = scores.back().score;
+  int stage = gameDifficulty;
+  if(score > 1200) {
+    stage = 5;
+  }
+  else if(score > 1000 && score < 1200) {
+    stage = 4;
+  }
+  else if(score > 850 && score < 1000) {
+    stage = 3;
+  }
+  else if(score > 600 && score < 850) {
+    stage = 2;
+  }
+  else if(score > 300 && score < 600) {
+    stage = 1;
+  }
+
+  if(stage != gameDifficulty) {
+    SFStageEvent e = { stage };
+    events.Post(e);
+  }
+}
+
+void SFApp::OnStageChanges(const vector<SFStageEvent> & stages) {
+  for(auto & e : stages) {
+    GameDifficultyModifier(e.stage);
+  }
+  hudDirty = true;
 }
 
 /***********************************************************
@@ -451,23 +931,40 @@ void SFApp::OnUpdateWorld() {
   and the game difficulty indicator (1 to 5)
 ***********************************************************/
 void SFApp::DrawHud(){
+  // The HUD only changes when the player is hit or the stage changes, so don't reload it every tick
+  if(!hudDirty) {
+    return;
+  }
+  hudDirty = false;
+  layers.MarkDirty(SFLAYER_HUD);
+
+  // The blocks go back to their pools, so getting hit doesn't allocate
+  for(auto b : healthBlocks) {
+    HudPool(b->GetType()).Release(b);
+  }
+  for(auto st : stage) {
+    hudGreenPool.Release(st);
+  }
+  healthBlocks.clear();
+  stage.clear();
+
   int totalBlocks = player->GetHealth() / 10;
 
   for(int i = 0; i < totalBlocks; i++) {
     if(player->GetHealth() >= 70) { 
-      auto hpBlock = make_shared<SFAsset>(SFASSET_HEALTHBLOCKG, sf_window);
+      auto hpBlock = hudGreenPool.Spawn();
       auto pos = Point2(20 + (16 * i), 450);
       hpBlock->SetPosition(pos);
       healthBlocks.push_back(hpBlock);
     }
     else if(player->GetHealth() >= 30) {
-      auto hpBlock = make_shared<SFAsset>(SFASSET_HEALTHBLOCKY, sf_window);
+      auto hpBlock = hudYellowPool.Spawn();
       auto pos = Point2(20 + (16 * i), 450);
       hpBlock->SetPosition(pos);
       healthBlocks.push_back(hpBlock);
     }
     else {
-      auto hpBlock = make_shared<SFAsset>(SFASSET_HEALTHBLOCKR, sf_window);
+      auto hpBlock = hudRedPool.Spawn();
       auto pos = Point2(20 + (16 * i), 450);
       hpBlock->SetPosition(pos);
       healthBlocks.push_back(hpBlock); 
@@ -476,13 +973,21 @@ void SFApp::DrawHud(){
 
   for(int i = 0; i < gameDifficulty; i++){
     // Since the indicator will use the same sprite, it won't matter to use HEALTHBLOCKG
-    auto stageIndicator = make_shared<SFAsset>(SFASSET_HEALTHBLOCKG, sf_window);
+    auto stageIndicator = hudGreenPool.Spawn();
     auto pos = Point2(20 + (16 * i), 60);
     stageIndicator->SetPosition(pos);
     stage.push_back(stageIndicator);
   }
 }
 
+// The pool for a colour of HUD block
+SFAssetPool & SFApp::HudPool(SFASSETTYPE type) {
+  if(type == SFASSET_HEALTHBLOCKR) {
+    return hudRedPool;
+  }
+  return type == SFASSET_HEALTHBLOCKY ? hudYellowPool : hudGreenPool;
+}
+
 /***********************************************************
   This function renders all of our objects such as:
     Player.
@@ -501,11 +1006,22 @@ void SFApp::DrawHud(){
   p->OnRender();
 ***********************************************************/
 void SFApp::OnRender() {
-  SDL_RenderClear(sf_window->getRenderer());
+  SFProfiler::BeginPhase(SFPHASE_RENDER);
+
+  sf_window->getRenderer()->Clear();
 
   // Render backgrounds
-  for(auto s: stars) {
-    s->OnRender();
+  if(layers.Begin(SFLAYER_BACKGROUND)) {
+    background.OnRender();
+    layers.End(SFLAYER_BACKGROUND);
+  }
+
+  // Everything in the world moves every frame, so it's drawn every frame
+  layers.Begin(SFLAYER_WORLD);
+
+  // The walls go over the stars, under everything else
+  if(options.walls) {
+    tileLayer.OnRender();
   }
 
   // Draw the player (SFAsset::OnRender();)!
@@ -541,21 +1057,104 @@ void SFApp::OnRender() {
     c->OnRender();
   }
 
-  // Render healthbar
-  for(auto hp: healthBlocks) {
-    hp->OnRender();
-  }
-  for(auto bar: healthBar) {
-    bar->OnRender();
+  // Particles go over everything in the world, under the HUD
+  effects.OnRender();
+  layers.End(SFLAYER_WORLD);
+
+  if(layers.Begin(SFLAYER_HUD)) {
+    // Render healthbar
+    for(auto hp: healthBlocks) {
+      hp->OnRender();
+    }
+    for(auto bar: healthBar) {
+      bar->OnRender();
+    }
+
+    // Just to show what stage we're on
+    for(auto st: stage) {
+      st->OnRender();
+    }
+    layers.End(SFLAYER_HUD);
   }
 
-  // Just to show what stage we're on
-  for(auto st: stage) {
-    st->OnRender();
+  // Performance overlay goes on top of everything else
+  overlay->OnRender(GetEntityCounts());
+
+  // Switch the off-screen buffer to be on-screen, which is where the keys used this frame show up
+  uint64_t before = SDL_GetPerformanceCounter();
+  latency.Presenting(before);
+  sf_window->getRenderer()->Present();
+  uint64_t after = SDL_GetPerformanceCounter();
+  latency.Presented(present, after);
+  presentMs = (after - before) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+/***********************************************************
+  Counts up what is currently in the world.
+***********************************************************/
+SFEntityCounts SFApp::GetEntityCounts() {
+  SFEntityCounts counts;
+  counts.aliens       = aliens.size();
+  counts.pProjectiles = pProjectiles.size();
+  counts.eProjectiles = eProjectiles.size();
+  counts.coins        = coins.size();
+  counts.powers       = powers.size();
+  counts.particles    = effects.GetCount();
+  return counts;
+}
+
+/***********************************************************
+  Hands the frame that just finished to the flight
+  recorder. Timers and pairs are left over from the last
+  update when the game is paused, so they count as none.
+***********************************************************/
+void SFApp::RecordFrame() {
+  SFFrameRecord r;
+  r.frame      = SFProfiler::GetFrame();
+  r.intervalMs = SFProfiler::GetFrameIntervalMs();
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    r.phaseMs[p] = SFProfiler::GetPhaseMs((SFPHASE) p);
   }
+  r.allocs     = SFProfiler::GetAllocs();
+  r.drawCalls  = SFProfiler::GetDrawCalls();
+  r.entities   = GetEntityCounts();
+  r.events     = events.GetPosted() - postedBefore;
+  r.timers     = is_paused ? 0 : fired.size();
+  r.pairs      = is_paused ? 0 : pairs.size();
+  postedBefore = events.GetPosted();
+  recorder.Record(r);
+}
 
-  // Switch the off-screen buffer to be on-screen
-  SDL_RenderPresent(sf_window->getRenderer());
+/***********************************************************
+  How full each pool is and how often it had to grow.
+***********************************************************/
+void SFApp::PrintPools(ostream & os) {
+  os << "Pools:" << endl;
+  os << "  player projectiles " << pProjectilePool << endl;
+  os << "  enemy projectiles  " << eProjectilePool << endl;
+  os << "  aliens             " << alienPool << endl;
+  os << "  coins              " << coinPool << endl;
+  os << "  powerups           " << powerPool << endl;
+  os << "Asset IDs in use: " << SFAsset::GetLiveIds() << endl;
+}
+
+/***********************************************************
+  The player pressed fire. Only fire if there aren't already
+  too many projectiles on screen.
+***********************************************************/
+void SFApp::PlayerFire() {
+  // Check if we can fire (maxProjectiles limits the total on screen allowed)
+  if(fire < maxProjectiles){
+    // Count how many projectiles were fired in the entire session.
+    totalProjectiles++;
+
+    // Add to the fire limit counter.
+    fire++;
+
+    // Fire a projectile.
+    FireProjectile(player->GetPosition(), true);
+    effects.Emit(SFEFFECT_FLASH, player->GetPosition());
+  }
 }
 
 /***********************************************************
@@ -566,8 +1165,8 @@ void SFApp::FireProjectile(Point2 position, bool isPlayer) {
 
     if(firePower == 1){
       // Make the projectiles
-      auto p1 = make_shared<SFAsset>(SFASSET_PROJECTILE, sf_window);
-      auto p2 = make_shared<SFAsset>(SFASSET_PROJECTILE, sf_window);
+      auto p1 = pProjectilePool.Spawn();
+      auto p2 = pProjectilePool.Spawn();
 
       int baseX = position.getX()-12;
       int baseY = position.getY();
@@ -578,25 +1177,29 @@ void SFApp::FireProjectile(Point2 position, bool isPlayer) {
       // Set the projectile to the position
       p1->SetPosition(pos1);
       p2->SetPosition(pos2);
+      p1->SetLifetime(SF_PPROJECTILE_LIFETIME);
+      p2->SetLifetime(SF_PPROJECTILE_LIFETIME);
       pProjectiles.push_back(p1);
       pProjectiles.push_back(p2);
     }
     else{
       // Make the projectiles
-      auto pb = make_shared<SFAsset>(SFASSET_PROJECTILE, sf_window);
+      auto pb = pProjectilePool.Spawn();
 
       // Set the projectile to the position
       pb->SetPosition(position);
+      pb->SetLifetime(SF_PPROJECTILE_LIFETIME);
       pProjectiles.push_back(pb);
     }
-    player->SetScore(player->GetScore() - 1);
+    AddScore(-1);
   }
   else{
-      // Make the projectiles
-      auto pb = make_shared<SFAsset>(SFASSET_PROJECTILE, sf_window);
+    // Make the projectiles
+    auto pb = eProjectilePool.Spawn();
 
-      // Set the projectile to the position
-      pb->SetPosition(position);
+    // Set the projectile to the position
+    pb->SetPosition(position);
+    pb->SetLifetime(SF_EPROJECTILE_LIFETIME);
     eProjectiles.push_back(pb);
   }
 }
@@ -636,8 +1239,35 @@ void SFApp::EndGame(){
     cout << endl << "Time Played: " << min << " minute(s) | " << sec << " second(s)" << endl;
   }
   // This will show the player what they did during their session.
-  cout << "Enemies Killed: " << enemiesKilled << " | Coins Collected: " << coinsCollected <<  " | Projectiles Fired: " << totalProjectiles << endl << endl;
+  cout << stats << " | Projectiles Fired: " << totalProjectiles << endl << endl;
   cout << endl << "Total Score: " << player->GetScore() << endl;
+
+  // Report how much scratch memory a frame needed (useful for sizing the arena)
+  cout << "Frame arena peak: " << frameArena.GetPeak() << " of " << frameArena.GetCapacity() << " bytes";
+  cout << " (" << frameArena.GetOverflows() << " overflow(s) to the heap)" << endl;
+  PrintPools(cout);
+
+  // How long key presses waited for the frame that used them
+  cout << "Input: " << tracker.GetEvents() << " key event(s) | " << tracker.GetMeanWaitMs() << " ms mean wait | "
+       << tracker.GetWorstWaitMs() << " ms worst | " << keys.GetDropped() << " dropped" << endl;
+  cout << "Input latency, key read to frame presented (fps cap " << options.fpsCap << "):" << endl;
+  latency.Print(cout);
+  cout << "Governor: " << governor << endl;
+
+  // Any frames that hitched are saved by now (see SFFlightRecorder.h)
+  recorder.Flush();
+  cout << "Hitches over " << options.hitchMs << " ms: " << recorder.GetHitches() << " | " << recorder.GetDumps()
+       << " trace(s) saved | " << recorder.GetDropped() << " dropped" << endl;
+
+  // Keep what was played so it can be played again (see SFSession.h)
+  if(!options.record.empty() && session.Save(options.record)) {
+    cout << "Session of " << session.GetFrames() << " frames saved to " << options.record << endl;
+  }
+
+  // Memory and entity high-water marks, and the heap allocation report
+  // (only when built with -DSF_ALLOC_TRACKING)
+  SFProfiler::PrintHighWater(cout);
+  SFProfiler::PrintSummary(cout);
 }
 
 void SFApp::PauseGame(){
@@ -653,34 +1283,162 @@ void SFApp::PauseGame(){
 
 void SFApp::GameDifficultyModifier(int diff) {
   cout << "Changing game stage... Stage " << diff << " of 5." << endl;
-  if(gameDifficulty < diff) {
-    int number_of_aliens;
-    if(diff == 1){
-      number_of_aliens = 2;
-    }
-    else if(diff == 2){
-      number_of_aliens = 3;
-    }
-    else if(diff == 3){
-      number_of_aliens = 5;
-    }
-    else if(diff == 4){
-      number_of_aliens = 9;
-    }
+  // A stage's wave only comes the first time it's reached, not again after the score dips below it and back
+  if(diff > highestStage) {
+    waves.Start(StageWave(diff));
+    highestStage = diff;
+  }
+  gameDifficulty = diff;
+}
+
+
+/***********************************************************
+  Sets up the world for the stress test. Everything is
+  spawned in the same bands as the normal game, just a lot
+  more of it.
+***********************************************************/
+void SFApp::SpawnStress() {
+  int canvas_w, canvas_h;
+  sf_window->getRenderer()->GetOutputSize(canvas_w, canvas_h);
+
+  maxProjectiles = options.stressProjectiles;
+
+  // Make the pools big enough up front, the stress test is about the game not the pools
+  alienPool.Reserve(options.stressAliens);
+  coinPool.Reserve(options.stressPickups);
+  powerPool.Reserve(options.stressPickups);
+  pProjectilePool.Reserve(options.stressProjectiles);
+
+  for(int i = 0; i < options.stressAliens; i++) {
+    SpawnAlien();
+  }
+
+  // Half the pickups are coins, half are power ups
+  for(int i = 0; i < options.stressPickups; i++) {
+    auto pickup = (i % 2 ? powerPool : coinPool).Spawn();
+    auto pos  = Point2(rand() % 600 + 32, rand() % 400 + 600);
+    pickup->SetPosition(pos);
+    (i % 2 ? powers : coins).push_back(pickup);
+  }
+
+  // Emitters are spread evenly along the top of the screen
+  // (staggered so they don't all fire at once)
+  for(int i = 0; i < options.stressEmitters; i++) {
+    emitters.push_back(Point2((i + 0.5f) * canvas_w / options.stressEmitters, canvas_h - 16.0f));
+    timers.Repeat(SF_EMITTER_PERIOD, SF_EMITTER_PERIOD - i % SF_EMITTER_PERIOD, SFTIMER_EMITTER_FIRE, SF_NULL_HANDLE, i);
+  }
+}
+
+/***********************************************************
+  Plays the game for the stress test: sweep left and right,
+  bob up and down and fire every third tick.
+***********************************************************/
+void SFApp::StressInput() {
+  player->MoveHorizontal((currTick / 120) % 2 ? -5.0f : 5.0f);
+  player->MoveVertical((currTick / 60) % 2 ? -2.0f : 4.0f);
+
+  if(currTick % 3 == 0) {
+    PlayerFire();
+  }
+}
+
+// Nearest-rank percentile of an already sorted list
+static double Percentile(const vector<double> & sorted, double p) {
+  if(sorted.empty()) {
+    return 0.0;
+  }
+  size_t rank = (size_t) (p / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[rank];
+}
 
-    for(int i = 0; i < number_of_aliens; i++) {
-      // place an alien at width/number_of_aliens * i
-      auto alien = make_shared<SFAsset>(SFASSET_ALIEN, sf_window);
-      auto pos  = Point2(rand() % 600 + 32, rand() % 400 + 600);
+/***********************************************************
+  Runs the stress test: a fixed number of ticks with no
+  waiting in between, then a report of how long the frames
+  took and how much memory was used.
+***********************************************************/
+int SFApp::RunStress() {
+  cout << "Stress test: " << options << endl;
+
+  // Time the full scene unless asked to time it under a budget
+  if(!options.frameBudgetSet) {
+    governor = SFGovernor(0);
+  }
 
-      // Make enemy at position and set it's health
-      alien->SetPosition(pos);
-      alien->SetHealth(15);
-      alien->SetFired(0);
+  long startRss = SFProfiler::GetResidentBytes(), peakRss = startRss;
+  vector<double> frameMs;
+  frameMs.reserve(options.stressTicks);
 
-      aliens.push_back(alien);
+  // The game's messages would swamp the report (and the timings), so mute them for the run
+  cout.setstate(ios::failbit);
+  for(int i = 0; i < options.stressTicks; i++) {
+    StepFrame();
 
-      cout << "Created enemy with " << alien->GetHealth() << endl;
+    frameMs.push_back(SFProfiler::GetUpdateMs() + SFProfiler::GetPhaseMs(SFPHASE_RENDER));
+    if(i % 10 == 0) {
+      peakRss = max(peakRss, SFProfiler::GetResidentBytes());
     }
   }
+  cout.clear();
+
+  double total = 0.0;
+  for(auto ms : frameMs) {
+    total += ms;
+  }
+  sort(frameMs.begin(), frameMs.end());
+
+  SFEntityCounts counts = GetEntityCounts();
+  cout << "Frame time (ms) over " << frameMs.size() << " ticks:" << endl;
+  cout << "  mean " << (frameMs.empty() ? 0.0 : total / frameMs.size())
+       << " | p50 " << Percentile(frameMs, 50.0)
+       << " | p90 " << Percentile(frameMs, 90.0)
+       << " | p99 " << Percentile(frameMs, 99.0)
+       << " | p99.9 " << Percentile(frameMs, 99.9)
+       << " | max " << (frameMs.empty() ? 0.0 : frameMs.back()) << endl;
+  cout << "Entities at end: aliens " << counts.aliens << " | player projectiles " << counts.pProjectiles
+       << " | enemy projectiles " << counts.eProjectiles << " | coins " << counts.coins << " | powerups " << counts.powers << endl;
+  cout << "Particles: " << counts.particles << " alive of " << options.particles << " | " << effects.GetDropped() << " dropped" << endl;
+  cout << "Broadphase: " << broadphase->GetName() << " (" << broadphase->GetProxyCount() << " proxies, "
+       << pairs.size() << " pairs on the last tick)" << endl;
+  cout << "Waves: " << waves.GetSpawned() << " spawned | " << waves.GetDeferred() << " frame(s) out of budget | worst "
+       << waves.GetWorstMs() << " ms in a frame" << endl;
+  cout << "Walls: " << tiles.GetStreamed() << " chunk(s) streamed in | " << tiles.GetEvicted() << " evicted | "
+       << tileLayer.GetBakes() << " baked" << endl;
+  cout << "Pixel collisions: " << (options.pixelCollisions ? "on" : "off") << " | " << SFAsset::GetBoxHits() << " box hit(s) checked | "
+       << SFAsset::GetBoxHits() - SFAsset::GetPixelHits() << " missed every solid pixel" << endl;
+  cout << "Governor: " << governor << endl;
+  cout << "Layer cache:";
+  for(int l = 0; l < SFLAYER_LAST; l++) {
+    SFLAYER layer = (SFLAYER) l;
+    long hits = layers.GetHits(layer), frames = hits + layers.GetDraws(layer);
+    cout << (l ? " | " : " ") << SFLayerCache::GetName(layer);
+    if(layers.IsCached(layer)) {
+      cout << " " << (frames ? 100 * hits / frames : 0) << "% hits (" << hits << " of " << frames << ")";
+    }
+    else {
+      cout << " not cached";
+    }
+  }
+  cout << endl;
+  cout << "Timers: " << timers.GetPending() << " pending | " << timers.GetFired() << " fired | "
+       << timers.GetCascaded() << " cascaded" << endl;
+  recorder.Flush();
+  cout << "Hitches over " << options.hitchMs << " ms: " << recorder.GetHitches() << " | " << recorder.GetDumps()
+       << " trace(s) saved | " << recorder.GetDropped() << " dropped" << endl;
+  cout << "Draw calls (last frame): " << SFProfiler::GetDrawCalls() << " | Textures: " << SFProfiler::GetLiveTextures() << endl;
+  cout << "Renderer: " << sf_window->getRenderer()->GetName();
+  SFSoftwareRenderer * software = dynamic_cast<SFSoftwareRenderer *>(sf_window->getRenderer());
+  if(software) {
+    // The same run draws the same last frame, so this can be checked against an earlier one
+    cout << " (last frame checksum " << hex << software->GetFrame().Checksum() << dec << ")";
+  }
+  cout << endl;
+  cout << "Resident memory (KiB): start " << startRss / 1024 << " | end " << SFProfiler::GetResidentBytes() / 1024
+       << " | peak " << peakRss / 1024 << endl;
+  cout << "Frame arena peak: " << frameArena.GetPeak() << " of " << frameArena.GetCapacity() << " bytes";
+  cout << " (" << frameArena.GetOverflows() << " overflow(s) to the heap)" << endl;
+  PrintPools(cout);
+  SFProfiler::PrintHighWater(cout);
+  SFProfiler::PrintSummary(cout);
+
+  return 0;
 }
@@ -16,6 +16,9 @@
 #include <iostream> // Pull in std::cerr, std::endl (for output)
 #include <list>     // Pull in list (for array)
 #include <sstream>  // pull in sstream (for strings) (String Stream?)
+#include <vector>   // Pull in vector (for stress test timings)
+#include <algorithm> // Pull in sort (for stress test percentiles)
+#include <cmath>    // Pull in log (for enemy fire timing)
 
 // So we don't have to keep doing std::string etc
 using namespace std;
@@ -24,27 +27,103 @@ using namespace std;
 #include "SFCommon.h"
 #include "SFEvent.h"
 #include "SFAsset.h"
+#include "SFArena.h"
+#include "SFProfiler.h"
+#include "SFOverlay.h"
+#include "SFOptions.h"
+#include "SFBroadphase.h"
+#include "SFAssetPool.h"
+#include "SFTimerWheel.h"
+#include "SFEventBus.h"
+#include "SFGameStats.h"
+#include "SFWave.h"
+#include "SFFlightRecorder.h"
+#include "SFInput.h"
+#include "SFInputQueue.h"
+#include "SFLatency.h"
+#include "SFGovernor.h"
+#include "SFSession.h"
+#include "SFEffects.h"
+#include "SFTileMap.h"
+#include "SFTileLayer.h"
+#include "SFLayerCache.h"
+#include "SFBackground.h"
+
+// How many ticks a projectile can live for, even if it never leaves the screen
+const int SF_PPROJECTILE_LIFETIME = 120;
+const int SF_EPROJECTILE_LIFETIME = 240;
+
+// Timings, in ticks
+const int    SF_TICKS_PER_SECOND  = 60;    // How often the update timer goes off
+const int    SF_POWER_TICKS       = 300;   // How long a powerup lasts
+const int    SF_EMITTER_PERIOD    = 30;    // Between shots from a stress test emitter
+const double SF_ALIEN_FIRE_CHANCE = 1.0 / 200.0; // That an alien fires on a given tick, in the stress test
 
 /**
  * Represents the StarshipFontana application. It has responsibilities for
  * * Creating and destroying the app window
  * * Processing game events
+ *
+ * It also listens to its own gameplay events (see SFEventBus.h) to keep
+ * the score, stage, loot and HUD up to date, and spawns the aliens of
+ * its waves (see SFWave.h).
  */
-class SFApp {
+class SFApp : public SFGameListener, public SFWaveHost {
 public:
-  SFApp(std::shared_ptr<SFWindow>);
+  SFApp(std::shared_ptr<SFWindow>, const SFOptions & = SFOptions());
   virtual ~SFApp();
 
   // Define any new methods for SFApp.cpp to use below.
   void    OnEvent(SFEvent &);
   int     OnExecute();
+  void    StepFrame();
+  void    SetInput(const SFInputState &);
+  bool    IsRunning();
   void    OnUpdateWorld();
   void    OnRender();
+  bool    DrawDue();
+  void    ToggleVSync();
+  void    SetQuality(SFQUALITY);
   void    FireProjectile(Point2 position, bool isPlayer);
+  void    PlayerFire();
   void    EndGame();
   void    PauseGame();
   void    GameDifficultyModifier(int diff);
   void    DrawHud();
+  void    OnTimer(const SFTimerFired &);
+  void    SpawnAlien();
+  void    SpawnWaveAlien(const Point2 &);
+  int     GetAlienCount();
+  SFWave  StageWave(int stage);
+  SFAssetPool & HudPool(SFASSETTYPE);
+  SFEntityCounts GetEntityCounts();
+  void    RecordFrame();
+  void    PrintPools(ostream &);
+
+  // Collisions (see SFBroadphase.h)
+  void    UpdateProxy(SFAsset *, SFFACTION);
+  void    RemoveProxy(SFAsset *);
+  void    PlayerHit(SFAsset *, SFFACTION);
+  void    HurtPlayer(int damage);
+  void    ProjectileHit(SFAsset *, SFAsset *);
+
+  // The walls of the tile map (see SFTileMap.h)
+  void    KeepOutOfWalls(const Point2 & before);
+  void    PushOutOfWalls();
+  void    ShootWalls(vector<shared_ptr<SFAsset>> &);
+
+  // Gameplay events (see SFEventBus.h)
+  void    AddScore(int change);
+  void    OnCollisions(const vector<SFCollisionEvent> &);
+  void    OnKills(const vector<SFKillEvent> &);
+  void    OnPickups(const vector<SFPickupEvent> &);
+  void    OnScoreChanges(const vector<SFScoreEvent> &);
+  void    OnStageChanges(const vector<SFStageEvent> &);
+
+  // Stress test mode (see SFOptions.h)
+  void    SpawnStress();
+  void    StressInput();
+  int     RunStress();
 
 private:
   // Define any variables to use in SFApp.cpp below.
@@ -52,6 +131,9 @@ private:
   bool                    is_running;
   bool                    is_paused = false;
 
+  // Command line settings
+  SFOptions                   options;
+
   // Window pointer
   shared_ptr<SFWindow>        sf_window;
 
@@ -59,37 +141,105 @@ private:
   shared_ptr<SFAsset>         player;
   shared_ptr<SFBoundingBox>   app_box;
 
-  // The object lists for our game instances
-  list<shared_ptr<SFAsset>> pProjectiles;
-  list<shared_ptr<SFAsset>> eProjectiles;
+  // Pools the short lived instances come from (see SFAssetPool.h)
+  SFAssetPool               pProjectilePool;
+  SFAssetPool               eProjectilePool;
+  SFAssetPool               alienPool;
+  SFAssetPool               coinPool;
+  SFAssetPool               powerPool;
+  SFAssetPool               hudGreenPool;
+  SFAssetPool               hudYellowPool;
+  SFAssetPool               hudRedPool;
+
+  // The object lists for our game instances. The pooled ones are vectors
+  // so that once they've grown adding to them doesn't allocate either.
+  vector<shared_ptr<SFAsset>> pProjectiles;
+  vector<shared_ptr<SFAsset>> eProjectiles;
+
+  vector<shared_ptr<SFAsset>> aliens;
+  vector<shared_ptr<SFAsset>> coins;
+  vector<shared_ptr<SFAsset>> powers;
 
-  list<shared_ptr<SFAsset>> aliens;
-  list<shared_ptr<SFAsset>> coins;
-  list<shared_ptr<SFAsset>> powers;
-  list<shared_ptr<SFAsset>> stars;
+  // The stars scrolling past behind everything
+  SFBackground                background;
 
-  list<shared_ptr<SFAsset>> stage;
+  vector<shared_ptr<SFAsset>> stage;
 
-  list<shared_ptr<SFAsset>> healthBlocks;
+  vector<shared_ptr<SFAsset>> healthBlocks;
   list<shared_ptr<SFAsset>> healthBar;
 
+  // Stress test projectile emitters
+  vector<Point2>            emitters;
+
+  // The HUD needs building again, so it's only rebuilt when it changes
+  bool hudDirty = true;
+
+  // Performance overlay, toggled with F1
+  shared_ptr<SFOverlay>       overlay;
+
+  // Finds the pairs of things that might have collided, and the list it fills in
+  shared_ptr<SFBroadphase>    broadphase;
+  vector<SFProxyPair>         pairs;
+
+  // Everything that happens after a number of ticks, and the timers that went off this tick
+  SFTimerWheel                timers;
+  vector<SFTimerFired>        fired;
+
+  // Gameplay events waiting to be handled, and the statistics kept from them
+  SFEventBus                  events;
+  SFGameStats                 stats;
+
+  // Explosions, sparkles and muzzle flashes
+  SFEffects                   effects;
+
+  // The walls scrolling down the screen, and what draws them
+  SFTileMap                   tiles;
+  SFTileLayer                 tileLayer;
+  bool                        crushed = false;    // The player is stuck between a wall and the bottom of the screen
+
+  // The layers of the frame, with the HUD kept in a texture while it doesn't change
+  SFLayerCache                layers;
+
+  // Waves of aliens still arriving
+  SFWaveRunner                waves;
+
+  // What the player is doing this frame, and every frame so far when recording (see SFSession.h)
+  SFInputState                input;
+  SFSession                   session;
+
+  // Key presses and releases as SDL read them, waiting for the next tick (see SFInputQueue.h)
+  SFInputQueue                keys;
+  SFInputTracker              tracker;
+
+  // How long those keys take to reach the screen, and how the screen is being presented
+  SFLatencyTracer             latency;
+  SFPRESENT                   present;
+  int                         drawCredit = 0;     // Towards the next frame drawn, under --fps-cap
+  double                      presentMs = 0.0;    // How long the last Present took (waiting for vsync, mostly)
+
+  // Cuts optional work when frames go over budget (see SFGovernor.h)
+  SFGovernor                  governor;
+
+  // Keeps the last few seconds of frames and saves them when one hitches
+  SFFlightRecorder            recorder;
+  long                        postedBefore = 0;   // Events posted up to the last recorded frame
+
+  // Scratch memory for anything that only lives during one OnUpdateWorld
+  SFArena frameArena;
 
   // For projectile handling
   int fire;                   // Total fired
   int maxProjectiles = 5;     // Max allowed
   int totalProjectiles = 0;   // Total in session
   int firePower = 0;          // Firepower of player
-  int firePowerTime = 0;    // Time that the powerup lasts in MS
+  SFTimerId powerTimer = SF_NULL_HANDLE; // When the powerup runs out
 
   // For calculating time
   int currTick = 0;
 
   // For game difficulty
   int gameDifficulty = 0;
-
-  // For counting enemies and coins collected
-  int enemiesKilled = 0;
-  int coinsCollected = 0;
+  int highestStage = 0;       // The hardest stage reached so far, whose wave has been sent
 
   SFError OnInit();
 };
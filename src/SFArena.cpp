@@ -0,0 +1,69 @@
+#include <new>
+
+#include "SFArena.h"
+
+SFArena::SFArena(size_t capacity) : capacity(capacity), offset(0), peak(0), overflows(0) {
+  buffer = static_cast<char *>(::operator new(capacity));
+}
+
+SFArena::~SFArena() {
+  ::operator delete(buffer);
+}
+
+/*********************************************************
+  Bumps the offset along by the (aligned) size asked for.
+  When the frame has used up the buffer, the request goes
+  to the heap instead and is counted as an overflow.
+*********************************************************/
+void * SFArena::Allocate(size_t bytes, size_t align) {
+  size_t start = (offset + align - 1) & ~(align - 1);
+
+  if(start + bytes > capacity) {
+    overflows++;
+    return ::operator new(bytes);
+  }
+
+  offset = start + bytes;
+  if(offset > peak) {
+    peak = offset;
+  }
+  return buffer + start;
+}
+
+/*********************************************************
+  Arena memory is only given back by Reset(), so this only
+  has to free anything that overflowed onto the heap.
+*********************************************************/
+void SFArena::Deallocate(void * p) {
+  if(!Owns(p)) {
+    ::operator delete(p);
+  }
+}
+
+/*********************************************************
+  Throws away everything allocated this frame.
+*********************************************************/
+void SFArena::Reset() {
+  offset = 0;
+}
+
+bool SFArena::Owns(const void * p) const {
+  const char * c = static_cast<const char *>(p);
+  return c >= buffer && c < buffer + capacity;
+}
+
+size_t SFArena::GetCapacity() const {
+  return capacity;
+}
+
+size_t SFArena::GetUsed() const {
+  return offset;
+}
+
+size_t SFArena::GetPeak() const {
+  return peak;
+}
+
+int SFArena::GetOverflows() const {
+  return overflows;
+}
@@ -0,0 +1,80 @@
+#ifndef SFARENA_H
+#define SFARENA_H
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A bump allocator for data that only lives for one frame. Allocating
+ * just moves an offset along a fixed buffer and Reset() throws the whole
+ * frame away at once, so there is no per-object free.
+ *
+ * If the buffer runs out we fall back to the normal heap and count it as
+ * an overflow so it shows up in the statistics instead of crashing.
+ */
+class SFArena {
+public:
+  SFArena(size_t capacity);
+  virtual ~SFArena();
+
+  void *  Allocate(size_t bytes, size_t align);
+  void    Deallocate(void * p);
+  void    Reset();
+  bool    Owns(const void * p) const;
+
+  size_t  GetCapacity() const;
+  size_t  GetUsed() const;
+  size_t  GetPeak() const;
+  int     GetOverflows() const;
+
+private:
+  SFArena(const SFArena &);
+  SFArena & operator=(const SFArena &);
+
+  char  * buffer;
+  size_t  capacity;
+  size_t  offset;
+  size_t  peak;
+  int     overflows;
+};
+
+/**
+ * Standard allocator that hands out memory from an SFArena so that
+ * containers can be used as per-frame scratch space.
+ */
+template <class T>
+class SFArenaAllocator {
+public:
+  typedef T value_type;
+
+  SFArenaAllocator(SFArena & arena) : arena(&arena) {}
+  template <class U> SFArenaAllocator(const SFArenaAllocator<U> & other) : arena(other.arena) {}
+
+  T * allocate(size_t n) {
+    return static_cast<T *>(arena->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T * p, size_t) {
+    arena->Deallocate(p);
+  }
+
+  SFArena * arena;
+};
+
+template <class T, class U>
+inline bool operator==(const SFArenaAllocator<T> & a, const SFArenaAllocator<U> & b) {
+  return a.arena == b.arena;
+}
+
+template <class T, class U>
+inline bool operator!=(const SFArenaAllocator<T> & a, const SFArenaAllocator<U> & b) {
+  return a.arena != b.arena;
+}
+
+// Scratch list for the current frame, e.g. SFFrameVector<int> v(arena);
+template <class T>
+using SFFrameVector = vector<T, SFArenaAllocator<T>>;
+
+#endif
@@ -16,10 +16,25 @@
   was called from.
 *********************************************************/
 
+#include <algorithm>
+#include <cmath>
+
 #include "SFAsset.h"
 
-// Set ID numbers to each asset
-int SFAsset::SFASSETID=0;
+// Hands out each asset's ID and finds the asset again from it
+SFHandleTable SFAsset::handles;
+
+// Textures that have been loaded, by file name
+map<string, weak_ptr<SFTexture>> SFAsset::textures;
+
+// Masks of the images' solid pixels, by file name, and whether collisions use them
+map<string, weak_ptr<SFMask>> SFAsset::masks;
+bool SFAsset::pixelCollisions = true;
+long SFAsset::boxHits   = 0;
+long SFAsset::pixelHits = 0;
+
+// Counts simulation steps so assets know when their movement started
+int SFAsset::SFSTEP=0;
 
 /*********************************************************
   This is the main code for SFAsset.cpp
@@ -28,45 +43,50 @@ int SFAsset::SFASSETID=0;
   it a sprite based on the passed type and applying it to
   the window specified.
 *********************************************************/
-SFAsset::SFAsset(SFASSETTYPE type, std::shared_ptr<SFWindow> window): type(type), sf_window(window) {
+SFAsset::SFAsset(SFASSETTYPE type, std::shared_ptr<SFWindow> window): type(type), sf_window(window), lifetime(-1), stepStart(0.0f, 0.0f), stepNumber(-1), proxy(SF_NULL_PROXY) {
 
   // Set the asset ID.
-  this->id   = ++SFASSETID;
+  this->id   = handles.Create(this);
 
   // Setup what sprite this asset will use
+  const char * path = nullptr;
   switch (type) {
     case SFASSET_PLAYER:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/player.png");
+      path = "assets/player.png";
       break;
     case SFASSET_PROJECTILE:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/projectile.png");
+    case SFASSET_EPROJECTILE:
+      path = "assets/projectile.png";
       break;
     case SFASSET_ALIEN:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/alien.png");
+      path = "assets/alien.png";
       break;
     case SFASSET_COIN:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/coin.png");
-      break;
-    case SFASSET_STARS: 
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/stars.png");
+      path = "assets/coin.png";
       break;
     case SFASSET_HEALTHBAR:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/healthbar.png");
+      path = "assets/healthbar.png";
       break;
     case SFASSET_HEALTHBLOCKG:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/healthblockgreen.png");
+      path = "assets/healthblockgreen.png";
       break;
     case SFASSET_HEALTHBLOCKY:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/healthblockyellow.png");
+      path = "assets/healthblockyellow.png";
       break;
     case SFASSET_HEALTHBLOCKR:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/healthblockred.png");
+      path = "assets/healthblockred.png";
       break;
     case SFASSET_POWERUP:
-      sprite = IMG_LoadTexture(sf_window->getRenderer(), "assets/projectile.png");
+      path = "assets/projectile.png";
       break;
   }
 
+  // Assets using the same image all share one texture
+  if(path) {
+    sprite = LoadTexture(sf_window->getRenderer(), path);
+    mask   = LoadMask(path);
+  }
+
   // If the sprite was not set, then throw an error as it may not exist
   if(!sprite) {
     cerr << "Could not load asset of type " << type << endl;
@@ -74,26 +94,121 @@ SFAsset::SFAsset(SFASSETTYPE type, std::shared_ptr<SFWindow> window): type(type)
   }
 
   // Get texture width & height
-  int w, h;
-  SDL_QueryTexture(sprite, NULL, NULL, &w, &h);
+  int w = sprite->GetWidth(), h = sprite->GetHeight();
 
   // Initialise bounding box
   bbox = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(0.0f, 0.0f), w, h));
 }
 
-SFAsset::SFAsset(const SFAsset& a) {
+SFAsset::SFAsset(const SFAsset& a) : lifetime(a.lifetime), stepStart(a.stepStart), stepNumber(a.stepNumber), proxy(SF_NULL_PROXY) {
   sprite = a.sprite;
+  mask   = a.mask;
   sf_window = a.sf_window;
   bbox   = a.bbox;
   type   = a.type;
+  id     = handles.Create(this);
 }
 
 SFAsset::~SFAsset() {
+  handles.Destroy(id);
   bbox.reset();
-  if(sprite) {
-    SDL_DestroyTexture(sprite);
-    sprite = nullptr;
+  sprite.reset();
+  mask.reset();
+}
+
+/*********************************************************
+  Makes the asset as good as new so SFAssetPool can hand
+  it out again. The sprite and bounding box are kept, they
+  only depend on the type which a pool never changes.
+*********************************************************/
+void SFAsset::Reset(SFASSETTYPE type) {
+  this->type  = type;
+
+  // Anything still holding the old ID sees it as gone
+  handles.Destroy(id);
+  this->id    = handles.Create(this);
+  objHP       = 0;
+  playerScore = 0;
+  totFired    = 0;
+  lifetime    = -1;
+  stepNumber  = -1;
+  proxy       = SF_NULL_PROXY;
+}
+
+/*********************************************************
+  Gives up the asset's ID when it goes back to its pool,
+  so it can't be found any more until it's spawned again.
+*********************************************************/
+void SFAsset::Retire() {
+  handles.Destroy(id);
+  id = SF_NULL_HANDLE;
+}
+
+/*********************************************************
+  Finds a live asset by ID, or nullptr if it has died or
+  been retired since the ID was taken.
+*********************************************************/
+SFAsset * SFAsset::Find(SFAssetId id) {
+  return static_cast<SFAsset *>(handles.Get(id));
+}
+
+int SFAsset::GetLiveIds() {
+  return handles.GetLive();
+}
+
+/*********************************************************
+  Loads a texture, or hands back the one already loaded
+  from the same file if anything is still using it.
+
+  Loading a texture for every alien and projectile is slow
+  and uses a lot of video memory, so they're shared. The
+  texture is destroyed when the last asset using it goes.
+*********************************************************/
+shared_ptr<SFTexture> SFAsset::LoadTexture(SFRenderer * renderer, const string & path) {
+  shared_ptr<SFTexture> texture = textures[path].lock();
+  if(texture) {
+    return texture;
   }
+
+  texture = SFRenderer::Counted(renderer->LoadTexture(path));
+  if(!texture) {
+    return nullptr;
+  }
+  textures[path] = texture;
+  return texture;
+}
+
+/*********************************************************
+  Works out which pixels of an image are solid, or hands
+  back the mask already made from the same file. It's
+  read from the file rather than the texture, which may
+  only be in video memory. nullptr if it can't be read.
+*********************************************************/
+shared_ptr<SFMask> SFAsset::LoadMask(const string & path) {
+  shared_ptr<SFMask> mask = masks[path].lock();
+  if(mask) {
+    return mask;
+  }
+
+  SFImage image;
+  if(!SFRenderer::LoadImage(path, image)) {
+    return nullptr;
+  }
+  mask = make_shared<SFMask>(image);
+  masks[path] = mask;
+  return mask;
+}
+
+void SFAsset::SetPixelCollisions(bool on) {
+  pixelCollisions = on;
+}
+
+long SFAsset::GetBoxHits() {
+  return boxHits;
+}
+
+long SFAsset::GetPixelHits() {
+  return pixelHits;
 }
 
 /**
@@ -103,9 +218,9 @@ SFAsset::~SFAsset() {
  * need to convert between the two coordinate spaces.  We assume
  * that there is a 1-to-1 quantisation.
  */
-Vector2 GameSpaceToScreenSpace(SDL_Renderer* renderer, Vector2 &r) {
+Vector2 GameSpaceToScreenSpace(SFRenderer* renderer, Vector2 &r) {
   int w, h;
-  SDL_GetRendererOutputSize(renderer, &w, &h);
+  renderer->GetOutputSize(w, h);
 
   return Vector2 (r.getX(), (h - r.getY()));
 }
@@ -116,6 +231,10 @@ Vector2 GameSpaceToScreenSpace(SDL_Renderer* renderer, Vector2 &r) {
 void SFAsset::SetPosition(Point2 & point) {
   Vector2 v(point.getX(), point.getY());
   bbox->SetCentre(v);
+
+  // Placing an asset is a teleport, so it should not sweep from the old spot
+  stepStart  = v;
+  stepNumber = SFSTEP;
 }
 
 /*********************************************************
@@ -147,6 +266,14 @@ void SFAsset::SetHealth(int val) {
   objHP = val;
 }
 
+/*********************************************************
+  Limits how many ticks (moves) the asset lives for.
+  -1 means it lives until something else kills it.
+*********************************************************/
+void SFAsset::SetLifetime(int ticks) {
+  lifetime = ticks;
+}
+
 /*********************************************************
   Will get the projectiles fored
 *********************************************************/
@@ -180,8 +307,20 @@ void SFAsset::SetScore(int val) {
   Display the object on the render window
 *********************************************************/
 void SFAsset::OnRender() {
-  // 1. Get the SDL_Rect from SFBoundingBox
-  SDL_Rect rect;
+  // 1. Get the SFRect from SFBoundingBox
+  SFRect rect = GetScreenRect();
+
+  // 2. Blit the sprite onto the level
+  sf_window->getRenderer()->Copy(sprite.get(), NULL, rect);
+  SFProfiler::CountDrawCalls(1);
+}
+
+/*********************************************************
+  Where on the screen OnRender draws the object, in whole
+  pixels, so it only looks any different when this does
+*********************************************************/
+SFRect SFAsset::GetScreenRect() {
+  SFRect rect;
 
   Vector2 gs = (*(bbox->centre) + (*(bbox->extent_x) * -1)) + (*(bbox->extent_y) * -1);
   Vector2 ss = GameSpaceToScreenSpace(sf_window->getRenderer(), gs);
@@ -189,9 +328,7 @@ void SFAsset::OnRender() {
   rect.y = ss.getY();
   rect.w = bbox->extent_x->getX() * 2;
   rect.h = bbox->extent_y->getY() * 2;
-
-  // 2. Blit the sprite onto the level
-  SDL_RenderCopy(sf_window->getRenderer(), sprite, NULL, &rect);
+  return rect;
 }
 
 /********************************************************* 
@@ -216,7 +353,7 @@ void SFAsset::MoveHorizontal(float speed) {
   // For this to stop instances going off-screen
   // need to get height and width of screen
   int w, h;
-  SDL_GetRendererOutputSize(sf_window->getRenderer(), &w, &h);
+  sf_window->getRenderer()->GetOutputSize(w, h);
 
   // Handle movement for type player
   if(SFASSET_PLAYER == type) {
@@ -225,8 +362,8 @@ void SFAsset::MoveHorizontal(float speed) {
 
     // If not at the left of screen, allow it to move
     if(!(c.getX()+32.0f > w) && !(c.getX()-32.0f < 0)) {
-      bbox->centre.reset();
-      bbox->centre = make_shared<Vector2>(c);
+      MarkStepStart();
+      *(bbox->centre) = c;
     }
   }
 }
@@ -235,15 +372,23 @@ void SFAsset::MoveVertical(float speed) {
   // For this to stop instances going off-screen
   // need to get height and width of screen
   int w, h;
-  SDL_GetRendererOutputSize(sf_window->getRenderer(), &w, &h);
+  sf_window->getRenderer()->GetOutputSize(w, h);
+
+  // Remember where we started this step, before any of the moves below
+  MarkStepStart();
+
+  // Assets with a limited lifetime use up one tick each time they move
+  if(lifetime > 0 && --lifetime == 0) {
+    this->SetNotAlive();
+    return;
+  }
 
   // Handle movement for type player
   if(SFASSET_PLAYER == type) {
     Vector2 c = *(bbox->centre) + Vector2(0.0f, speed);
 
     if(!(c.getY() < 64.0f) && !(c.getY()-18.0f > h)) {
-    bbox->centre.reset();
-    bbox->centre = make_shared<Vector2>(c);
+    *(bbox->centre) = c;
     }
   }
 	
@@ -251,8 +396,7 @@ void SFAsset::MoveVertical(float speed) {
   if(SFASSET_PROJECTILE == type){
     Vector2 c = *(bbox->centre) + Vector2(0.0f, speed);
     if(!(c.getY() > h + 32.0f)) {
-      bbox->centre.reset();
-      bbox->centre = make_shared<Vector2>(c);
+      *(bbox->centre) = c;
     }
     else {
       this->SetNotAlive();
@@ -263,20 +407,18 @@ void SFAsset::MoveVertical(float speed) {
   if(SFASSET_POWERUP == type){
     Vector2 c = *(bbox->centre) + Vector2(0.0f, speed);
     if(!(c.getY() > h + 32.0f)) {
-      bbox->centre.reset();
-      bbox->centre = make_shared<Vector2>(c);
+      *(bbox->centre) = c;
     }
     else {
       this->SetNotAlive();
     }
   }
 
-  // Handle movement for type projectile
+  // Handle movement for type enemy projectile, these fly south so die off the bottom
   if(SFASSET_EPROJECTILE == type){
     Vector2 c = *(bbox->centre) + Vector2(0.0f, speed);
-    if(!(c.getY() > h + 32.0f)) {
-      bbox->centre.reset();
-      bbox->centre = make_shared<Vector2>(c);
+    if(!(c.getY() < -32.0f)) {
+      *(bbox->centre) = c;
     }
     else {
       this->SetNotAlive();
@@ -288,8 +430,7 @@ void SFAsset::MoveVertical(float speed) {
     Vector2 c = *(bbox->centre) + Vector2(0.0f, speed);
 
     if(!(c.getY() < 0.0f)) {
-      bbox->centre.reset();
-      bbox->centre = make_shared<Vector2>(c);
+      *(bbox->centre) = c;
     }
     else{
       auto pos  = Point2(rand() % 600 + 32, rand() % 400 + 600);
@@ -297,27 +438,12 @@ void SFAsset::MoveVertical(float speed) {
     }
   }
 
-  // Handle movement for the background
-  if(SFASSET_STARS == type) {
-    Vector2 c = *(bbox->centre) + Vector2(0.0f, speed);
-
-    if(!(c.getY() < 0.0f)) {
-      bbox->centre.reset();
-      bbox->centre = make_shared<Vector2>(c);
-    }
-    else{
-      auto pos  = Point2(320, 1600);
-      this->SetPosition(pos);
-    }
-  }
-
   // Handle movement for type alien
   if(SFASSET_ALIEN == type) {     
     Vector2 c = *(bbox->centre) + Vector2(0.0f, speed);
 
     if(!(c.getY() < 0.0f)) {
-      bbox->centre.reset();
-        bbox->centre = make_shared<Vector2>(c);
+      *(bbox->centre) = c;
       }
     else{
       auto pos  = Point2(rand() % 600 + 32, rand() % 400 + 600);
@@ -331,33 +457,141 @@ void SFAsset::MoveVertical(float speed) {
   As mentioned in SFApp.cpp, this is my own movement
   handler.
 
-  It works by checking the keyboard state and scanning for
-  the code.
+  It works by checking which way the player is holding,
+  from the keyboard or a recorded session (see SFInput.h).
 *********************************************************/
-void SFAsset::HandleInput(){
-  int w, h;
-  SDL_GetRendererOutputSize(sf_window->getRenderer(), &w, &h);
-
-  // This section of the code handles keyboard input
+void SFAsset::HandleInput(const SFInputState & input){
   // Used for nice player movement.
-  const Uint8 *keyboardState = SDL_GetKeyboardState(NULL);
-  if(keyboardState[SDL_SCANCODE_DOWN] || keyboardState[SDL_SCANCODE_S]) {
+  if(input.down) {
     this->MoveVertical(-2.0f);
   }
-  if(keyboardState[SDL_SCANCODE_UP] || keyboardState[SDL_SCANCODE_W]) {
+  if(input.up) {
     this->MoveVertical(4.0f);
   }
-  if(keyboardState[SDL_SCANCODE_LEFT] || keyboardState[SDL_SCANCODE_A]) {
+  if(input.left) {
     this->MoveHorizontal(-5.0f);
   }
-  if(keyboardState[SDL_SCANCODE_RIGHT] || keyboardState[SDL_SCANCODE_D]) {
+  if(input.right) {
     this->MoveHorizontal(5.0f);
   }
 }
 
-// Collision detection
+// Collision detection, swept along this step's movement so fast
+// assets can't skip over each other between two ticks
 bool SFAsset::CollidesWith(shared_ptr<SFAsset> other) {
-  return bbox->CollidesWith(other->bbox);
+  return CollidesWith(other.get());
+}
+
+/*********************************************************
+  The boxes are swept, so fast projectiles can't pass
+  through something between one step and the next. Once
+  the boxes touch, the sprites' masks are checked too
+  (if both have one) so the see-through corners of a
+  sprite don't count.
+*********************************************************/
+bool SFAsset::CollidesWith(SFAsset * other) {
+  float toi;
+  if(!bbox->SweptCollidesWith(other->bbox, GetDisplacement(), other->GetDisplacement(), toi)) {
+    return false;
+  }
+  if(!pixelCollisions || !mask || !other->mask) {
+    return true;
+  }
+
+  boxHits++;
+  if(!PixelsCollideWith(other, toi)) {
+    return false;
+  }
+  pixelHits++;
+  return true;
+}
+
+/*********************************************************
+  Checks the masks from when the boxes first touched to
+  the end of the step, every pixel the two move relative
+  to each other, so a shot can't slip between an alien's
+  wings in one step either. Positions are rounded to the
+  nearest pixel, as they're drawn.
+*********************************************************/
+bool SFAsset::PixelsCollideWith(SFAsset * other, float toi) {
+  Vector2 relative = other->GetDisplacement() - GetDisplacement();
+  float distance = max(fabsf(relative.getX()), fabsf(relative.getY())) * (1.0f - toi);
+  int steps = max(1, (int) ceilf(distance));
+
+  for(int i = 0; i <= steps; i++) {
+    float t = toi + (1.0f - toi) * i / steps;
+    Vector2 a = GetCentreAt(t), b = other->GetCentreAt(t);
+    float aLeft = a.getX() - bbox->extent_x->getX(), aTop = a.getY() + bbox->extent_y->getY();
+    float bLeft = b.getX() - other->bbox->extent_x->getX(), bTop = b.getY() + other->bbox->extent_y->getY();
+
+    // Game space goes up, the masks' rows go down
+    if(SFMask::Overlaps(*mask, *other->mask, (int) roundf(bLeft - aLeft), (int) roundf(aTop - bTop))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Where the centre was a share t of the way through the current step
+Vector2 SFAsset::GetCentreAt(float t) {
+  return *(bbox->centre) - GetDisplacement() * (1.0f - t);
+}
+
+/*********************************************************
+  Gets how far the asset has moved during the current
+  simulation step. Assets that haven't moved this step
+  (or were just placed with SetPosition) have not moved.
+*********************************************************/
+Vector2 SFAsset::GetDisplacement() {
+  if(stepNumber != SFSTEP) {
+    return Vector2(0.0f, 0.0f);
+  }
+  return *(bbox->centre) - stepStart;
+}
+
+// Where the asset is now, in game space
+SFAABB SFAsset::GetBounds() {
+  Vector2 c = *(bbox->centre);
+  float ex = bbox->extent_x->getX(), ey = bbox->extent_y->getY();
+  SFAABB now = { c.getX() - ex, c.getY() - ey, c.getX() + ex, c.getY() + ey };
+  return now;
+}
+
+/*********************************************************
+  The box covering everywhere the asset has been during the
+  current step, for the broadphase. Anything that could hit
+  it this step overlaps this box.
+*********************************************************/
+SFAABB SFAsset::GetSweptBounds() {
+  Vector2 d = GetDisplacement();
+  SFAABB now = GetBounds();
+  SFAABB start = { now.lo_x - d.getX(), now.lo_y - d.getY(), now.hi_x - d.getX(), now.hi_y - d.getY() };
+  return Union(now, start);
+}
+
+SFProxyId SFAsset::GetProxy() {
+  return proxy;
+}
+
+void SFAsset::SetProxy(SFProxyId id) {
+  proxy = id;
+}
+
+// Remember where the asset was the first time it moves in a step
+void SFAsset::MarkStepStart() {
+  if(stepNumber != SFSTEP) {
+    stepStart  = *(bbox->centre);
+    stepNumber = SFSTEP;
+  }
+}
+
+/*********************************************************
+  Starts a new simulation step. Called once per tick
+  before anything moves, so movement from the last tick
+  is forgotten.
+*********************************************************/
+void SFAsset::BeginStep() {
+  SFSTEP++;
 }
 
 // Get bounding box of instance
@@ -374,6 +608,10 @@ bool SFAsset::IsAlive() {
   return (SFASSET_DEAD != type);
 }
 
+SFASSETTYPE SFAsset::GetType() {
+  return type;
+}
+
 // Specific collision handling for enemy to player
 void SFAsset::HandlePlayerCollision(){
   if(SFASSET_ALIEN == type){
@@ -382,20 +620,10 @@ void SFAsset::HandlePlayerCollision(){
   }
 }
 
-// Decides if enemies can fire projectiles
-bool SFAsset::HandleProjectile(){
-  int val = (rand() % 200 + 600);
-  // Check total fired and decide randomly if the enemy can fire again
-  if(this->GetFired() < 1 && val > 300 && val < 400){
-    this->SetFired(this->GetFired() + 1);
-    return true;
-  }
-}
-
 // Handing object collisions
 int SFAsset::HandleCollision() {
   // Collisions for projectiles
-  if(SFASSET_PROJECTILE == type) {
+  if(SFASSET_PROJECTILE == type || SFASSET_EPROJECTILE == type) {
     SetNotAlive();
   }
 
@@ -407,24 +635,22 @@ int SFAsset::HandleCollision() {
   // Collisions for aliens
   if(SFASSET_ALIEN == type){
     int canvas_w, canvas_h;
-    SDL_GetRendererOutputSize(sf_window->getRenderer(), &canvas_w, &canvas_h);
+    sf_window->getRenderer()->GetOutputSize(canvas_w, canvas_h);
 
     // For removing enemy health and checking if it died
     if(this->GetHealth() > 0){
       // Hurt the enemy for 5 HP
       this->SetHealth(this->GetHealth() - 5);
 
-      // Get HP as string
-      int tempHP = this->GetHealth();
-
-      // Convert the HP to string form
-      string HPTempString;
-      ostringstream HPConvert;
-      HPConvert << tempHP;
-      HPTempString = HPConvert.str();
-
-      // Tell player it was hurt
-      cout << "Hurt enemy " << this->GetId() << " for 5 HP. (EnemyHP: " << (this->GetHealth() <= 0 ? "DEAD" : HPTempString) << ")" << endl;
+      // Tell player it was hurt (streaming the HP directly saves building a string)
+      cout << "Hurt enemy " << SFHandleIndex(this->GetId()) << " for 5 HP. (EnemyHP: ";
+      if(this->GetHealth() <= 0) {
+        cout << "DEAD";
+      }
+      else {
+        cout << this->GetHealth();
+      }
+      cout << ")" << endl;
 
       // Do another check because we can reach 0, but it won't check until next collision.
       if(this->GetHealth() <= 0){
@@ -444,7 +670,7 @@ int SFAsset::HandleCollision() {
       this->SetHealth(15);
 
       // Tell player
-      cout << "Enemy " << this->GetId() << " died!" << endl;
+      cout << "Enemy " << SFHandleIndex(this->GetId()) << " died!" << endl;
 
       // Return special condition back to call
       return 1;
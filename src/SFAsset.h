@@ -5,6 +5,7 @@
 #include <memory>
 #include <iostream>
 #include <sstream>
+#include <map>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
@@ -15,6 +16,10 @@ using namespace std;
 #include "SFEvent.h"
 #include "SFWindow.h"
 #include "SFBoundingBox.h"
+#include "SFBroadphase.h"
+#include "SFProfiler.h"
+#include "SFInput.h"
+#include "SFMask.h"
 
 /**
  * We could create SFPlayer, SFProjectile and SFAsset which are subclasses
@@ -22,7 +27,7 @@ using namespace std;
  * enum to mark the type of the SFAsset.  If we add more asset types then
  * the subclassing strategy becomes a better option.
  */
-enum SFASSETTYPE {SFASSET_DEAD, SFASSET_PLAYER, SFASSET_PROJECTILE, SFASSET_EPROJECTILE, SFASSET_ALIEN, SFASSET_COIN, SFASSET_POWERUP, SFASSET_STARS, SFASSET_HEALTHBAR, SFASSET_HEALTHBLOCKG, SFASSET_HEALTHBLOCKY, SFASSET_HEALTHBLOCKR};
+enum SFASSETTYPE {SFASSET_DEAD, SFASSET_PLAYER, SFASSET_PROJECTILE, SFASSET_EPROJECTILE, SFASSET_ALIEN, SFASSET_COIN, SFASSET_POWERUP, SFASSET_HEALTHBAR, SFASSET_HEALTHBLOCKG, SFASSET_HEALTHBLOCKY, SFASSET_HEALTHBLOCKR};
 
 class SFAsset {
 public:
@@ -34,29 +39,49 @@ public:
   virtual Point2    GetPosition();
   virtual SFAssetId GetId();
   virtual void      OnRender();
+  virtual SFRect    GetScreenRect();
   virtual void      MoveHorizontal(float speed);
   virtual void      MoveVertical(float speed);
   virtual void      SetNotAlive();
   virtual bool      IsAlive();
+  virtual SFASSETTYPE GetType();
   virtual int       HandleCollision();
   virtual void      HandlePlayerCollision();
-  virtual void      HandleInput();
+  virtual void      HandleInput(const SFInputState &);
   virtual int       GetHealth();
   virtual void      SetHealth(int val);
   virtual int       GetScore();
   virtual void      SetScore(int val);
-  virtual bool      HandleProjectile();
   virtual int       GetFired();
   virtual void      SetFired(int val);
+  virtual void      SetLifetime(int ticks);
+  virtual void      Reset(SFASSETTYPE);
+  virtual void      Retire();
   
-  virtual bool      CollidesWith(shared_ptr<SFAsset>);;
+  virtual bool      CollidesWith(shared_ptr<SFAsset>);
+  virtual bool      CollidesWith(SFAsset *);
   virtual shared_ptr<SFBoundingBox> GetBoundingBox();
+  virtual Vector2   GetDisplacement();
+  virtual SFAABB    GetBounds();
+  virtual SFAABB    GetSweptBounds();
+  virtual SFProxyId GetProxy();
+  virtual void      SetProxy(SFProxyId);
+
+  static void       BeginStep();
+  static SFAsset *  Find(SFAssetId);
+  static int        GetLiveIds();
+  static shared_ptr<SFTexture> LoadTexture(SFRenderer *, const string &);
+  static shared_ptr<SFMask>    LoadMask(const string &);
+
+  // Whether collisions check the sprites' pixels once their boxes touch (see SFMask.h)
+  static void       SetPixelCollisions(bool);
+  static long       GetBoxHits();       // Pairs whose boxes touched
+  static long       GetPixelHits();     // Of those, the ones whose pixels did too
 private:
-  // it would be nice if we could make this into a smart pointer,
-  // but, because we need to call SDL_FreeSurface on it, we can't.
-  // (or we could use a std::shared_ptr with a custom Deleter, but
-  // that's a little too much right now)
-  SDL_Texture               * sprite;
+  // Shared with every other asset using the same image, the texture
+  // is destroyed once the last one is gone.
+  shared_ptr<SFTexture>       sprite;
+  shared_ptr<SFMask>          mask;      // nullptr if the image couldn't be read, the box is used instead
   shared_ptr<SFBoundingBox>   bbox;
   SFASSETTYPE                 type;
   SFAssetId                   id;
@@ -66,8 +91,25 @@ private:
   int                         playerScore;
 
   int                         totFired;
+  int                         lifetime;
+
+  // Where this asset was at the start of the current step (for swept collisions)
+  Vector2                     stepStart;
+  int                         stepNumber;
+
+  // This asset's box in the app's broadphase, if it has one
+  SFProxyId                   proxy;
+
+  virtual void      MarkStepStart();
+  virtual bool      PixelsCollideWith(SFAsset *, float toi);
+  virtual Vector2   GetCentreAt(float t);
 
-  static int SFASSETID;
+  static SFHandleTable handles;
+  static map<string, weak_ptr<SFTexture>> textures;
+  static map<string, weak_ptr<SFMask>> masks;
+  static bool pixelCollisions;
+  static long boxHits, pixelHits;
+  static int SFSTEP;
 };
 
 #endif
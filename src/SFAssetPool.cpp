@@ -0,0 +1,83 @@
+#include <algorithm>
+
+#include "SFAssetPool.h"
+
+SFAssetPool::SFAssetPool(SFASSETTYPE type, shared_ptr<SFWindow> window, int chunk) : type(type), sf_window(window), chunk(chunk), peak(0), growths(0) {
+  Grow(chunk);
+}
+
+/*********************************************************
+  Takes a free asset out of the pool, making another chunk
+  of them first if there aren't any left.
+*********************************************************/
+shared_ptr<SFAsset> SFAssetPool::Spawn() {
+  if(freeSlots.empty()) {
+    Grow(chunk);
+    growths++;
+  }
+
+  shared_ptr<SFAsset> asset = freeSlots.back();
+  freeSlots.pop_back();
+  asset->Reset(type);
+
+  peak = max(peak, GetLive());
+  return asset;
+}
+
+// Hands a dead asset back. It stays in the pool until it's spawned again.
+void SFAssetPool::Release(const shared_ptr<SFAsset> & asset) {
+  asset->Retire();
+  freeSlots.push_back(asset);
+}
+
+// Makes sure there are at least this many assets, without counting it as growth
+void SFAssetPool::Reserve(int capacity) {
+  if(capacity > (int) slots.size()) {
+    Grow(capacity - slots.size());
+  }
+}
+
+/*********************************************************
+  The lists at least double when they run out of room, so
+  growing a chunk at a time doesn't copy every slot each
+  time.
+*********************************************************/
+void SFAssetPool::Grow(int count) {
+  size_t needed = slots.size() + count;
+  if(needed > slots.capacity()) {
+    slots.reserve(max(needed, slots.capacity() * 2));
+  }
+  if(needed > freeSlots.capacity()) {
+    freeSlots.reserve(max(needed, freeSlots.capacity() * 2));
+  }
+  for(int i = 0; i < count; i++) {
+    slots.push_back(make_shared<SFAsset>(type, sf_window));
+    slots.back()->Retire();
+    freeSlots.push_back(slots.back());
+  }
+}
+
+SFASSETTYPE SFAssetPool::GetType() const {
+  return type;
+}
+
+int SFAssetPool::GetCapacity() const {
+  return slots.size();
+}
+
+int SFAssetPool::GetLive() const {
+  return slots.size() - freeSlots.size();
+}
+
+int SFAssetPool::GetPeak() const {
+  return peak;
+}
+
+int SFAssetPool::GetGrowths() const {
+  return growths;
+}
+
+ostream& operator<<(ostream& os, const SFAssetPool& obj) {
+  os << obj.GetLive() << " of " << obj.GetCapacity() << " in use (peak " << obj.GetPeak() << ", grew " << obj.GetGrowths() << " time(s))";
+  return os;
+}
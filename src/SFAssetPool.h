@@ -0,0 +1,52 @@
+#ifndef SFASSETPOOL_H
+#define SFASSETPOOL_H
+
+#include <memory>
+#include <vector>
+#include <ostream>
+
+using namespace std;
+
+#include "SFAsset.h"
+
+/**
+ * A pool of ready made assets of one type. Spawn hands out a free one,
+ * reset as if it was new, and Release gives it back once it's dead, so
+ * firing, drops and waves don't allocate anything.
+ *
+ * The pool starts with one chunk of assets and grows by another chunk
+ * whenever it runs out. Each growth is counted so a pool that keeps
+ * growing can be given a bigger chunk.
+ */
+class SFAssetPool {
+public:
+  SFAssetPool(SFASSETTYPE, shared_ptr<SFWindow>, int chunk);
+
+  shared_ptr<SFAsset> Spawn();
+  void        Release(const shared_ptr<SFAsset> &);
+  void        Reserve(int capacity);
+
+  SFASSETTYPE GetType() const;
+  int         GetCapacity() const;
+  int         GetLive() const;
+  int         GetPeak() const;
+  int         GetGrowths() const;
+
+private:
+  void        Grow(int count);
+
+  SFASSETTYPE                 type;
+  shared_ptr<SFWindow>        sf_window;
+  int                         chunk;
+
+  // Every asset the pool made, and the ones not in use
+  vector<shared_ptr<SFAsset>> slots;
+  vector<shared_ptr<SFAsset>> freeSlots;
+
+  int                         peak;
+  int                         growths;
+};
+
+ostream& operator<<(ostream &, const SFAssetPool &);
+
+#endif
@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <iostream>
+
+#include "SFBackground.h"
+#include "SFProfiler.h"
+
+static SFStarfield MakeStarfield(shared_ptr<SFWindow> window, int layers, int stars) {
+  int w, h;
+  window->getRenderer()->GetOutputSize(w, h);
+  return SFStarfield(7, w, h, layers, stars);
+}
+
+SFBackground::SFBackground(shared_ptr<SFWindow> window, int layers, int stars) : sf_window(window), starfield(MakeStarfield(window, layers, stars)), farthest(0) {
+  const uint32_t white = 0xFFFFFFFF;
+  SFTexture * texture = sf_window->getRenderer()->CreateTexture(1, 1, &white);
+  if(!texture) {
+    cerr << "Could not make the texture for the stars" << endl;
+    throw SF_ERROR_LOAD_ASSET;
+  }
+  dot = SFRenderer::Counted(texture);
+  sprites.reserve(starfield.GetCount());
+}
+
+bool SFBackground::Scroll(float pixels) {
+  return starfield.Scroll(pixels);
+}
+
+void SFBackground::OnRender() {
+  sprites.clear();
+  starfield.BuildSprites(sprites, 1, 1, farthest);
+  if(!sprites.empty()) {
+    SFProfiler::CountDrawCalls(sf_window->getRenderer()->CopyBatch(dot.get(), sprites.data(), sprites.size()));
+  }
+}
+
+void SFBackground::SetLayersDrawn(int layers) {
+  farthest = max(starfield.GetLayers() - layers, 0);
+}
+
+const SFStarfield & SFBackground::GetStarfield() const {
+  return starfield;
+}
@@ -0,0 +1,38 @@
+#ifndef SFBACKGROUND_H
+#define SFBACKGROUND_H
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+#include "SFStarfield.h"
+#include "SFWindow.h"
+
+/**
+ * Draws the SFStarfield: every star is the same one white pixel texture,
+ * stretched to the star's size and faded to its layer's brightness, in one
+ * CopyBatch.
+ */
+class SFBackground {
+public:
+  SFBackground(shared_ptr<SFWindow>, int layers, int stars);
+
+  // See SFStarfield::Scroll
+  bool                 Scroll(float pixels);
+  void                 OnRender();
+
+  // Draws only the nearest layers, leaving out the far ones (which have the most stars)
+  void                 SetLayersDrawn(int);
+
+  const SFStarfield  & GetStarfield() const;
+
+private:
+  shared_ptr<SFWindow>  sf_window;
+  SFStarfield           starfield;
+  shared_ptr<SFTexture> dot;
+  vector<SFSprite>      sprites;   // Kept from frame to frame so drawing doesn't allocate
+  int                   farthest;  // The farthest layer drawn
+};
+
+#endif
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "SFBoundingBox.h"
 
 SFBoundingBox::SFBoundingBox(const Vector2 centre,
@@ -15,7 +17,7 @@ SFBoundingBox::~SFBoundingBox() {
 }
 
 void SFBoundingBox::SetCentre(Vector2 & v) {
-  centre = make_shared<Vector2>(v);
+  *centre = v;
 }
 
 bool straddles(const pair<float, float> & a, const pair<float, float> & b) {
@@ -57,6 +59,59 @@ bool SFBoundingBox::CollidesWith(const shared_ptr<SFBoundingBox> b) {
   return (straddles(a_x_proj, b_x_proj)) && (straddles(a_y_proj, b_y_proj));
 }
 
+/**
+ * Continuous version of CollidesWith.  Both boxes are taken to be at the
+ * end of a step in which this box moved by `d_this` and `b` moved by
+ * `d_other`.  If the boxes touched at any point during the step then
+ * `toi` is set to the time of impact in [0, 1] (0 being the start of the
+ * step) and true is returned.  A fast box can no longer tunnel through a
+ * thin one just because it jumped over it between two ticks.
+ */
+bool SFBoundingBox::SweptCollidesWith(const shared_ptr<SFBoundingBox> b,
+				      const Vector2 & d_this,
+				      const Vector2 & d_other,
+				      float & toi) {
+  // Work in the frame of `b`, i.e. `b` stands still and this box moves by v
+  Vector2 v = d_this - d_other;
+
+  pair<float, float> a_proj[2] = { projectOntoAxis(*this, X), projectOntoAxis(*this, Y) },
+    b_proj[2] = { projectOntoAxis(*b, X), projectOntoAxis(*b, Y) };
+  float a_move[2] = { projection(Point2(d_this), xAxis()), projection(Point2(d_this), yAxis()) },
+    b_move[2] = { projection(Point2(d_other), xAxis()), projection(Point2(d_other), yAxis()) },
+    rel[2] = { projection(Point2(v), xAxis()), projection(Point2(v), yAxis()) };
+
+  float t_enter = 0.0f, t_exit = 1.0f;
+  for(int axis = 0; axis < 2; axis++) {
+    // Rewind both projections to where they were at the start of the step
+    pair<float, float> a0 = make_pair(a_proj[axis].first - a_move[axis], a_proj[axis].second - a_move[axis]),
+      b0 = make_pair(b_proj[axis].first - b_move[axis], b_proj[axis].second - b_move[axis]);
+
+    if(rel[axis] == 0.0f) {
+      // No relative motion on this axis, so it must overlap for the whole step
+      if(!straddles(a0, b0)) {
+        return false;
+      }
+      continue;
+    }
+
+    // Times at which the leading and trailing edges meet
+    float t0 = (b0.first - a0.second) / rel[axis],
+      t1 = (b0.second - a0.first) / rel[axis];
+    if(t0 > t1) {
+      swap(t0, t1);
+    }
+
+    t_enter = max(t_enter, t0);
+    t_exit  = min(t_exit, t1);
+    if(t_enter > t_exit) {
+      return false;
+    }
+  }
+
+  toi = t_enter;
+  return true;
+}
+
 ostream& operator<<(ostream& os, const SFBoundingBox& obj) {
   os << "c:(" << obj.centre->getX() << ", " << obj.centre->getY() << ") w:" << (obj.extent_x->getX()*2) << " h:" << (obj.extent_y->getY()*2);
   return os;
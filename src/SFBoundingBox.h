@@ -18,6 +18,7 @@ public:
   void SetCentre(Vector2 &);
 
   bool CollidesWith(const shared_ptr<SFBoundingBox>);
+  bool SweptCollidesWith(const shared_ptr<SFBoundingBox>, const Vector2 &, const Vector2 &, float &);
 
 private:
   shared_ptr<Vector2> centre, extent_x, extent_y;
@@ -0,0 +1,187 @@
+#include <algorithm>
+
+#include "SFBroadphase.h"
+#include "SFAABBTree.h"
+#include "SFSweepAndPrune.h"
+
+bool SFAABB::Overlaps(const SFAABB & b) const {
+  return lo_x <= b.hi_x && b.lo_x <= hi_x && lo_y <= b.hi_y && b.lo_y <= hi_y;
+}
+
+bool SFAABB::Contains(const SFAABB & b) const {
+  return lo_x <= b.lo_x && lo_y <= b.lo_y && b.hi_x <= hi_x && b.hi_y <= hi_y;
+}
+
+bool SFAABB::Contains(const Point2 & p) const {
+  return lo_x <= p.getX() && p.getX() <= hi_x && lo_y <= p.getY() && p.getY() <= hi_y;
+}
+
+/**
+ * Slab test for the segment from + t * d, t in [0, 1]. On a hit
+ * `fraction` is where the segment enters the box (0 if it starts inside).
+ */
+bool SFAABB::RayHit(const Point2 & from, const Vector2 & d, float & fraction) const {
+  float origin[2] = { from.getX(), from.getY() },
+    dir[2] = { d.getX(), d.getY() },
+    lo[2] = { lo_x, lo_y },
+    hi[2] = { hi_x, hi_y };
+
+  float t_enter = 0.0f, t_exit = 1.0f;
+  for(int axis = 0; axis < 2; axis++) {
+    if(dir[axis] == 0.0f) {
+      // Parallel to this slab, so it has to start inside it
+      if(origin[axis] < lo[axis] || origin[axis] > hi[axis]) {
+        return false;
+      }
+      continue;
+    }
+
+    float t0 = (lo[axis] - origin[axis]) / dir[axis],
+      t1 = (hi[axis] - origin[axis]) / dir[axis];
+    if(t0 > t1) {
+      swap(t0, t1);
+    }
+
+    t_enter = max(t_enter, t0);
+    t_exit  = min(t_exit, t1);
+    if(t_enter > t_exit) {
+      return false;
+    }
+  }
+
+  fraction = t_enter;
+  return true;
+}
+
+// Used as the cost of a box when deciding where to put it in the tree
+float SFAABB::Perimeter() const {
+  return 2.0f * ((hi_x - lo_x) + (hi_y - lo_y));
+}
+
+SFAABB SFAABB::Fattened(float margin) const {
+  SFAABB fat = { lo_x - margin, lo_y - margin, hi_x + margin, hi_y + margin };
+  return fat;
+}
+
+SFAABB Union(const SFAABB & a, const SFAABB & b) {
+  SFAABB u = { min(a.lo_x, b.lo_x), min(a.lo_y, b.lo_y), max(a.hi_x, b.hi_x), max(a.hi_y, b.hi_y) };
+  return u;
+}
+
+/*********************************************************
+  Which factions can hit each other: player projectiles
+  hit aliens, and the player crashes into aliens, picks up
+  pickups and gets hit by enemy projectiles.
+*********************************************************/
+bool SFFactionsMeet(SFFACTION a, SFFACTION b) {
+  static const bool meet[SFFACTION_LAST][SFFACTION_LAST] = {
+    //               player pproj  alien  eproj  pickup
+    /* player */   { false, false, true,  true,  true  },
+    /* pproj  */   { false, false, true,  false, false },
+    /* alien  */   { true,  true,  false, false, false },
+    /* eproj  */   { true,  false, false, false, false },
+    /* pickup */   { true,  false, false, false, false },
+  };
+  return meet[a][b];
+}
+
+/*********************************************************
+  Makes the broadphase picked on the command line.
+*********************************************************/
+shared_ptr<SFBroadphase> SFBroadphase::Create(SFBROADPHASE type) {
+  switch(type) {
+    case SFBROADPHASE_BRUTE:
+      return make_shared<SFBruteForceBroadphase>();
+    case SFBROADPHASE_TREE:
+      return make_shared<SFAABBTree>();
+    case SFBROADPHASE_SAP:
+      return make_shared<SFSweepAndPrune>();
+  }
+  return nullptr;
+}
+
+/*********************************************************
+  Brute force broadphase. Proxy ids are indexes into the
+  proxies array, freed ones are handed out again.
+*********************************************************/
+SFProxyId SFBruteForceBroadphase::CreateProxy(const SFAABB & aabb, void * userData, SFFACTION faction) {
+  Proxy proxy = { aabb, userData, faction, true };
+
+  if(!freeIds.empty()) {
+    SFProxyId id = freeIds.back();
+    freeIds.pop_back();
+    proxies[id] = proxy;
+    return id;
+  }
+
+  proxies.push_back(proxy);
+  return proxies.size() - 1;
+}
+
+void SFBruteForceBroadphase::DestroyProxy(SFProxyId id) {
+  proxies[id].used = false;
+  proxies[id].userData = nullptr;
+  freeIds.push_back(id);
+}
+
+void SFBruteForceBroadphase::MoveProxy(SFProxyId id, const SFAABB & aabb, const Vector2 &) {
+  proxies[id].aabb = aabb;
+}
+
+void * SFBruteForceBroadphase::GetUserData(SFProxyId id) const {
+  return proxies[id].userData;
+}
+
+SFFACTION SFBruteForceBroadphase::GetFaction(SFProxyId id) const {
+  return proxies[id].faction;
+}
+
+int SFBruteForceBroadphase::GetProxyCount() const {
+  return proxies.size() - freeIds.size();
+}
+
+void SFBruteForceBroadphase::Query(const SFAABB & aabb, vector<SFProxyId> & out) {
+  for(size_t i = 0; i < proxies.size(); i++) {
+    if(proxies[i].used && proxies[i].aabb.Overlaps(aabb)) {
+      out.push_back(i);
+    }
+  }
+}
+
+void SFBruteForceBroadphase::QueryPoint(const Point2 & p, vector<SFProxyId> & out) {
+  for(size_t i = 0; i < proxies.size(); i++) {
+    if(proxies[i].used && proxies[i].aabb.Contains(p)) {
+      out.push_back(i);
+    }
+  }
+}
+
+void SFBruteForceBroadphase::RayCast(const Point2 & from, const Point2 & to, vector<SFRayHit> & out) {
+  Vector2 d = to - from;
+  for(size_t i = 0; i < proxies.size(); i++) {
+    float fraction;
+    if(proxies[i].used && proxies[i].aabb.RayHit(from, d, fraction)) {
+      SFRayHit hit = { (SFProxyId) i, fraction };
+      out.push_back(hit);
+    }
+  }
+}
+
+void SFBruteForceBroadphase::FindPairs(vector<SFProxyPair> & out) {
+  for(size_t i = 0; i < proxies.size(); i++) {
+    for(size_t j = i + 1; j < proxies.size(); j++) {
+      const Proxy & a = proxies[i], & b = proxies[j];
+      if(a.used && b.used && SFFactionsMeet(a.faction, b.faction) && a.aabb.Overlaps(b.aabb)) {
+        SFProxyPair pair = { (SFProxyId) i, (SFProxyId) j };
+        if(b.faction < a.faction) {
+          swap(pair.a, pair.b);
+        }
+        out.push_back(pair);
+      }
+    }
+  }
+}
+
+const char * SFBruteForceBroadphase::GetName() const {
+  return "brute";
+}
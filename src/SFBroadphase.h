@@ -0,0 +1,117 @@
+#ifndef SFBROADPHASE_H
+#define SFBROADPHASE_H
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFMath.h"
+
+/**
+ * An axis aligned box given by its lowest and highest corners. This is
+ * what the broadphase works with, it doesn't need the rest of
+ * SFBoundingBox.
+ */
+struct SFAABB {
+  float lo_x, lo_y, hi_x, hi_y;
+
+  bool   Overlaps(const SFAABB &) const;
+  bool   Contains(const SFAABB &) const;
+  bool   Contains(const Point2 &) const;
+  bool   RayHit(const Point2 & from, const Vector2 & d, float & fraction) const;
+  float  Perimeter() const;
+  SFAABB Fattened(float margin) const;
+};
+
+SFAABB Union(const SFAABB &, const SFAABB &);
+
+// Identifies one box stored in a broadphase
+typedef int SFProxyId;
+const SFProxyId SF_NULL_PROXY = -1;
+
+/**
+ * Which side an entity is on. Only some factions can hit each other (see
+ * SFFactionsMeet) and FindPairs only reports those pairs.
+ */
+enum SFFACTION {SFFACTION_PLAYER, SFFACTION_PPROJECTILE, SFFACTION_ALIEN, SFFACTION_EPROJECTILE, SFFACTION_PICKUP, SFFACTION_LAST};
+
+bool SFFactionsMeet(SFFACTION, SFFACTION);
+
+// Two proxies whose boxes overlap. `a` is always in the lower numbered faction.
+struct SFProxyPair {
+  SFProxyId a, b;
+};
+
+// A box that a ray passed through, and how far along the ray it entered
+struct SFRayHit {
+  SFProxyId proxy;
+  float     fraction;
+};
+
+/**
+ * Finds which boxes might be touching without testing every box against
+ * every other one. It only answers "maybe": callers still do the exact
+ * test (SFAsset::CollidesWith) on whatever comes back.
+ *
+ * Each box is a proxy that carries a pointer back to whatever owns it
+ * and the faction it is on. Results are appended to the vector passed
+ * in, so a caller that keeps the vector around doesn't allocate once it
+ * has grown.
+ */
+class SFBroadphase {
+public:
+  virtual ~SFBroadphase() {}
+
+  virtual SFProxyId CreateProxy(const SFAABB &, void * userData, SFFACTION) = 0;
+  virtual void      DestroyProxy(SFProxyId) = 0;
+  virtual void      MoveProxy(SFProxyId, const SFAABB &, const Vector2 & displacement) = 0;
+  virtual void *    GetUserData(SFProxyId) const = 0;
+  virtual SFFACTION GetFaction(SFProxyId) const = 0;
+  virtual int       GetProxyCount() const = 0;
+
+  virtual void      Query(const SFAABB &, vector<SFProxyId> &) = 0;
+  virtual void      QueryPoint(const Point2 &, vector<SFProxyId> &) = 0;
+  virtual void      RayCast(const Point2 & from, const Point2 & to, vector<SFRayHit> &) = 0;
+  virtual void      FindPairs(vector<SFProxyPair> &) = 0;
+
+  virtual const char * GetName() const = 0;
+
+  static shared_ptr<SFBroadphase> Create(SFBROADPHASE);
+};
+
+/**
+ * Tests every proxy, every time. Slow with a lot of entities but there's
+ * nothing to go wrong, so it's what the other broadphases are checked
+ * against.
+ */
+class SFBruteForceBroadphase : public SFBroadphase {
+public:
+  SFProxyId CreateProxy(const SFAABB &, void * userData, SFFACTION);
+  void      DestroyProxy(SFProxyId);
+  void      MoveProxy(SFProxyId, const SFAABB &, const Vector2 & displacement);
+  void *    GetUserData(SFProxyId) const;
+  SFFACTION GetFaction(SFProxyId) const;
+  int       GetProxyCount() const;
+
+  void      Query(const SFAABB &, vector<SFProxyId> &);
+  void      QueryPoint(const Point2 &, vector<SFProxyId> &);
+  void      RayCast(const Point2 & from, const Point2 & to, vector<SFRayHit> &);
+  void      FindPairs(vector<SFProxyPair> &);
+
+  const char * GetName() const;
+
+private:
+  struct Proxy {
+    SFAABB    aabb;
+    void    * userData;
+    SFFACTION faction;
+    bool      used;
+  };
+
+  vector<Proxy>     proxies;
+  vector<SFProxyId> freeIds;
+};
+
+#endif
@@ -1,12 +1,55 @@
 #ifndef SFCOMMON_H
 #define SFCOMMON_H
 
-enum SFError {SF_ERROR_NONE, SF_ERROR_INIT, SF_ERROR_VIDEOMODE, SF_ERROR_LOAD_ASSET};
+#include "SFHandle.h"
+
+enum SFError {SF_ERROR_NONE, SF_ERROR_INIT, SF_ERROR_VIDEOMODE, SF_ERROR_LOAD_ASSET, SF_ERROR_HANDLES};
+
+// The parts of a frame that the profiler attributes work to
+enum SFPHASE {SFPHASE_OTHER, SFPHASE_INPUT, SFPHASE_MOVEMENT, SFPHASE_COLLISION, SFPHASE_EVENTS, SFPHASE_CLEANUP, SFPHASE_HUD, SFPHASE_RENDER, SFPHASE_LAST};
+
+// Which broadphase finds the pairs that might collide (see SFBroadphase.h)
+enum SFBROADPHASE {SFBROADPHASE_BRUTE, SFBROADPHASE_TREE, SFBROADPHASE_SAP};
+
+// What draws the frames (see SFRenderer.h)
+enum SFRENDERER {SFRENDERER_SDL, SFRENDERER_SOFTWARE};
+
+// Whether Present waits for the display's refresh (see SFLatency.h)
+enum SFPRESENT {SFPRESENT_IMMEDIATE, SFPRESENT_VSYNC, SFPRESENT_LAST};
+
+// How much optional work a frame does, lowest first (see SFGovernor.h)
+enum SFQUALITY {SFQUALITY_LOW, SFQUALITY_MEDIUM, SFQUALITY_HIGH, SFQUALITY_LAST};
+
+// What a timer in the SFTimerWheel is for
+enum SFTIMER {SFTIMER_POWER_EXPIRE, SFTIMER_ENEMY_FIRE, SFTIMER_EMITTER_FIRE};
+
+// Kinds of particle effect (see SFEffects.h)
+enum SFEFFECT {SFEFFECT_EXPLOSION, SFEFFECT_FLASH, SFEFFECT_SPARKLE, SFEFFECT_LAST};
+
+// What a tile of the level is (see SFTileMap.h)
+enum SFTILE {SFTILE_EMPTY, SFTILE_WALL};
+
+// The keys the game reads through the input queue (see SFInputQueue.h)
+enum SFKEY {SFKEY_UP, SFKEY_DOWN, SFKEY_LEFT, SFKEY_RIGHT, SFKEY_FIRE, SFKEY_LAST};
+
+// The layers a frame is drawn in, bottom to top (see SFLayerCache.h)
+enum SFLAYER {SFLAYER_BACKGROUND, SFLAYER_WORLD, SFLAYER_HUD, SFLAYER_LAST};
 
 // Forward declaration of classes
 class SFEvent;
 class SFAsset;
 
-typedef int SFAssetId;
+// Assets are referred to by handles in SFAsset's table (see SFHandle.h)
+typedef SFHandle SFAssetId;
+
+// How many of each kind of entity are in the world, for stats and the overlay
+struct SFEntityCounts {
+  int aliens;
+  int pProjectiles;
+  int eProjectiles;
+  int coins;
+  int powers;
+  int particles;
+};
 
 #endif
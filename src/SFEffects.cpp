@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "SFEffects.h"
+#include "SFAsset.h"
+#include "SFProfiler.h"
+
+// How an effect throws its particles out, and what share of the capacity it gets
+struct SFBurst {
+  int             particles;
+  float           speedMin, speedMax;
+  float           lifeMin, lifeMax;
+  float           share;
+  SFParticleStyle style;      // The sheet's frame size is filled in from the texture
+};
+
+static const SFBurst bursts[SFEFFECT_LAST] = {
+  // Explosion: a big ball that slows down and fades as it shrinks
+  { 40, 0.5f, 3.5f, 20.0f, 45.0f, 0.75f,   { 0.0f,  0.94f, 20.0f, 4.0f, 1, 1, 0, 0 } },
+  // Muzzle flash: a few quick specks
+  { 4,  0.5f, 1.5f, 4.0f,  8.0f,  0.0625f, { 0.0f,  0.80f, 14.0f, 2.0f, 1, 1, 0, 0 } },
+  // Pickup sparkle: small and drifting up
+  { 12, 0.3f, 1.5f, 25.0f, 40.0f, 0.1875f, { 0.05f, 0.97f, 8.0f,  1.0f, 1, 1, 0, 0 } },
+};
+
+/*********************************************************
+  explosion.png is a single frame, so the sheets are one
+  frame each and the particles animate by shrinking and
+  fading. A sheet with more frames only needs its frames
+  and columns changing in the table above.
+*********************************************************/
+SFEffects::SFEffects(shared_ptr<SFWindow> window, int capacity) : sf_window(window), seed(2463534242u), density(1.0f) {
+  texture = SFAsset::LoadTexture(sf_window->getRenderer(), "assets/explosion.png");
+  if(!texture) {
+    cerr << "Could not load assets/explosion.png" << endl;
+    throw SF_ERROR_LOAD_ASSET;
+  }
+
+  pools.reserve(SFEFFECT_LAST);
+  for(int e = 0; e < SFEFFECT_LAST; e++) {
+    SFParticleStyle style = bursts[e].style;
+    style.frameW = texture->GetWidth() / style.columns;
+    style.frameH = texture->GetHeight() / ((style.frames + style.columns - 1) / style.columns);
+    pools.push_back(SFParticlePool((int) (capacity * bursts[e].share), style));
+  }
+  sprites.reserve(capacity);
+}
+
+// A xorshift generator, lo to hi
+float SFEffects::Random(float lo, float hi) {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return lo + (hi - lo) * (seed >> 8) / 16777216.0f;
+}
+
+/*********************************************************
+  Throws out a burst of particles in every direction.
+  Whatever doesn't fit in the effect's pool is dropped,
+  counted by GetDropped.
+*********************************************************/
+void SFEffects::Emit(SFEFFECT effect, const Point2 & where) {
+  const SFBurst & burst = bursts[effect];
+  int particles = max(1, (int) (burst.particles * density + 0.5f));
+  for(int i = 0; i < particles; i++) {
+    float angle = Random(0.0f, 6.2831853f), speed = Random(burst.speedMin, burst.speedMax);
+    pools[effect].Emit(where.getX(), where.getY(), cosf(angle) * speed, sinf(angle) * speed, Random(burst.lifeMin, burst.lifeMax));
+  }
+}
+
+void SFEffects::OnKills(const vector<SFKillEvent> & events) {
+  for(auto & e : events) {
+    Emit(SFEFFECT_EXPLOSION, e.where);
+  }
+}
+
+void SFEffects::OnPickups(const vector<SFPickupEvent> & events) {
+  for(auto & e : events) {
+    Emit(SFEFFECT_SPARKLE, e.where);
+  }
+}
+
+void SFEffects::Update() {
+  for(auto & pool : pools) {
+    pool.Update();
+  }
+}
+
+void SFEffects::OnRender() {
+  SFRenderer * renderer = sf_window->getRenderer();
+  int w, h;
+  renderer->GetOutputSize(w, h);
+
+  for(auto & pool : pools) {
+    sprites.clear();
+    pool.BuildSprites(sprites, w, h);
+    if(!sprites.empty()) {
+      SFProfiler::CountDrawCalls(renderer->CopyBatch(texture.get(), sprites.data(), sprites.size()));
+    }
+  }
+}
+
+int SFEffects::GetCount() const {
+  int count = 0;
+  for(auto & pool : pools) {
+    count += pool.GetCount();
+  }
+  return count;
+}
+
+void SFEffects::SetDensity(float share) {
+  density = min(max(share, 0.0f), 1.0f);
+}
+
+long SFEffects::GetDropped() const {
+  long dropped = 0;
+  for(auto & pool : pools) {
+    dropped += pool.GetDropped();
+  }
+  return dropped;
+}
@@ -0,0 +1,56 @@
+#ifndef SFEFFECTS_H
+#define SFEFFECTS_H
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFEventBus.h"
+#include "SFParticles.h"
+#include "SFWindow.h"
+
+/**
+ * Explosions where aliens die, sparkles where pickups are picked up and a
+ * flash from the player's gun, all made of particles from
+ * assets/explosion.png. Each kind of effect has its own SFParticlePool,
+ * drawn with one SFRenderer::CopyBatch, so the cost of a frame of
+ * particles is a pass over some arrays and a draw call for each kind,
+ * however many of them there are.
+ *
+ * The particles are scenery, nothing collides with them. They use their
+ * own random numbers so the game's rand() comes out the same with or
+ * without them, which keeps recorded sessions playing back the same.
+ */
+class SFEffects : public SFGameListener {
+public:
+  // capacity is the most particles alive at once, between every kind of effect
+  SFEffects(shared_ptr<SFWindow>, int capacity);
+
+  void Emit(SFEFFECT, const Point2 & where);
+
+  void OnKills(const vector<SFKillEvent> &);
+  void OnPickups(const vector<SFPickupEvent> &);
+
+  void Update();
+  void OnRender();
+
+  int  GetCount() const;
+  long GetDropped() const;
+
+  // The share (0 to 1) of each burst's particles thrown out, always at least one
+  void SetDensity(float);
+
+private:
+  float Random(float lo, float hi);
+
+  shared_ptr<SFWindow>      sf_window;
+  shared_ptr<SFTexture>     texture;
+  vector<SFParticlePool>    pools;     // One for each SFEFFECT
+  vector<SFSprite>          sprites;   // Kept from frame to frame so drawing doesn't allocate
+  uint32_t                  seed;
+  float                     density;
+};
+
+#endif
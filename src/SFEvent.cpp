@@ -33,6 +33,18 @@ SFEvent::SFEvent(const SDL_Event & event) {
         case SDLK_p:
           code = SFEVENT_PAUSE;
           break;
+        // Showing the performance overlay
+        case SDLK_F1:
+          code = SFEVENT_OVERLAY;
+          break;
+        // Switching vsync on or off
+        case SDLK_F2:
+          code = SFEVENT_VSYNC;
+          break;
+        // Any other key does nothing
+        default:
+          code = SFEVENT_NULL;
+          break;
       }
       break;
     // NULL event as there was nothing going on
@@ -9,7 +9,7 @@
  * do not recognise.  SFEVENT_LAST marks the maximal element in the SFEVENT
  * enumeration.  This is a common C/C++ _idiom_.
  */
-enum SFEVENT {SFEVENT_NULL, SFEVENT_QUIT, SFEVENT_PAUSE, SFEVENT_UPDATE, SFEVENT_PLAYER_LEFT, SFEVENT_PLAYER_RIGHT, SFEVENT_PLAYER_UP, SFEVENT_PLAYER_DOWN, SFEVENT_FIRE, SFEVENT_COLLISION, SFEVENT_LAST};
+enum SFEVENT {SFEVENT_NULL, SFEVENT_QUIT, SFEVENT_PAUSE, SFEVENT_UPDATE, SFEVENT_PLAYER_LEFT, SFEVENT_PLAYER_RIGHT, SFEVENT_PLAYER_UP, SFEVENT_PLAYER_DOWN, SFEVENT_FIRE, SFEVENT_COLLISION, SFEVENT_OVERLAY, SFEVENT_VSYNC, SFEVENT_LAST};
 
 /**
  * Abstracts away from SDL_Event so that our game event management needs no SDL-specific code.
@@ -0,0 +1,100 @@
+#include "SFEventBus.h"
+
+// More rounds than this means listeners are setting each other off forever
+static const int SF_MAX_DISPATCH_ROUNDS = 8;
+
+SFEventBus::SFEventBus() : posted(0), batches(0) {
+}
+
+void SFEventBus::Subscribe(SFGameListener * listener) {
+  listeners.push_back(listener);
+}
+
+void SFEventBus::Post(const SFCollisionEvent & e) {
+  collisions.push_back(e);
+  posted++;
+}
+
+void SFEventBus::Post(const SFKillEvent & e) {
+  kills.push_back(e);
+  posted++;
+}
+
+void SFEventBus::Post(const SFPickupEvent & e) {
+  pickups.push_back(e);
+  posted++;
+}
+
+void SFEventBus::Post(const SFScoreEvent & e) {
+  scores.push_back(e);
+  posted++;
+}
+
+void SFEventBus::Post(const SFStageEvent & e) {
+  stages.push_back(e);
+  posted++;
+}
+
+/*********************************************************
+  Sends every queue that has anything in it to all the
+  listeners. Each queue is swapped out before it's sent,
+  so anything posted while sending waits for the next
+  round instead of changing the batch being read. If the
+  rounds run out, what's left goes out next tick.
+*********************************************************/
+void SFEventBus::Dispatch() {
+  for(int round = 0; round < SF_MAX_DISPATCH_ROUNDS; round++) {
+    if(collisions.empty() && kills.empty() && pickups.empty() && scores.empty() && stages.empty()) {
+      return;
+    }
+
+    if(!collisions.empty()) {
+      collisionBatch.swap(collisions);
+      for(auto l : listeners) {
+        l->OnCollisions(collisionBatch);
+      }
+      collisionBatch.clear();
+      batches++;
+    }
+    if(!kills.empty()) {
+      killBatch.swap(kills);
+      for(auto l : listeners) {
+        l->OnKills(killBatch);
+      }
+      killBatch.clear();
+      batches++;
+    }
+    if(!pickups.empty()) {
+      pickupBatch.swap(pickups);
+      for(auto l : listeners) {
+        l->OnPickups(pickupBatch);
+      }
+      pickupBatch.clear();
+      batches++;
+    }
+    if(!scores.empty()) {
+      scoreBatch.swap(scores);
+      for(auto l : listeners) {
+        l->OnScoreChanges(scoreBatch);
+      }
+      scoreBatch.clear();
+      batches++;
+    }
+    if(!stages.empty()) {
+      stageBatch.swap(stages);
+      for(auto l : listeners) {
+        l->OnStageChanges(stageBatch);
+      }
+      stageBatch.clear();
+      batches++;
+    }
+  }
+}
+
+long SFEventBus::GetPosted() const {
+  return posted;
+}
+
+long SFEventBus::GetBatches() const {
+  return batches;
+}
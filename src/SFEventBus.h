@@ -0,0 +1,102 @@
+#ifndef SFEVENTBUS_H
+#define SFEVENTBUS_H
+
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFMath.h"
+#include "SFBroadphase.h"
+
+// Two things the narrow phase says really did collide (a is the lower faction)
+struct SFCollisionEvent {
+  SFAssetId a;
+  SFAssetId b;
+  SFFACTION factionA;
+  SFFACTION factionB;
+};
+
+// An alien died, shot by the player or crashed into them
+struct SFKillEvent {
+  SFAssetId victim;
+  Point2    where;
+  SFFACTION killer;
+};
+
+// The player picked up a coin or a powerup
+struct SFPickupEvent {
+  SFAssetId pickup;
+  bool      powerup;
+  Point2    where;
+};
+
+// The player's score went up or down by change, to score
+struct SFScoreEvent {
+  int score;
+  int change;
+};
+
+// The game moved on to a new stage
+struct SFStageEvent {
+  int stage;
+};
+
+/**
+ * Something that reacts to gameplay events. Each handler gets every
+ * event of its type from the tick at once, and is only called if there
+ * were any, so a listener only overrides the ones it cares about.
+ */
+class SFGameListener {
+public:
+  virtual ~SFGameListener() {}
+
+  virtual void OnCollisions(const vector<SFCollisionEvent> &) {}
+  virtual void OnKills(const vector<SFKillEvent> &) {}
+  virtual void OnPickups(const vector<SFPickupEvent> &) {}
+  virtual void OnScoreChanges(const vector<SFScoreEvent> &) {}
+  virtual void OnStageChanges(const vector<SFStageEvent> &) {}
+};
+
+/**
+ * Collects gameplay events while the world updates and hands them to the
+ * listeners later, in batches, at one point in the tick. Each type has
+ * its own queue, so posting is just adding to the end of a vector, and
+ * the queues keep their memory from tick to tick.
+ *
+ * Listeners can post more events while they're being dispatched to (a
+ * kill changes the score, which can change the stage). Those go out in
+ * another round before Dispatch returns.
+ */
+class SFEventBus {
+public:
+  SFEventBus();
+
+  void Subscribe(SFGameListener *);
+
+  void Post(const SFCollisionEvent &);
+  void Post(const SFKillEvent &);
+  void Post(const SFPickupEvent &);
+  void Post(const SFScoreEvent &);
+  void Post(const SFStageEvent &);
+
+  void Dispatch();
+
+  long GetPosted() const;
+  long GetBatches() const;
+
+private:
+  vector<SFGameListener *>  listeners;
+
+  // Events waiting to go out, and the ones going out in the current round
+  vector<SFCollisionEvent>  collisions, collisionBatch;
+  vector<SFKillEvent>       kills, killBatch;
+  vector<SFPickupEvent>     pickups, pickupBatch;
+  vector<SFScoreEvent>      scores, scoreBatch;
+  vector<SFStageEvent>      stages, stageBatch;
+
+  long                      posted;
+  long                      batches;
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include <algorithm>
+
+#include "SFFlightRecorder.h"
+#include "SFProfiler.h"
+
+SFFlightRecorder::SFFlightRecorder(double hitchMs, int framesBefore, int framesAfter, const string & prefix) :
+  hitchMs(hitchMs), framesAfter(framesAfter), prefix(prefix),
+  ring(framesBefore + framesAfter + 1), next(0), count(0), after(-1), hitchFrame(0), hitchTime(0),
+  hitches(0), dumps(0), dropped(0),
+  dump(ring.size()), dumpCount(0), dumpFrame(0), dumpTime(0), busy(false), stopping(false) {
+  lastFile[0] = '\0';
+  writer = thread(&SFFlightRecorder::Writer, this);
+}
+
+SFFlightRecorder::~SFFlightRecorder() {
+  Flush();
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_one();
+  writer.join();
+}
+
+/*********************************************************
+  A frame is as long as the work in it, or the gap since
+  the last one if something else held it up. The first
+  frame is left out, it has nothing before it to measure
+  the gap from.
+*********************************************************/
+bool SFFlightRecorder::IsHitch(const SFFrameRecord & r) const {
+  double ms = 0.0;
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    ms += r.phaseMs[p];
+  }
+  return hitchMs > 0.0 && r.frame > 1 && max(ms, r.intervalMs) > hitchMs;
+}
+
+/*********************************************************
+  Adds a frame to the ring. A hitch starts a countdown so
+  the frames after it make it into the dump too, and any
+  more hitches before the countdown ends go in the same
+  one.
+*********************************************************/
+void SFFlightRecorder::Record(const SFFrameRecord & r) {
+  ring[next] = r;
+  next = (next + 1) % ring.size();
+  count = min(count + 1, (int) ring.size());
+
+  if(IsHitch(r)) {
+    hitches++;
+    if(after < 0) {
+      after = framesAfter;
+      hitchFrame = r.frame;
+      hitchTime = time(nullptr);
+    }
+  }
+
+  if(after == 0) {
+    Dump();
+  }
+  else if(after > 0) {
+    after--;
+  }
+}
+
+/*********************************************************
+  Hands the ring, oldest frame first, to the writer. The
+  copy goes into a buffer made up front, so this doesn't
+  allocate. If the writer hasn't finished with the last
+  one this hitch is dropped.
+*********************************************************/
+void SFFlightRecorder::Dump() {
+  after = -1;
+
+  lock_guard<mutex> guard(lock);
+  if(busy) {
+    dropped++;
+    return;
+  }
+
+  int size = ring.size();
+  int first = (next - count + size) % size;
+  for(int i = 0; i < count; i++) {
+    dump[i] = ring[(first + i) % size];
+  }
+  dumpCount = count;
+  dumpFrame = hitchFrame;
+  dumpTime  = hitchTime;
+  busy = true;
+  dumps++;
+  wake.notify_one();
+}
+
+// Dumps a hitch still waiting for its later frames, and waits for the writer to finish
+void SFFlightRecorder::Flush() {
+  if(after >= 0) {
+    Dump();
+  }
+  unique_lock<mutex> guard(lock);
+  idle.wait(guard, [this] { return !busy; });
+}
+
+/*********************************************************
+  The writer thread. Sleeps until there's a dump, writes
+  it out and goes back to sleep. The game thread leaves
+  the dump buffer alone while busy is set, so it's read
+  here without holding the lock.
+
+  This never uses operator new, so it doesn't race the
+  allocation counting in SFProfiler when that's built in.
+*********************************************************/
+void SFFlightRecorder::Writer() {
+  while(true) {
+    {
+      unique_lock<mutex> guard(lock);
+      wake.wait(guard, [this] { return busy || stopping; });
+      if(!busy) {
+        return;
+      }
+    }
+
+    char stamp[32];
+    struct tm local;
+    localtime_r(&dumpTime, &local);
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local);
+    char name[sizeof(lastFile)];
+    snprintf(name, sizeof(name), "%s_%s_f%ld.csv", prefix.c_str(), stamp, dumpFrame);
+
+    FILE * out = fopen(name, "w");
+    if(out) {
+      fprintf(out, "frame,hitch,interval_ms");
+      for(int p = 0; p < SFPHASE_LAST; p++) {
+        fprintf(out, ",%s_ms", SFProfiler::GetPhaseName((SFPHASE) p));
+      }
+      fprintf(out, ",allocs,draw_calls,aliens,player_projectiles,enemy_projectiles,coins,powerups,particles,events,timers,pairs\n");
+
+      for(int i = 0; i < dumpCount; i++) {
+        const SFFrameRecord & r = dump[i];
+        fprintf(out, "%ld,%d,%.3f", r.frame, IsHitch(r), r.intervalMs);
+        for(int p = 0; p < SFPHASE_LAST; p++) {
+          fprintf(out, ",%.3f", r.phaseMs[p]);
+        }
+        fprintf(out, ",%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n", r.allocs, r.drawCalls, r.entities.aliens, r.entities.pProjectiles,
+                r.entities.eProjectiles, r.entities.coins, r.entities.powers, r.entities.particles, r.events, r.timers, r.pairs);
+      }
+      fclose(out);
+    }
+
+    {
+      lock_guard<mutex> guard(lock);
+      snprintf(lastFile, sizeof(lastFile), "%s", out ? name : "");
+      busy = false;
+    }
+    idle.notify_all();
+  }
+}
+
+int SFFlightRecorder::GetHitches() const {
+  return hitches;
+}
+
+int SFFlightRecorder::GetDumps() const {
+  return dumps;
+}
+
+int SFFlightRecorder::GetDropped() const {
+  return dropped;
+}
+
+string SFFlightRecorder::GetLastFile() {
+  lock_guard<mutex> guard(lock);
+  return lastFile;
+}
@@ -0,0 +1,93 @@
+#ifndef SFFLIGHTRECORDER_H
+#define SFFLIGHTRECORDER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+
+// Everything the recorder keeps about one frame
+struct SFFrameRecord {
+  long           frame;
+  double         intervalMs;              // Since the end of the frame before
+  double         phaseMs[SFPHASE_LAST];
+  int            allocs;                  // Only counted with -DSF_ALLOC_TRACKING
+  int            drawCalls;
+  SFEntityCounts entities;
+  int            events;                  // Gameplay events posted
+  int            timers;                  // Timers that went off
+  int            pairs;                   // Broadphase pairs
+};
+
+/**
+ * Always keeps the last few seconds of frames in a ring buffer. When a
+ * frame takes longer than the hitch budget, it carries on recording for
+ * a little while and then hands everything around the hitch to a writer
+ * thread, which saves it as sf_hitch_<date>_<time>_f<frame>.csv.
+ *
+ * Nothing on the game thread allocates or touches a file: the ring and
+ * the buffer handed to the writer are made up front, and if the writer is
+ * still busy with the last hitch the new one is dropped (and counted)
+ * rather than waited for.
+ */
+class SFFlightRecorder {
+public:
+  SFFlightRecorder(double hitchMs, int framesBefore = 180, int framesAfter = 60, const string & prefix = "sf_hitch");
+  virtual ~SFFlightRecorder();
+
+  void     Record(const SFFrameRecord &);
+  void     Flush();
+
+  int      GetHitches() const;
+  int      GetDumps() const;
+  int      GetDropped() const;
+  string   GetLastFile();
+
+private:
+  SFFlightRecorder(const SFFlightRecorder &);
+  SFFlightRecorder & operator=(const SFFlightRecorder &);
+
+  void     Dump();
+  void     Writer();
+  bool     IsHitch(const SFFrameRecord &) const;
+
+  double                hitchMs;
+  int                   framesAfter;
+  string                prefix;
+
+  // The ring: next is where the next frame goes, count how many it holds
+  vector<SFFrameRecord> ring;
+  int                   next;
+  int                   count;
+
+  // Frames still to record before the current hitch is dumped (-1 when there isn't one)
+  int                   after;
+  long                  hitchFrame;
+  time_t                hitchTime;
+
+  int                   hitches;
+  int                   dumps;
+  int                   dropped;
+
+  // Shared with the writer thread
+  mutex                 lock;
+  condition_variable    wake;
+  condition_variable    idle;
+  vector<SFFrameRecord> dump;
+  int                   dumpCount;
+  long                  dumpFrame;
+  time_t                dumpTime;
+  bool                  busy;
+  bool                  stopping;
+  char                  lastFile[256];
+  thread                writer;
+};
+
+#endif
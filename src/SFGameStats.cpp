@@ -0,0 +1,61 @@
+#include <algorithm>
+
+#include "SFGameStats.h"
+
+SFGameStats::SFGameStats() : kills(0), crashes(0), coins(0), powerups(0), bestScore(0), collisions(0) {
+}
+
+void SFGameStats::OnCollisions(const vector<SFCollisionEvent> & events) {
+  collisions += events.size();
+}
+
+void SFGameStats::OnKills(const vector<SFKillEvent> & events) {
+  kills += events.size();
+  for(auto & e : events) {
+    if(e.killer == SFFACTION_PLAYER) {
+      crashes++;
+    }
+  }
+}
+
+void SFGameStats::OnPickups(const vector<SFPickupEvent> & events) {
+  for(auto & e : events) {
+    (e.powerup ? powerups : coins)++;
+  }
+}
+
+void SFGameStats::OnScoreChanges(const vector<SFScoreEvent> & events) {
+  for(auto & e : events) {
+    bestScore = max(bestScore, e.score);
+  }
+}
+
+int SFGameStats::GetKills() const {
+  return kills;
+}
+
+int SFGameStats::GetCrashes() const {
+  return crashes;
+}
+
+int SFGameStats::GetCoins() const {
+  return coins;
+}
+
+int SFGameStats::GetPowerups() const {
+  return powerups;
+}
+
+int SFGameStats::GetBestScore() const {
+  return bestScore;
+}
+
+long SFGameStats::GetCollisions() const {
+  return collisions;
+}
+
+ostream& operator<<(ostream& os, const SFGameStats& obj) {
+  os << "Enemies Killed: " << obj.GetKills() << " (" << obj.GetCrashes() << " crashed into) | Coins Collected: " << obj.GetCoins()
+     << " | Powerups Collected: " << obj.GetPowerups() << " | Best Score: " << obj.GetBestScore();
+  return os;
+}
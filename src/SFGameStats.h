@@ -0,0 +1,41 @@
+#ifndef SFGAMESTATS_H
+#define SFGAMESTATS_H
+
+#include <ostream>
+
+using namespace std;
+
+#include "SFEventBus.h"
+
+/**
+ * Keeps the statistics shown at the end of a game by listening to the
+ * event bus, so none of the gameplay code has to count anything itself.
+ */
+class SFGameStats : public SFGameListener {
+public:
+  SFGameStats();
+
+  void OnCollisions(const vector<SFCollisionEvent> &);
+  void OnKills(const vector<SFKillEvent> &);
+  void OnPickups(const vector<SFPickupEvent> &);
+  void OnScoreChanges(const vector<SFScoreEvent> &);
+
+  int  GetKills() const;
+  int  GetCrashes() const;
+  int  GetCoins() const;
+  int  GetPowerups() const;
+  int  GetBestScore() const;
+  long GetCollisions() const;
+
+private:
+  int  kills;       // Every alien that died, shot or crashed into
+  int  crashes;     // The ones that died crashing into the player
+  int  coins;
+  int  powerups;
+  int  bestScore;
+  long collisions;
+};
+
+ostream& operator<<(ostream &, const SFGameStats &);
+
+#endif
@@ -0,0 +1,103 @@
+#include <algorithm>
+
+#include "SFGovernor.h"
+
+SFGovernor::SFGovernor(double budgetMs, int window, double upShare) : budgetMs(budgetMs), window(max(window, 1)), upShare(upShare),
+  times(max(window, 1), 0.0), scratch(max(window, 1), 0.0), next(0), filled(0),
+  quality(SFQUALITY_HIGH), sinceChange(0), upWait(2 * max(window, 1)), lastUp(false), p90(0.0), changes(0) {
+  fill(frames, frames + SFQUALITY_LAST, 0L);
+}
+
+/*********************************************************
+  Only decides once the window is full of frames at this
+  quality, so what it's looking at is what this quality
+  costs.
+*********************************************************/
+bool SFGovernor::AddFrame(double ms) {
+  frames[quality]++;
+  sinceChange++;
+  if(budgetMs <= 0.0) {
+    return false;
+  }
+
+  times[next] = ms;
+  next = (next + 1) % window;
+  filled = min(filled + 1, window);
+  if(filled < window) {
+    return false;
+  }
+
+  copy(times.begin(), times.end(), scratch.begin());
+  int rank = (window - 1) * 9 / 10;
+  nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+  p90 = scratch[rank];
+
+  if(p90 > budgetMs && quality > SFQUALITY_LOW) {
+    // Stepping down again soon after a step up: wait longer before trying the step up again
+    if(lastUp) {
+      upWait = min(upWait * 2, 32L * window);
+    }
+    lastUp = false;
+    Change((SFQUALITY) (quality - 1));
+    return true;
+  }
+  if(p90 < budgetMs * upShare && quality < SFQUALITY_HIGH && sinceChange >= upWait) {
+    lastUp = true;
+    Change((SFQUALITY) (quality + 1));
+    return true;
+  }
+  return false;
+}
+
+void SFGovernor::Change(SFQUALITY to) {
+  quality = to;
+  sinceChange = 0;
+  filled = 0;
+  next = 0;
+  changes++;
+}
+
+SFQUALITY SFGovernor::GetQuality() const {
+  return quality;
+}
+
+double SFGovernor::GetBudgetMs() const {
+  return budgetMs;
+}
+
+double SFGovernor::GetP90Ms() const {
+  return p90;
+}
+
+long SFGovernor::GetChanges() const {
+  return changes;
+}
+
+long SFGovernor::GetFrames(SFQUALITY q) const {
+  return frames[q];
+}
+
+const char * SFGovernor::GetName(SFQUALITY q) {
+  switch(q) {
+    case SFQUALITY_LOW:    return "low";
+    case SFQUALITY_MEDIUM: return "medium";
+    case SFQUALITY_HIGH:   return "high";
+    default:               return "?";
+  }
+}
+
+ostream& operator<<(ostream& os, const SFGovernor& obj) {
+  if(obj.GetBudgetMs() <= 0.0) {
+    return os << "off";
+  }
+  long total = 0;
+  for(int q = 0; q < SFQUALITY_LAST; q++) {
+    total += obj.GetFrames((SFQUALITY) q);
+  }
+  os << "budget " << obj.GetBudgetMs() << " ms | quality " << SFGovernor::GetName(obj.GetQuality()) << " | frames at";
+  for(int q = SFQUALITY_LAST - 1; q >= 0; q--) {
+    os << " " << SFGovernor::GetName((SFQUALITY) q) << " " << (total ? 100 * obj.GetFrames((SFQUALITY) q) / total : 0) << "%";
+  }
+  os << " | " << obj.GetChanges() << " change(s) | last p90 " << obj.GetP90Ms() << " ms";
+  return os;
+}
@@ -0,0 +1,67 @@
+#ifndef SFGOVERNOR_H
+#define SFGOVERNOR_H
+
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+
+/**
+ * Picks how much optional work (see SFQUALITY) a frame can afford, so a
+ * slow machine at a hard stage stays inside its frame budget. It keeps how
+ * long the last window frames took to update and draw and looks at their
+ * 90th percentile, so one slow frame doesn't count but a run of them does:
+ * over the budget it steps quality down a level, and under upShare of the
+ * budget for long enough it steps back up.
+ *
+ * Two things stop it flipping back and forth (hysteresis): the gap between
+ * the two thresholds, and that it waits for a whole window of frames at the
+ * new level before deciding again. A step up waits twice as long, and
+ * twice as long again every time a step up had to be taken back.
+ *
+ * Only what doesn't change the game should be left to it, so a recorded
+ * session plays back the same whatever it decides.
+ */
+class SFGovernor {
+public:
+  // budgetMs of 0 turns it off, leaving quality high
+  SFGovernor(double budgetMs, int window = 60, double upShare = 0.6);
+
+  // How long the frame just finished took. True if the quality changed.
+  bool       AddFrame(double ms);
+
+  SFQUALITY  GetQuality() const;
+  double     GetBudgetMs() const;
+  double     GetP90Ms() const;       // Of the last full window
+  long       GetChanges() const;
+  long       GetFrames(SFQUALITY) const;
+
+  static const char * GetName(SFQUALITY);
+
+private:
+  void       Change(SFQUALITY);
+
+  double          budgetMs;
+  int             window;
+  double          upShare;
+
+  vector<double>  times;             // The window, round and round from next
+  vector<double>  scratch;           // For finding the percentile without allocating
+  int             next;
+  int             filled;
+
+  SFQUALITY       quality;
+  long            sinceChange;       // Frames at this quality
+  long            upWait;            // Frames to wait before a step up
+  bool            lastUp;            // The last change was a step up
+
+  double          p90;
+  long            changes;
+  long            frames[SFQUALITY_LAST];
+};
+
+ostream& operator<<(ostream &, const SFGovernor &);
+
+#endif
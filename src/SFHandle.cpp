@@ -0,0 +1,84 @@
+#include "SFCommon.h"
+#include "SFHandle.h"
+
+SFHandleTable::SFHandleTable() : freeHead(-1), freeTail(-1), live(0) {
+}
+
+/*********************************************************
+  Takes the free slot that has waited longest, or a new one
+  if none are free. Throws SF_ERROR_HANDLES if all
+  SF_HANDLE_MAX slots are in use.
+*********************************************************/
+SFHandle SFHandleTable::Create(void * object) {
+  int index;
+  if(freeHead != -1) {
+    index = freeHead;
+    freeHead = slots[index].nextFree;
+    if(freeHead == -1) {
+      freeTail = -1;
+    }
+  }
+  else {
+    if(slots.size() >= SF_HANDLE_MAX) {
+      throw SF_ERROR_HANDLES;
+    }
+    Slot slot = { nullptr, 1, false, -1 };
+    slots.push_back(slot);
+    index = slots.size() - 1;
+  }
+
+  Slot & slot = slots[index];
+  slot.object = object;
+  slot.used   = true;
+  live++;
+  return ((SFHandle) slot.generation << SF_HANDLE_BITS) | index;
+}
+
+/*********************************************************
+  Frees the slot and moves its generation on, so every
+  copy of the handle goes stale at once. Destroying a stale
+  or null handle does nothing.
+*********************************************************/
+void SFHandleTable::Destroy(SFHandle h) {
+  if(!IsValid(h)) {
+    return;
+  }
+
+  int index = SFHandleIndex(h);
+  Slot & slot = slots[index];
+  slot.object = nullptr;
+  slot.used   = false;
+  slot.nextFree = -1;
+
+  // Skip 0 when the generation wraps so a null handle can never match
+  if(++slot.generation == 0) {
+    slot.generation = 1;
+  }
+
+  if(freeTail != -1) {
+    slots[freeTail].nextFree = index;
+  }
+  else {
+    freeHead = index;
+  }
+  freeTail = index;
+  live--;
+}
+
+// nullptr if the handle is null or its object has gone
+void * SFHandleTable::Get(SFHandle h) const {
+  return IsValid(h) ? slots[SFHandleIndex(h)].object : nullptr;
+}
+
+bool SFHandleTable::IsValid(SFHandle h) const {
+  uint32_t index = SFHandleIndex(h);
+  return index < slots.size() && slots[index].used && slots[index].generation == SFHandleGeneration(h);
+}
+
+int SFHandleTable::GetLive() const {
+  return live;
+}
+
+int SFHandleTable::GetCapacity() const {
+  return slots.size();
+}
@@ -0,0 +1,69 @@
+#ifndef SFHANDLE_H
+#define SFHANDLE_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A 32 bit reference to something in an SFHandleTable. The low 22 bits
+ * are the slot it lives in and the high 10 bits are that slot's
+ * generation, which changes every time the slot is freed. A handle kept
+ * after its object went away still points at the slot, but with the old
+ * generation, so looking it up gives nullptr instead of whatever took the
+ * slot over.
+ *
+ * Generation 0 is never handed out, so 0 is always a null handle.
+ */
+typedef uint32_t SFHandle;
+
+const SFHandle SF_NULL_HANDLE        = 0;
+const int      SF_HANDLE_BITS        = 22;                              // Of the slot
+const uint32_t SF_HANDLE_MAX         = 1u << SF_HANDLE_BITS;            // Most slots a table can have
+const uint32_t SF_HANDLE_GENERATIONS = 1u << (32 - SF_HANDLE_BITS);     // Before a slot's generation wraps
+
+inline uint32_t SFHandleIndex(SFHandle h) {
+  return h & (SF_HANDLE_MAX - 1);
+}
+
+inline uint32_t SFHandleGeneration(SFHandle h) {
+  return h >> SF_HANDLE_BITS;
+}
+
+/**
+ * Hands out handles and turns them back into pointers in O(1).
+ *
+ * Free slots are kept in a first in, first out list threaded through the
+ * slots themselves, so a freed slot goes to the back of the queue and
+ * takes as long as possible to come round again. That keeps the 10 bit
+ * generation from wrapping onto a handle something still holds, and means
+ * creating and destroying never allocates once the table has grown.
+ */
+class SFHandleTable {
+public:
+  SFHandleTable();
+
+  SFHandle    Create(void * object);
+  void        Destroy(SFHandle);
+  void *      Get(SFHandle) const;
+  bool        IsValid(SFHandle) const;
+
+  int         GetLive() const;
+  int         GetCapacity() const;
+
+private:
+  struct Slot {
+    void    * object;
+    uint32_t  generation : 32 - SF_HANDLE_BITS;  // Wraps at SF_HANDLE_GENERATIONS, as in the handle
+    bool      used;
+    int       nextFree;
+  };
+
+  vector<Slot> slots;
+  int          freeHead;
+  int          freeTail;
+  int          live;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#include <SDL2/SDL.h>
+
+#include "SFInput.h"
+#include "SFInputQueue.h"
+
+/*********************************************************
+  Called by SDL for every event it reads. Returns 1 so the
+  event still goes on to SDL's own queue (the game still
+  wants quit, pause and the overlay key from there).
+*********************************************************/
+static int OnKey(void * data, SDL_Event * event) {
+  if(event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) {
+    return 1;
+  }
+
+  SFKEY key;
+  switch(event->key.keysym.scancode) {
+    case SDL_SCANCODE_UP:    case SDL_SCANCODE_W: key = SFKEY_UP;    break;
+    case SDL_SCANCODE_DOWN:  case SDL_SCANCODE_S: key = SFKEY_DOWN;  break;
+    case SDL_SCANCODE_LEFT:  case SDL_SCANCODE_A: key = SFKEY_LEFT;  break;
+    case SDL_SCANCODE_RIGHT: case SDL_SCANCODE_D: key = SFKEY_RIGHT; break;
+    case SDL_SCANCODE_SPACE:                      key = SFKEY_FIRE;  break;
+    default:
+      return 1;
+  }
+
+  SFKeyEvent e;
+  e.time   = SDL_GetPerformanceCounter();
+  e.key    = key;
+  e.down   = event->type == SDL_KEYDOWN;
+  e.repeat = event->key.repeat != 0;
+  static_cast<SFInputQueue *>(data)->Push(e);
+  return 1;
+}
+
+SFKeyWatch::SFKeyWatch(SFInputQueue & queue) : queue(queue) {
+  SDL_AddEventWatch(OnKey, &queue);
+}
+
+SFKeyWatch::~SFKeyWatch() {
+  SDL_DelEventWatch(OnKey, &queue);
+}
@@ -0,0 +1,48 @@
+#ifndef SFINPUT_H
+#define SFINPUT_H
+
+class SFInputQueue;
+
+/**
+ * What the player is doing in one frame: which way they're holding and how
+ * many times fire was pressed since the last frame. The game only moves
+ * the player from one of these, so it doesn't matter if it came from the
+ * keyboard or from a recorded session (see SFSession.h).
+ */
+struct SFInputState {
+  bool up    = false;
+  bool down  = false;
+  bool left  = false;
+  bool right = false;
+  int  fires = 0;
+
+  bool operator==(const SFInputState & o) const {
+    return up == o.up && down == o.down && left == o.left && right == o.right && fires == o.fires;
+  }
+  bool operator!=(const SFInputState & o) const {
+    return !(*this == o);
+  }
+};
+
+/**
+ * Puts every press and release of the arrow keys, WASD and space on a
+ * queue (see SFInputQueue.h) as SDL reads it from the system, stamped with
+ * when it was read. SDL calls the watch while it pumps events, before they
+ * join the event queue, so a key doesn't wait behind the update events
+ * already queued before the tick can see it.
+ *
+ * The watch is removed again when this goes away.
+ */
+class SFKeyWatch {
+public:
+  SFKeyWatch(SFInputQueue &);
+  ~SFKeyWatch();
+
+private:
+  SFKeyWatch(const SFKeyWatch &);
+  SFKeyWatch & operator=(const SFKeyWatch &);
+
+  SFInputQueue & queue;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include <algorithm>
+
+#include "SFInputQueue.h"
+
+SFInputQueue::SFInputQueue(int capacity) : head(0), tail(0), dropped(0) {
+  size_t size = 1;
+  while(size < (size_t) max(capacity, 1)) {
+    size *= 2;
+  }
+  ring.resize(size);
+  mask = size - 1;
+}
+
+bool SFInputQueue::Push(const SFKeyEvent & event) {
+  size_t t = tail.load(memory_order_relaxed);
+  if(t - head.load(memory_order_acquire) == ring.size()) {
+    dropped.fetch_add(1, memory_order_relaxed);
+    return false;
+  }
+  ring[t & mask] = event;
+  tail.store(t + 1, memory_order_release);
+  return true;
+}
+
+bool SFInputQueue::Pop(SFKeyEvent & event) {
+  size_t h = head.load(memory_order_relaxed);
+  if(h == tail.load(memory_order_acquire)) {
+    return false;
+  }
+  event = ring[h & mask];
+  head.store(h + 1, memory_order_release);
+  return true;
+}
+
+int SFInputQueue::GetCapacity() const {
+  return ring.size();
+}
+
+long SFInputQueue::GetDropped() const {
+  return dropped.load(memory_order_relaxed);
+}
+
+SFInputTracker::SFInputTracker(uint64_t frequency) : frequency(frequency ? frequency : 1), events(0), totalWaitMs(0.0), worstWaitMs(0.0) {
+  fill(held, held + SFKEY_LAST, 0);
+  arrivals.reserve(256);
+}
+
+/*********************************************************
+  Holds a direction for the tick if it's down now or was
+  pressed at any point since the last tick. A release with
+  no press before it (the key was down before the game
+  started watching) is ignored.
+*********************************************************/
+SFInputState SFInputTracker::Tick(SFInputQueue & queue, uint64_t now) {
+  bool pressed[SFKEY_LAST] = { false };
+  SFInputState input;
+  arrivals.clear();
+
+  SFKeyEvent e;
+  while(queue.Pop(e)) {
+    events++;
+    double waitMs = now > e.time ? (now - e.time) * 1000.0 / frequency : 0.0;
+    totalWaitMs += waitMs;
+    worstWaitMs = max(worstWaitMs, waitMs);
+
+    if(e.key == SFKEY_FIRE) {
+      if(e.down) {
+        input.fires++;
+        arrivals.push_back(e.time);
+      }
+      continue;
+    }
+    if(e.repeat) {
+      continue;
+    }
+    arrivals.push_back(e.time);
+    if(e.down) {
+      held[e.key]++;
+      pressed[e.key] = true;
+    }
+    else {
+      held[e.key] = max(held[e.key] - 1, 0);
+    }
+  }
+
+  input.up    = held[SFKEY_UP] > 0    || pressed[SFKEY_UP];
+  input.down  = held[SFKEY_DOWN] > 0  || pressed[SFKEY_DOWN];
+  input.left  = held[SFKEY_LEFT] > 0  || pressed[SFKEY_LEFT];
+  input.right = held[SFKEY_RIGHT] > 0 || pressed[SFKEY_RIGHT];
+  return input;
+}
+
+const vector<uint64_t> & SFInputTracker::GetArrivals() const {
+  return arrivals;
+}
+
+long SFInputTracker::GetEvents() const {
+  return events;
+}
+
+double SFInputTracker::GetMeanWaitMs() const {
+  return events ? totalWaitMs / events : 0.0;
+}
+
+double SFInputTracker::GetWorstWaitMs() const {
+  return worstWaitMs;
+}
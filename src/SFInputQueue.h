@@ -0,0 +1,95 @@
+#ifndef SFINPUTQUEUE_H
+#define SFINPUTQUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFInput.h"
+
+// One press or release of a key the game reads, stamped with the performance counter when it was read
+struct SFKeyEvent {
+  uint64_t time;
+  SFKEY    key;
+  bool     down;
+  bool     repeat;     // A press the keyboard repeated because the key's held down
+};
+
+/**
+ * A fixed size ring of key events from one thread (the producer, whoever
+ * reads the keyboard) to another (the consumer, the start of each tick),
+ * with no locks: each side only writes its own end of the ring and reads
+ * the other's, and the release/acquire pair on each end makes the event
+ * visible before the end that says it's there. Push never waits or
+ * allocates; if the ring is full the event is dropped and counted.
+ *
+ * Only one thread may Push and only one may Pop.
+ */
+class SFInputQueue {
+public:
+  // capacity is rounded up to a power of two
+  SFInputQueue(int capacity = 256);
+
+  bool     Push(const SFKeyEvent &);
+  bool     Pop(SFKeyEvent &);
+
+  int      GetCapacity() const;
+  long     GetDropped() const;
+
+private:
+  SFInputQueue(const SFInputQueue &);
+  SFInputQueue & operator=(const SFInputQueue &);
+
+  vector<SFKeyEvent>          ring;
+  size_t                      mask;
+
+  // Padded onto cache lines of their own, so the two threads don't keep taking the same line off each
+  // other (padded rather than alignas, which C++11's new doesn't honour for the SFApp this lives in)
+  char                        padHead[64];
+  atomic<size_t>              head;      // The next to Pop, only written by the consumer
+  char                        padTail[64 - sizeof(atomic<size_t>)];
+  atomic<size_t>              tail;      // The next to Push, only written by the producer
+  char                        padDropped[64 - sizeof(atomic<size_t>)];
+  atomic<long>                dropped;
+};
+
+/**
+ * Turns the key events queued since the last tick into the tick's
+ * SFInputState. Events are applied in order, so nothing between ticks is
+ * lost: a direction tapped and let go again still counts as held for the
+ * tick, and every press of fire (including the keyboard's repeats, which
+ * is how holding it down keeps firing) is counted.
+ *
+ * Two keys for the same direction (an arrow and WASD) can be held at once,
+ * so a direction is held until both are let go.
+ */
+class SFInputTracker {
+public:
+  // frequency is the performance counter's ticks a second, for GetMeanWaitMs and GetWorstWaitMs
+  SFInputTracker(uint64_t frequency);
+
+  // now is the performance counter at the start of the tick
+  SFInputState Tick(SFInputQueue &, uint64_t now);
+
+  // When the events the last Tick acted on were read (not a direction's repeats, which change nothing)
+  const vector<uint64_t> & GetArrivals() const;
+
+  long     GetEvents() const;
+  // How long events waited in the queue for a tick to take them
+  double   GetMeanWaitMs() const;
+  double   GetWorstWaitMs() const;
+
+private:
+  double   frequency;
+  int      held[SFKEY_LAST];     // How many keys for each are down
+  vector<uint64_t> arrivals;
+
+  long     events;
+  double   totalWaitMs;
+  double   worstWaitMs;
+};
+
+#endif
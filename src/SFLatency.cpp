@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <iomanip>
+
+#include "SFLatency.h"
+
+SFLatencyHistogram::SFLatencyHistogram() : count(0), totalMs(0.0), worstMs(0.0) {
+  fill(buckets, buckets + SF_LATENCY_BUCKETS + 1, 0L);
+}
+
+void SFLatencyHistogram::Add(double ms) {
+  ms = max(ms, 0.0);
+  buckets[min((int) ms, (int) SF_LATENCY_BUCKETS)]++;
+  count++;
+  totalMs += ms;
+  worstMs = max(worstMs, ms);
+}
+
+long SFLatencyHistogram::GetCount() const {
+  return count;
+}
+
+long SFLatencyHistogram::GetBucket(int ms) const {
+  return ms >= 0 && ms <= SF_LATENCY_BUCKETS ? buckets[ms] : 0;
+}
+
+double SFLatencyHistogram::GetMeanMs() const {
+  return count ? totalMs / count : 0.0;
+}
+
+double SFLatencyHistogram::GetWorstMs() const {
+  return worstMs;
+}
+
+double SFLatencyHistogram::GetPercentileMs(double p) const {
+  long wanted = max(1L, (long) (p * count + 0.999999)), seen = 0;
+  for(int i = 0; i < SF_LATENCY_BUCKETS && count; i++) {
+    seen += buckets[i];
+    if(seen >= wanted) {
+      return min((double) (i + 1), worstMs);
+    }
+  }
+  return worstMs;
+}
+
+void SFLatencyHistogram::Print(ostream & os, const char * indent) const {
+  os << fixed << setprecision(1);
+  os << indent << count << " input(s) | mean " << GetMeanMs() << " ms | p50 " << GetPercentileMs(0.50)
+     << " | p95 " << GetPercentileMs(0.95) << " | p99 " << GetPercentileMs(0.99) << " | worst " << worstMs << endl;
+
+  long widest = 0;
+  for(int i = 0; i <= SF_LATENCY_BUCKETS; i += 4) {
+    long n = 0;
+    for(int k = i; k < i + 4 && k <= SF_LATENCY_BUCKETS; k++) {
+      n += buckets[k];
+    }
+    widest = max(widest, n);
+  }
+  for(int i = 0; i <= SF_LATENCY_BUCKETS; i += 4) {
+    long n = 0;
+    for(int k = i; k < i + 4 && k <= SF_LATENCY_BUCKETS; k++) {
+      n += buckets[k];
+    }
+    if(n == 0) {
+      continue;
+    }
+    os << indent << setw(3) << i;
+    if(i < SF_LATENCY_BUCKETS) {
+      os << "-" << setw(4) << left << i + 4 << right;
+    }
+    else {
+      os << "+    ";
+    }
+    os << "ms " << string(max(1L, n * 40 / widest), '#') << " " << n << endl;
+  }
+  os << defaultfloat << setprecision(6);
+}
+
+SFLatencyTracer::SFLatencyTracer(uint64_t frequency) : frequency(frequency ? frequency : 1), presenting(0) {
+  pending.reserve(256);
+  fill(queueMs, queueMs + SFPRESENT_LAST, 0.0);
+  fill(frameMs, frameMs + SFPRESENT_LAST, 0.0);
+  fill(presentMs, presentMs + SFPRESENT_LAST, 0.0);
+}
+
+double SFLatencyTracer::Ms(uint64_t from, uint64_t to) const {
+  return to > from ? (to - from) * 1000.0 / frequency : 0.0;
+}
+
+void SFLatencyTracer::Consume(const vector<uint64_t> & arrivals, uint64_t now) {
+  for(size_t i = 0; i < arrivals.size(); i++) {
+    Tag tag = { arrivals[i], now };
+    pending.push_back(tag);
+  }
+}
+
+void SFLatencyTracer::Presenting(uint64_t now) {
+  presenting = now;
+}
+
+/*********************************************************
+  Everything consumed before this present is on screen
+  now. If Presenting wasn't called first the present
+  counts as taking no time.
+*********************************************************/
+void SFLatencyTracer::Presented(SFPRESENT mode, uint64_t now) {
+  uint64_t before = presenting ? presenting : now;
+  for(size_t i = 0; i < pending.size(); i++) {
+    const Tag & tag = pending[i];
+    histograms[mode].Add(Ms(tag.arrival, now));
+    queueMs[mode]   += Ms(tag.arrival, tag.consumed);
+    frameMs[mode]   += Ms(tag.consumed, before);
+    presentMs[mode] += Ms(before, now);
+  }
+  pending.clear();
+  presenting = 0;
+}
+
+int SFLatencyTracer::GetPending() const {
+  return pending.size();
+}
+
+const SFLatencyHistogram & SFLatencyTracer::GetHistogram(SFPRESENT mode) const {
+  return histograms[mode];
+}
+
+double SFLatencyTracer::GetQueueMs(SFPRESENT mode) const {
+  long n = histograms[mode].GetCount();
+  return n ? queueMs[mode] / n : 0.0;
+}
+
+double SFLatencyTracer::GetFrameMs(SFPRESENT mode) const {
+  long n = histograms[mode].GetCount();
+  return n ? frameMs[mode] / n : 0.0;
+}
+
+double SFLatencyTracer::GetPresentMs(SFPRESENT mode) const {
+  long n = histograms[mode].GetCount();
+  return n ? presentMs[mode] / n : 0.0;
+}
+
+const char * SFLatencyTracer::GetName(SFPRESENT mode) {
+  switch(mode) {
+    case SFPRESENT_IMMEDIATE: return "immediate";
+    case SFPRESENT_VSYNC:     return "vsync";
+    default:                  return "?";
+  }
+}
+
+void SFLatencyTracer::Print(ostream & os) const {
+  bool any = false;
+  for(int m = 0; m < SFPRESENT_LAST; m++) {
+    SFPRESENT mode = (SFPRESENT) m;
+    if(histograms[mode].GetCount() == 0) {
+      continue;
+    }
+    any = true;
+    os << "  " << GetName(mode) << ": " << fixed << setprecision(1) << GetQueueMs(mode) << " ms queued + "
+       << GetFrameMs(mode) << " ms update and render + " << GetPresentMs(mode) << " ms present (means)"
+       << defaultfloat << setprecision(6) << endl;
+    histograms[mode].Print(os, "    ");
+  }
+  if(!any) {
+    os << "  no key presses reached the screen" << endl;
+  }
+}
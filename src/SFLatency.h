@@ -0,0 +1,97 @@
+#ifndef SFLATENCY_H
+#define SFLATENCY_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+
+/**
+ * Counts of times in 1 ms buckets up to SF_LATENCY_BUCKETS ms, and one
+ * bucket for anything longer, so percentiles come out to the millisecond
+ * without keeping every sample.
+ */
+class SFLatencyHistogram {
+public:
+  static const int SF_LATENCY_BUCKETS = 100;
+
+  SFLatencyHistogram();
+
+  void     Add(double ms);
+
+  long     GetCount() const;
+  long     GetBucket(int ms) const;    // ms up to SF_LATENCY_BUCKETS, which is the longer ones
+  double   GetMeanMs() const;
+  double   GetWorstMs() const;
+  // The top of the bucket p (0 to 1) of the samples are in, or the worst if that's sooner
+  double   GetPercentileMs(double p) const;
+
+  // The percentiles, then a bar for every 4 ms that has any samples
+  void     Print(ostream &, const char * indent) const;
+
+private:
+  long     buckets[SF_LATENCY_BUCKETS + 1];
+  long     count;
+  double   totalMs;
+  double   worstMs;
+};
+
+/**
+ * Follows key presses and releases (see SFInputQueue.h) from when SDL read
+ * them to when the first frame drawn after a tick used them has been
+ * presented, which is as close to the screen as the game can see. Each
+ * input is tagged with when it was read, the tag is kept through the
+ * update that consumed it and the render after, and when Present returns
+ * it lands in the histogram of the presentation mode the frame was shown
+ * in. A frame cap that skips a present keeps the tags for the next one.
+ *
+ * Along with the whole time it keeps the three stages of it: waiting for a
+ * tick, the tick's update and render, and Present itself (which is where
+ * vsync waits).
+ *
+ * Times are the performance counter's, in ticks of frequency a second.
+ */
+class SFLatencyTracer {
+public:
+  SFLatencyTracer(uint64_t frequency);
+
+  // The update that started at now took the inputs read at these times
+  void     Consume(const vector<uint64_t> & arrivals, uint64_t now);
+  // Just before and just after Present, in the given mode
+  void     Presenting(uint64_t now);
+  void     Presented(SFPRESENT, uint64_t now);
+
+  int      GetPending() const;
+  const SFLatencyHistogram & GetHistogram(SFPRESENT) const;
+  // The means of each stage, in ms
+  double   GetQueueMs(SFPRESENT) const;
+  double   GetFrameMs(SFPRESENT) const;
+  double   GetPresentMs(SFPRESENT) const;
+
+  static const char * GetName(SFPRESENT);
+
+  // A histogram for each mode that presented any inputs
+  void     Print(ostream &) const;
+
+private:
+  double   Ms(uint64_t from, uint64_t to) const;
+
+  struct Tag {
+    uint64_t arrival;
+    uint64_t consumed;
+  };
+
+  double              frequency;
+  vector<Tag>         pending;
+  uint64_t            presenting;
+
+  SFLatencyHistogram  histograms[SFPRESENT_LAST];
+  double              queueMs[SFPRESENT_LAST];
+  double              frameMs[SFPRESENT_LAST];
+  double              presentMs[SFPRESENT_LAST];
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include <iostream>
+
+#include "SFLayerCache.h"
+#include "SFProfiler.h"
+
+SFLayerCache::SFLayerCache(shared_ptr<SFWindow> window) : sf_window(window), colour(SFRgba(0, 0, 0)) {
+  for(auto & layer : layers) {
+    layer = Layer { false, false, true, 0, 0, nullptr, 0, 0 };
+  }
+}
+
+void SFLayerCache::Cache(SFLAYER id, int w, int h, bool opaque) {
+  Layer & layer = layers[id];
+  layer.cached  = true;
+  layer.opaque  = opaque;
+  layer.dirty   = true;
+  layer.w       = w;
+  layer.h       = h;
+  layer.texture = nullptr;
+}
+
+void SFLayerCache::MarkDirty(SFLAYER id) {
+  layers[id].dirty = true;
+}
+
+/*********************************************************
+  Copies a clean layer onto the screen, or points the
+  renderer at the layer's texture, cleared, for drawing a
+  dirty one. The texture is made the first time the layer
+  is drawn. If it can't be, the layer stops being cached
+  and is drawn onto the screen from then on.
+*********************************************************/
+bool SFLayerCache::Begin(SFLAYER id) {
+  Layer & layer = layers[id];
+  SFRenderer * renderer = sf_window->getRenderer();
+
+  if(layer.cached && !layer.texture) {
+    SFTexture * texture = renderer->CreateTarget(layer.w, layer.h);
+    if(!texture) {
+      cerr << "Could not make a texture for the " << GetName(id) << " layer, drawing it every frame" << endl;
+      layer.cached = false;
+    }
+    else {
+      renderer->SetBlend(texture, layer.opaque ? SFBLEND_ALPHA : SFBLEND_PREMULTIPLIED);
+      layer.texture = SFRenderer::Counted(texture);
+      layer.dirty = true;
+    }
+  }
+
+  if(!layer.cached) {
+    layer.draws++;
+    return true;
+  }
+  if(!layer.dirty) {
+    layer.hits++;
+    Present(layer);
+    return false;
+  }
+
+  layer.draws++;
+  renderer->SetTarget(layer.texture.get());
+  colour = renderer->GetDrawColour();
+  renderer->SetDrawColour(0, 0, 0, layer.opaque ? 255 : 0);
+  renderer->Clear();
+  return true;
+}
+
+void SFLayerCache::End(SFLAYER id) {
+  Layer & layer = layers[id];
+  if(!layer.cached) {
+    return;
+  }
+
+  SFRenderer * renderer = sf_window->getRenderer();
+  renderer->SetTarget(nullptr);
+  renderer->RestoreDrawColour(colour);
+  layer.dirty = false;
+  Present(layer);
+}
+
+void SFLayerCache::Present(Layer & layer) {
+  SFRect dst = { 0, 0, layer.w, layer.h };
+  sf_window->getRenderer()->Copy(layer.texture.get(), NULL, dst);
+  SFProfiler::CountDrawCalls(1);
+}
+
+bool SFLayerCache::IsCached(SFLAYER id) const {
+  return layers[id].cached;
+}
+
+long SFLayerCache::GetHits(SFLAYER id) const {
+  return layers[id].hits;
+}
+
+long SFLayerCache::GetDraws(SFLAYER id) const {
+  return layers[id].draws;
+}
+
+const char * SFLayerCache::GetName(SFLAYER id) {
+  static const char * names[SFLAYER_LAST] = { "background", "world", "HUD" };
+  return names[id];
+}
@@ -0,0 +1,70 @@
+#ifndef SFLAYERCACHE_H
+#define SFLAYERCACHE_H
+
+#include <memory>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFWindow.h"
+
+/**
+ * Keeps the layers of the frame that hardly ever change in textures of
+ * their own, so a layer that hasn't changed since the last frame goes on
+ * the screen in one Copy instead of a draw call for each sprite in it.
+ * Whatever changes a layer calls MarkDirty, and only a dirty layer is drawn
+ * again, into its texture. The world moves every frame, so it isn't cached
+ * and is drawn straight onto the screen as it always was, and so is a
+ * layer the renderer can't make a texture for.
+ *
+ * Drawing with:
+ *
+ *   if(layers.Begin(SFLAYER_HUD)) {
+ *     ... draw the HUD ...
+ *     layers.End(SFLAYER_HUD);
+ *   }
+ *
+ * Blending sprites into a clear texture leaves premultiplied colours in
+ * it, so blending that onto the screen again would darken anything
+ * see-through twice. A see-through layer is copied with
+ * SFBLEND_PREMULTIPLIED instead, which comes out as if its sprites had been
+ * drawn onto the screen. An opaque layer is drawn over black and copied
+ * as it is.
+ */
+class SFLayerCache {
+public:
+  SFLayerCache(shared_ptr<SFWindow>);
+
+  // Keeps the layer in a texture covering the top left w x h of the screen. Anything drawn outside it is lost.
+  void Cache(SFLAYER, int w, int h, bool opaque);
+  void MarkDirty(SFLAYER);
+
+  // True if the layer has to be drawn, then End. False if it was put on the screen from its texture.
+  bool Begin(SFLAYER);
+  void End(SFLAYER);
+
+  bool IsCached(SFLAYER) const;
+  long GetHits(SFLAYER) const;      // Frames the layer was copied from its texture
+  long GetDraws(SFLAYER) const;     // Frames it had to be drawn
+
+  static const char * GetName(SFLAYER);
+
+private:
+  struct Layer {
+    bool                  cached;
+    bool                  opaque;
+    bool                  dirty;
+    int                   w, h;
+    shared_ptr<SFTexture> texture;
+    long                  hits;
+    long                  draws;
+  };
+
+  void Present(Layer &);
+
+  shared_ptr<SFWindow> sf_window;
+  Layer                layers[SFLAYER_LAST];
+  uint32_t             colour;      // The draw colour before Begin, for End to put back
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include <algorithm>
+
+#include "SFMask.h"
+
+SFMask::SFMask() : w(0), h(0), words(0) {
+}
+
+SFMask::SFMask(const SFImage & image, uint8_t threshold) : w(image.GetWidth()), h(image.GetHeight()), words((w + 63) / 64) {
+  bits.assign(words * h, 0);
+  for(int y = 0; y < h; y++) {
+    for(int x = 0; x < w; x++) {
+      if((image.GetPixel(x, y) & 0xFF) >= threshold) {
+        bits[y * words + x / 64] |= (uint64_t) 1 << (x % 64);
+      }
+    }
+  }
+}
+
+int SFMask::GetWidth() const {
+  return w;
+}
+
+int SFMask::GetHeight() const {
+  return h;
+}
+
+bool SFMask::Get(int x, int y) const {
+  if(x < 0 || x >= w || y < 0 || y >= h) {
+    return false;
+  }
+  return (bits[y * words + x / 64] >> (x % 64)) & 1;
+}
+
+int SFMask::GetSolid() const {
+  int solid = 0;
+  for(auto word : bits) {
+    for(; word; word &= word - 1) {
+      solid++;
+    }
+  }
+  return solid;
+}
+
+/*********************************************************
+  The word starting at x is the top of the word it starts
+  in and the bottom of the next one. Words off the ends
+  of the row count as clear.
+*********************************************************/
+uint64_t SFMask::Bits(int row, int x) const {
+  int word  = x >= 0 ? x / 64 : -((63 - x) / 64);
+  int shift = x - word * 64;
+
+  const uint64_t * r = &bits[row * words];
+  uint64_t lo = word >= 0 && word < words ? r[word] : 0;
+  uint64_t hi = word + 1 >= 0 && word + 1 < words ? r[word + 1] : 0;
+  return shift ? (lo >> shift) | (hi << (64 - shift)) : lo;
+}
+
+/*********************************************************
+  Goes over the rows where the two overlap, and in each
+  the words of a's row that b covers, ANDing each with the
+  same pixels of b's row.
+*********************************************************/
+bool SFMask::Overlaps(const SFMask & a, const SFMask & b, int dx, int dy) {
+  int x0 = max(0, dx), x1 = min(a.w, dx + b.w);
+  int y0 = max(0, dy), y1 = min(a.h, dy + b.h);
+  if(x0 >= x1 || y0 >= y1) {
+    return false;
+  }
+
+  for(int y = y0; y < y1; y++) {
+    const uint64_t * row = &a.bits[y * a.words];
+    for(int word = x0 / 64; word <= (x1 - 1) / 64; word++) {
+      if(row[word] & b.Bits(y - dy, word * 64 - dx)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
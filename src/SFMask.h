@@ -0,0 +1,44 @@
+#ifndef SFMASK_H
+#define SFMASK_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+#include "SFRaster.h"
+
+/**
+ * Which pixels of a sprite are solid, one bit each, for collisions that
+ * only count where the sprites actually are rather than anywhere in their
+ * boxes. A row is packed into 64 bit words, pixel x in bit x % 64 of word
+ * x / 64, and the bits past the width are always clear.
+ *
+ * Testing two masks ANDs their rows a word at a time, shifting one to line
+ * it up with the other, so a pair of sprites the size of the player and an
+ * alien is a few dozen ANDs rather than a couple of thousand pixel tests.
+ */
+class SFMask {
+public:
+  SFMask();
+  // A pixel is solid if its alpha is at least threshold
+  SFMask(const SFImage &, uint8_t threshold = 128);
+
+  int      GetWidth() const;
+  int      GetHeight() const;
+  bool     Get(int x, int y) const;
+  int      GetSolid() const;       // How many pixels are solid
+
+  // True if any solid pixel of a is on a solid pixel of b, with b's top left dx, dy pixels right of and below a's
+  static bool Overlaps(const SFMask & a, const SFMask & b, int dx, int dy);
+
+private:
+  // 64 bits of a row starting from pixel x (which can be off either end, those bits are clear)
+  uint64_t Bits(int row, int x) const;
+
+  int              w, h;
+  int              words;          // A row
+  vector<uint64_t> bits;
+};
+
+#endif
@@ -3,41 +3,54 @@
 
 /**
  * A Vector representation somewhat in the style of the IBM/Sony Vectormath library.
+ *
+ * Vector2 and Point2 are plain pairs of floats: trivially copyable (so they
+ * can be memcpy'd and kept in registers) and usable in constant expressions.
  */
 class Vector2 {
 public:
-  inline Vector2(const float, const float);
-  inline Vector2(const Vector2 &);
-  inline const float getX() const;
-  inline const float getY() const;
+  constexpr Vector2(const float, const float);
+  constexpr float getX() const;
+  constexpr float getY() const;
 
-  inline const Vector2 operator +( const Vector2 &) const;
-  inline const Vector2 operator *( float) const;
+  constexpr Vector2 operator +( const Vector2 &) const;
+  constexpr Vector2 operator -( const Vector2 &) const;
+  constexpr Vector2 operator -() const;
+  constexpr Vector2 operator *( float) const;
 
 private:
   float m_x, m_y;
 };
 
-inline Vector2::Vector2 (const float x, const float y) : m_x(x), m_y(y) {}
+constexpr Vector2::Vector2 (const float x, const float y) : m_x(x), m_y(y) {}
 
-inline Vector2::Vector2 (const Vector2 &v) : m_x(v.m_x), m_y(v.m_y) {}
-
-inline const float Vector2::getX() const {
+constexpr float Vector2::getX() const {
   return m_x;
 }
 
-inline const float Vector2::getY() const {
+constexpr float Vector2::getY() const {
   return m_y;
 }
 
-inline const Vector2 Vector2::operator +( const Vector2 & vec ) const {
+constexpr Vector2 Vector2::operator +( const Vector2 & vec ) const {
   return Vector2(
 		 m_x + vec.m_x,
 		 m_y + vec.m_y
 		 );
 }
 
-inline const Vector2 Vector2::operator *( float scalar ) const {
+constexpr Vector2 Vector2::operator -( const Vector2 & vec ) const {
+  return Vector2(
+		 m_x - vec.m_x,
+		 m_y - vec.m_y
+		 );
+}
+
+constexpr Vector2 Vector2::operator -() const {
+  return Vector2(-m_x, -m_y);
+}
+
+constexpr Vector2 Vector2::operator *( float scalar ) const {
   return Vector2(
 		 m_x * scalar,
 		 m_y * scalar
@@ -49,45 +62,72 @@ inline const Vector2 Vector2::operator *( float scalar ) const {
  */
 class Point2 {
 public:
-  inline Point2(const float, const float);
-  inline Point2(const Vector2 &);
-  inline Point2(const Point2 &);
-  inline const float getX() const;
-  inline const float getY() const;
+  constexpr Point2(const float, const float);
+  constexpr Point2(const Vector2 &);
+  constexpr float getX() const;
+  constexpr float getY() const;
+
+  constexpr Point2  operator +( const Vector2 &) const;
+  constexpr Vector2 operator -( const Point2 &) const;
 private:
   float m_x, m_y;
 };
 
-inline Point2::Point2 (const float x, const float y) : m_x(x), m_y(y) {}
-
-inline Point2::Point2 (const Vector2 & v) : m_x(v.getX()), m_y(v.getY()) {}
+constexpr Point2::Point2 (const float x, const float y) : m_x(x), m_y(y) {}
 
-inline Point2::Point2 (const Point2 & p) : m_x(p.m_x), m_y(p.m_y) {}
+constexpr Point2::Point2 (const Vector2 & v) : m_x(v.getX()), m_y(v.getY()) {}
 
-inline const float Point2::getX() const {
+constexpr float Point2::getX() const {
   return m_x;
 }
 
-inline const float Point2::getY() const {
+constexpr float Point2::getY() const {
   return m_y;
 }
 
+constexpr Point2 Point2::operator +( const Vector2 & vec ) const {
+  return Point2(m_x + vec.getX(), m_y + vec.getY());
+}
+
+constexpr Vector2 Point2::operator -( const Point2 & pnt ) const {
+  return Vector2(m_x - pnt.m_x, m_y - pnt.m_y);
+}
+
 /*
  * Useful functions
  */
 
-inline static float projection( const Point2 & pnt, const Vector2 & unitVec ) {
-  float result;
-  result =  ( pnt.getX() * unitVec.getX() );
-  result += ( pnt.getY() * unitVec.getY() );
-  return result;
+constexpr float projection( const Point2 & pnt, const Vector2 & unitVec ) {
+  return ( pnt.getX() * unitVec.getX() ) + ( pnt.getY() * unitVec.getY() );
+}
+
+constexpr float dot( const Vector2 & a, const Vector2 & b ) {
+  return ( a.getX() * b.getX() ) + ( a.getY() * b.getY() );
+}
+
+constexpr float lengthSqr( const Vector2 & v ) {
+  return dot(v, v);
+}
+
+constexpr Vector2 minPerElem( const Vector2 & a, const Vector2 & b ) {
+  return Vector2(a.getX() < b.getX() ? a.getX() : b.getX(),
+                 a.getY() < b.getY() ? a.getY() : b.getY());
+}
+
+constexpr Vector2 maxPerElem( const Vector2 & a, const Vector2 & b ) {
+  return Vector2(a.getX() > b.getX() ? a.getX() : b.getX(),
+                 a.getY() > b.getY() ? a.getY() : b.getY());
+}
+
+constexpr Vector2 clampPerElem( const Vector2 & v, const Vector2 & lo, const Vector2 & hi ) {
+  return minPerElem(maxPerElem(v, lo), hi);
 }
 
-static const Vector2 xAxis() {
+constexpr Vector2 xAxis() {
   return Vector2(1.0f, 0.0f);
 }
 
-static const Vector2 yAxis() {
+constexpr Vector2 yAxis() {
   return Vector2(0.0f, 1.0f);
 }
 
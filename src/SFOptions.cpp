@@ -0,0 +1,150 @@
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+#include "SFOptions.h"
+
+/*********************************************************
+  Reads the settings from the command line. Returns false
+  (after saying why) if an argument isn't understood.
+*********************************************************/
+bool SFOptions::Parse(int argc, char ** argv) {
+  for(int i = 1; i < argc; i++) {
+    int * value = nullptr;
+
+    if(strcmp(argv[i], "--stress") == 0) {
+      stress = true;
+      continue;
+    }
+    else if(strcmp(argv[i], "--memory-log") == 0) {
+      memoryLog = true;
+      continue;
+    }
+    else if(strcmp(argv[i], "--no-walls") == 0) {
+      walls = false;
+      continue;
+    }
+    else if(strcmp(argv[i], "--no-layer-cache") == 0) {
+      layerCache = false;
+      continue;
+    }
+    else if(strcmp(argv[i], "--no-pixel-collisions") == 0) {
+      pixelCollisions = false;
+      continue;
+    }
+    else if(strcmp(argv[i], "--vsync") == 0) {
+      vsync = true;
+      continue;
+    }
+    else if(strcmp(argv[i], "--broadphase") == 0) {
+      const char * name = i + 1 < argc ? argv[++i] : "";
+      if(strcmp(name, "tree") == 0) {
+        broadphase = SFBROADPHASE_TREE;
+      }
+      else if(strcmp(name, "brute") == 0) {
+        broadphase = SFBROADPHASE_BRUTE;
+      }
+      else if(strcmp(name, "sap") == 0) {
+        broadphase = SFBROADPHASE_SAP;
+      }
+      else {
+        cerr << "--broadphase needs to be sap, tree or brute" << endl;
+        return false;
+      }
+      continue;
+    }
+    else if(strcmp(argv[i], "--record") == 0) {
+      if(i + 1 >= argc) {
+        cerr << "--record needs a file name after it" << endl;
+        return false;
+      }
+      record = argv[++i];
+      continue;
+    }
+    else if(strcmp(argv[i], "--renderer") == 0) {
+      const char * name = i + 1 < argc ? argv[++i] : "";
+      if(strcmp(name, "sdl") == 0) {
+        renderer = SFRENDERER_SDL;
+      }
+      else if(strcmp(name, "software") == 0) {
+        renderer = SFRENDERER_SOFTWARE;
+      }
+      else {
+        cerr << "--renderer needs to be sdl or software" << endl;
+        return false;
+      }
+      continue;
+    }
+    else if(strcmp(argv[i], "--aliens") == 0) {
+      value = &stressAliens;
+    }
+    else if(strcmp(argv[i], "--emitters") == 0) {
+      value = &stressEmitters;
+    }
+    else if(strcmp(argv[i], "--pickups") == 0) {
+      value = &stressPickups;
+    }
+    else if(strcmp(argv[i], "--projectiles") == 0) {
+      value = &stressProjectiles;
+    }
+    else if(strcmp(argv[i], "--ticks") == 0) {
+      value = &stressTicks;
+    }
+    else if(strcmp(argv[i], "--spawns-per-frame") == 0) {
+      value = &spawnsPerFrame;
+    }
+    else if(strcmp(argv[i], "--spawn-budget") == 0) {
+      value = &spawnBudgetUs;
+    }
+    else if(strcmp(argv[i], "--hitch-ms") == 0) {
+      value = &hitchMs;
+    }
+    else if(strcmp(argv[i], "--particles") == 0) {
+      value = &particles;
+    }
+    else if(strcmp(argv[i], "--stars") == 0) {
+      value = &stars;
+    }
+    else if(strcmp(argv[i], "--star-layers") == 0) {
+      value = &starLayers;
+    }
+    else if(strcmp(argv[i], "--fps-cap") == 0) {
+      value = &fpsCap;
+    }
+    else if(strcmp(argv[i], "--frame-budget") == 0) {
+      value = &frameBudgetMs;
+      frameBudgetSet = true;
+    }
+    else {
+      cerr << "Unknown argument " << argv[i] << endl;
+      return false;
+    }
+
+    if(i + 1 >= argc || atoi(argv[i + 1]) < 0) {
+      cerr << argv[i] << " needs a number after it" << endl;
+      return false;
+    }
+    *value = atoi(argv[++i]);
+  }
+
+  if(renderer == SFRENDERER_SOFTWARE && !stress) {
+    cerr << "--renderer software only works with --stress" << endl;
+    return false;
+  }
+  return true;
+}
+
+ostream& operator<<(ostream& os, const SFOptions& obj) {
+  os << "aliens:" << obj.stressAliens << " emitters:" << obj.stressEmitters << " pickups:" << obj.stressPickups
+     << " projectiles:" << obj.stressProjectiles << " ticks:" << obj.stressTicks
+     << " broadphase:" << (obj.broadphase == SFBROADPHASE_SAP ? "sap" : (obj.broadphase == SFBROADPHASE_TREE ? "tree" : "brute"))
+     << " renderer:" << (obj.renderer == SFRENDERER_SOFTWARE ? "software" : "sdl")
+     << " spawns-per-frame:" << obj.spawnsPerFrame << " spawn-budget:" << obj.spawnBudgetUs << "us"
+     << " hitch-ms:" << obj.hitchMs << " particles:" << obj.particles
+     << " stars:" << obj.stars << " star-layers:" << obj.starLayers << " walls:" << (obj.walls ? "on" : "off")
+     << " layer-cache:" << (obj.layerCache ? "on" : "off")
+     << " pixel-collisions:" << (obj.pixelCollisions ? "on" : "off")
+     << " vsync:" << (obj.vsync ? "on" : "off") << " fps-cap:" << obj.fpsCap
+     << " frame-budget:" << obj.frameBudgetMs << "ms";
+  return os;
+}
@@ -0,0 +1,153 @@
+#ifndef SFOPTIONS_H
+#define SFOPTIONS_H
+
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+#include "SFCommon.h"
+
+/**
+ * Settings that can be given on the command line. With none the game
+ * plays normally.
+ *
+ * Stress test mode:
+ *   ./SFApp --stress [--aliens N] [--emitters M] [--pickups K]
+ *                    [--projectiles P] [--ticks T]
+ *
+ * In stress mode the game spawns the given number of entities, plays itself
+ * for a fixed number of ticks as fast as it can and then prints frame time
+ * percentiles and memory use. Aliens only fire in stress mode.
+ *
+ * Soak testing:
+ *   ./SFApp --memory-log
+ *
+ * Writes memory use and entity counts to sf_memory.csv once a second.
+ *
+ * Collision broadphase:
+ *   ./SFApp --broadphase tree|sap|brute
+ *
+ * How the pairs of things that might have collided are found. The AABB
+ * tree is the default, sap is sweep and prune along Y and brute force
+ * tests every pair.
+ *
+ * Wave spawning:
+ *   ./SFApp --spawns-per-frame N --spawn-budget US
+ *
+ * The most aliens a wave can spawn in one frame, and the most time in
+ * microseconds spawning can take. The rest of the wave waits for later
+ * frames. A budget of 0 only counts aliens, which is what --record uses
+ * whatever it's given so the session plays back the same.
+ *
+ * Rendering:
+ *   ./SFApp --stress --renderer sdl|software
+ *
+ * What draws the frames. sdl (the default) draws on the window, software
+ * draws into memory with no window at all, so the stress test can measure
+ * fill rate on a machine with no display or GPU. The software renderer
+ * only works with --stress, there's nothing to play on.
+ *
+ * Recording a session:
+ *   ./SFApp --record FILE
+ *
+ * Saves what the player did to FILE when the game ends, so it can be
+ * replayed by the performance gate (see tests/PerfGate.cpp).
+ *
+ * Particles:
+ *   ./SFApp --particles N
+ *
+ * The most explosion, flash and sparkle particles alive at once. Past
+ * that new ones are dropped. 0 turns them off.
+ *
+ * Stars:
+ *   ./SFApp --stars N --star-layers N
+ *
+ * How many stars the background has, and how many layers of them scroll
+ * past at different speeds (see SFStarfield.h). Either as 0 leaves the
+ * sky empty.
+ *
+ * Walls:
+ *   ./SFApp --no-walls
+ *
+ * Leaves the walls of the tile map out, for an empty sky.
+ *
+ * Layer cache:
+ *   ./SFApp --no-layer-cache
+ *
+ * Draws the HUD sprite by sprite every frame instead of keeping it in a
+ * texture (see SFLayerCache.h), to compare. It's only ever kept in a
+ * texture when drawing through SDL.
+ *
+ * Pixel collisions:
+ *   ./SFApp --no-pixel-collisions
+ *
+ * Counts anything whose boxes touch as a hit, the way the game used to,
+ * instead of checking the sprites' solid pixels as well (see SFMask.h).
+ *
+ * Presenting:
+ *   ./SFApp --vsync --fps-cap N
+ *
+ * --vsync makes each present wait for the display's refresh (F2 switches
+ * it in-game where SDL can). --fps-cap draws at most N frames a second,
+ * skipping the draw on ticks in between; the game still updates 60 times
+ * a second. 0, the default, draws every tick. The game ends by printing
+ * how long key presses took to reach the screen in each mode (see
+ * SFLatency.h).
+ *
+ * Frame budget:
+ *   ./SFApp --frame-budget MS
+ *
+ * How long a frame can take to update and draw before the governor cuts
+ * optional work: far star layers, particles and the overlay's graph (see
+ * SFGovernor.h). 0 never cuts anything. The game prints each change and a
+ * summary when it ends. The stress test only uses the governor when it's
+ * given --frame-budget, so its timings are for the full scene by default.
+ *
+ * Hitch traces:
+ *   ./SFApp --hitch-ms MS
+ *
+ * A frame longer than this counts as a hitch, and the frames around it
+ * are saved to sf_hitch_<date>_<time>_f<frame>.csv. 0 turns it off.
+ */
+struct SFOptions {
+  bool stress            = false;
+  int  stressAliens      = 1000;  // Aliens spawned at the start
+  int  stressEmitters    = 50;    // Points along the top that keep firing enemy shots
+  int  stressPickups     = 100;   // Coins and power ups spawned at the start
+  int  stressProjectiles = 1000;  // How many player shots can be on screen
+  int  stressTicks       = 1000;  // How long the run lasts
+
+  bool memoryLog         = false; // Write sf_memory.csv once a second (for soak tests)
+
+  SFBROADPHASE broadphase = SFBROADPHASE_TREE;
+  SFRENDERER   renderer   = SFRENDERER_SDL;
+
+  int  spawnsPerFrame    = 2;     // Most aliens a wave spawns in one frame
+  int  spawnBudgetUs     = 500;   // Most time a frame spends spawning them
+
+  string record;                  // Where to save the session played (empty for nowhere)
+
+  int  hitchMs           = 33;    // Frames longer than this are saved to a trace (0 for never)
+
+  int  particles         = 32768; // Most particles alive at once
+
+  int  stars             = 200;   // Stars in the background, between all its layers
+  int  starLayers        = 3;
+
+  bool walls             = true;  // Scroll the tile map of walls down the screen
+  bool layerCache        = true;  // Keep the HUD in a texture while it doesn't change
+  bool pixelCollisions   = true;  // Only count a hit where the sprites' solid pixels touch
+
+  bool vsync             = false; // Present waits for the display's refresh
+  int  fpsCap            = 0;     // Most frames drawn a second (0 for every tick)
+
+  int  frameBudgetMs     = 16;    // Frame time the governor keeps to by cutting optional work (0 for never)
+  bool frameBudgetSet    = false; // --frame-budget was given, so the stress test uses the governor too
+
+  bool Parse(int argc, char ** argv);
+};
+
+ostream& operator<<(ostream &, const SFOptions &);
+
+#endif
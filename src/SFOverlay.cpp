@@ -0,0 +1,229 @@
+/*********************************************************
+  The performance overlay. Toggle it in-game with F1.
+
+  The font is 5x7 pixels per character and only has the
+  characters the overlay needs. Each one is stored as 7
+  rows of 5 bits, with the leftmost pixel as the top bit.
+*********************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "SFOverlay.h"
+#include "SFProfiler.h"
+
+static const char  SF_FONT_CHARS[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:/-%";
+static const int   SF_FONT_W = 5, SF_FONT_H = 7, SF_FONT_CELL = 6, SF_FONT_SCALE = 2;
+static const Uint8 SF_FONT_ROWS[][SF_FONT_H] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+  {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // 0
+  {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 1
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // 2
+  {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // 3
+  {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // 4
+  {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // 5
+  {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // 6
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+  {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // 8
+  {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // 9
+  {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}, // A
+  {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // B
+  {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // C
+  {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // D
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // E
+  {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // F
+  {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // G
+  {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // H
+  {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // I
+  {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // J
+  {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+  {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // L
+  {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+  {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+  {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // O
+  {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // P
+  {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // Q
+  {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // R
+  {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // S
+  {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // U
+  {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // V
+  {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // W
+  {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // X
+  {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // Y
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // Z
+  {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // .
+  {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // :
+  {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // /
+  {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // -
+  {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // %
+};
+static const int SF_FONT_GLYPHS = sizeof(SF_FONT_ROWS) / sizeof(SF_FONT_ROWS[0]);
+
+/*********************************************************
+  Builds the font texture: every glyph side by side in one
+  row, white where the glyph is and transparent elsewhere.
+*********************************************************/
+SFOverlay::SFOverlay(const std::shared_ptr<SFWindow> window) : sf_window(window), font(nullptr), visible(false), graph(true), next(0), filled(0) {
+  const int w = SF_FONT_GLYPHS * SF_FONT_CELL, h = SF_FONT_H;
+  Uint32 pixels[SF_FONT_GLYPHS * SF_FONT_CELL * SF_FONT_H];
+  memset(pixels, 0, sizeof(pixels));
+
+  for(int g = 0; g < SF_FONT_GLYPHS; g++) {
+    for(int row = 0; row < SF_FONT_H; row++) {
+      for(int col = 0; col < SF_FONT_W; col++) {
+        if(SF_FONT_ROWS[g][row] & (0x10 >> col)) {
+          pixels[row * w + g * SF_FONT_CELL + col] = 0xFFFFFFFF;
+        }
+      }
+    }
+  }
+
+  font = sf_window->getRenderer()->CreateTexture(w, h, pixels);
+  if(!font) {
+    cerr << "Could not create overlay font: " << SDL_GetError() << endl;
+    throw SF_ERROR_LOAD_ASSET;
+  }
+  SFProfiler::CountTextures(1);
+
+  for(int i = 0; i < SF_OVERLAY_HISTORY; i++) {
+    history[i] = 0.0;
+  }
+}
+
+SFOverlay::~SFOverlay() {
+  if(font) {
+    delete font;
+    SFProfiler::CountTextures(-1);
+    font = nullptr;
+  }
+}
+
+void SFOverlay::Toggle() {
+  visible = !visible;
+}
+
+bool SFOverlay::IsVisible() {
+  return visible;
+}
+
+void SFOverlay::SetGraph(bool on) {
+  graph = on;
+}
+
+/*********************************************************
+  Adds a frame time to the rolling history. This is done
+  even when hidden so the graph is full when shown.
+*********************************************************/
+void SFOverlay::OnFrame(double frameMs) {
+  history[next] = frameMs;
+  next = (next + 1) % SF_OVERLAY_HISTORY;
+  if(filled < SF_OVERLAY_HISTORY) {
+    filled++;
+  }
+}
+
+/*********************************************************
+  Draws the overlay in the top right of the screen. All
+  the numbers come from SFProfiler apart from the entity
+  counts, which SFApp passes in.
+*********************************************************/
+void SFOverlay::OnRender(const SFEntityCounts & counts) {
+  if(!visible) {
+    return;
+  }
+
+  SFRenderer * renderer = sf_window->getRenderer();
+  uint32_t colour = renderer->GetDrawColour();
+  int w, h;
+  renderer->GetOutputSize(w, h);
+
+  // Average over the history that has been filled so far
+  double total = 0.0;
+  for(int i = 0; i < filled; i++) {
+    total += history[i];
+  }
+  double last = history[(next + SF_OVERLAY_HISTORY - 1) % SF_OVERLAY_HISTORY];
+  double fps = last > 0.0 ? 1000.0 / last : 0.0;
+  double avgFps = total > 0.0 ? 1000.0 * filled / total : 0.0;
+
+  const int x = w - 250, lineH = (SF_FONT_H + 3) * SF_FONT_SCALE;
+  int y = 8;
+
+  // Dim the area behind the text so it can be read over the stars
+  SFRect back = { x - 8, 0, 258, 8 * lineH + 80 };
+  renderer->SetDrawColour(0, 0, 0, 160);
+  renderer->FillRect(back);
+  SFProfiler::CountDrawCalls(1);
+
+  char line[64];
+  snprintf(line, sizeof(line), "FPS %.0f AVG %.0f", fps, avgFps);
+  DrawText(x, y, line); y += lineH;
+  snprintf(line, sizeof(line), "UPD %.2f RND %.2f MS", SFProfiler::GetUpdateMs(), SFProfiler::GetPhaseMs(SFPHASE_RENDER));
+  DrawText(x, y, line); y += lineH;
+  snprintf(line, sizeof(line), "ALIENS %d COINS %d", counts.aliens, counts.coins);
+  DrawText(x, y, line); y += lineH;
+  snprintf(line, sizeof(line), "PPROJ %d EPROJ %d", counts.pProjectiles, counts.eProjectiles);
+  DrawText(x, y, line); y += lineH;
+  snprintf(line, sizeof(line), "POWERS %d PARTS %d", counts.powers, counts.particles);
+  DrawText(x, y, line); y += lineH;
+  snprintf(line, sizeof(line), "DRAWS %d TEX %d", SFProfiler::GetDrawCalls(), SFProfiler::GetLiveTextures());
+  DrawText(x, y, line); y += lineH;
+
+  if(graph) {
+    DrawGraph(x, y + 8);
+  }
+
+  // Leave the draw colour how the caller had it
+  renderer->RestoreDrawColour(colour);
+}
+
+/*********************************************************
+  Copies each character out of the font texture.
+  Characters the font doesn't have are drawn as spaces.
+*********************************************************/
+void SFOverlay::DrawText(int x, int y, const char * text) {
+  int calls = 0;
+  for(const char * c = text; *c; c++, x += SF_FONT_CELL * SF_FONT_SCALE) {
+    const char * found = strchr(SF_FONT_CHARS, *c);
+    if(*c == ' ' || !found) {
+      continue;
+    }
+
+    int glyph = found - SF_FONT_CHARS;
+    SFRect src = { glyph * SF_FONT_CELL, 0, SF_FONT_W, SF_FONT_H };
+    SFRect dst = { x, y, SF_FONT_W * SF_FONT_SCALE, SF_FONT_H * SF_FONT_SCALE };
+    sf_window->getRenderer()->Copy(font, &src, dst);
+    calls++;
+  }
+  SFProfiler::CountDrawCalls(calls);
+}
+
+/*********************************************************
+  Draws the frame time history as one line strip, with a
+  red line marking the 60 FPS budget. The graph tops out
+  at two frames' worth (33 ms).
+*********************************************************/
+void SFOverlay::DrawGraph(int x, int y) {
+  SFRenderer * renderer = sf_window->getRenderer();
+  const int graphH = 60;
+  const double maxMs = 1000.0 / 30.0, budgetMs = 1000.0 / 60.0;
+
+  int budgetY = y + graphH - (int) (graphH * budgetMs / maxMs);
+  renderer->SetDrawColour(200, 40, 40, 255);
+  renderer->DrawLine(x, budgetY, x + SF_OVERLAY_HISTORY * 2, budgetY);
+
+  SFPoint points[SF_OVERLAY_HISTORY];
+  for(int i = 0; i < SF_OVERLAY_HISTORY; i++) {
+    double ms = history[(next + i) % SF_OVERLAY_HISTORY];
+    if(ms > maxMs) {
+      ms = maxMs;
+    }
+    points[i].x = x + i * 2;
+    points[i].y = y + graphH - (int) (graphH * ms / maxMs);
+  }
+  renderer->SetDrawColour(80, 220, 80, 255);
+  renderer->DrawLines(points, SF_OVERLAY_HISTORY);
+  SFProfiler::CountDrawCalls(2);
+}
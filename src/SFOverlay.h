@@ -0,0 +1,51 @@
+#ifndef SFOVERLAY_H
+#define SFOVERLAY_H
+
+#include <memory>
+
+#include <SDL2/SDL.h>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFWindow.h"
+
+/**
+ * Performance overlay drawn on top of the HUD. It shows the current and
+ * average FPS, a graph of recent frame times, how the frame was split
+ * between updating and rendering, how many entities are alive and the draw
+ * call and texture counts.
+ *
+ * Text comes from a small built-in bitmap font that is turned into a single
+ * texture when the overlay is made, so drawing it needs no extra loading.
+ */
+class SFOverlay {
+public:
+  SFOverlay(const std::shared_ptr<SFWindow>);
+  virtual ~SFOverlay();
+
+  void    Toggle();
+  bool    IsVisible();
+  // Whether the frame time graph is drawn along with the text
+  void    SetGraph(bool);
+  void    OnFrame(double frameMs);
+  void    OnRender(const SFEntityCounts &);
+
+private:
+  void    DrawText(int x, int y, const char * text);
+  void    DrawGraph(int x, int y);
+
+  static const int SF_OVERLAY_HISTORY = 120;
+
+  std::shared_ptr<SFWindow>   sf_window;
+  SFTexture                 * font;
+  bool                        visible;
+  bool                        graph;
+
+  // Rolling history of frame times, oldest first from `next`
+  double                      history[SF_OVERLAY_HISTORY];
+  int                         next;
+  int                         filled;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include <algorithm>
+
+#include "SFParticles.h"
+
+#ifdef SF_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+void SFParticleStepScalar(float * x, float * y, float * vx, float * vy, float * age, int n, float drag, float gravity) {
+  for(int i = 0; i < n; i++) {
+    vx[i]  = vx[i] * drag;
+    vy[i]  = vy[i] * drag;
+    vy[i]  = vy[i] + gravity;
+    x[i]   = x[i] + vx[i];
+    y[i]   = y[i] + vy[i];
+    age[i] = age[i] + 1.0f;
+  }
+}
+
+#ifdef SF_RASTER_SSE2
+/*********************************************************
+  Four particles at a time. The arrays aren't promised to
+  be 16 byte aligned, so the loads and stores are the
+  unaligned kind (which cost nothing extra on anything
+  made since SSE2 was new). Whatever's left over at the
+  end goes through the scalar kernel.
+*********************************************************/
+void SFParticleStepSSE2(float * x, float * y, float * vx, float * vy, float * age, int n, float drag, float gravity) {
+  const __m128 d   = _mm_set1_ps(drag);
+  const __m128 g   = _mm_set1_ps(gravity);
+  const __m128 one = _mm_set1_ps(1.0f);
+
+  int i = 0;
+  for(; i + 4 <= n; i += 4) {
+    __m128 sx = _mm_mul_ps(_mm_loadu_ps(vx + i), d);
+    __m128 sy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), d), g);
+    _mm_storeu_ps(vx + i, sx);
+    _mm_storeu_ps(vy + i, sy);
+    _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), sx));
+    _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), sy));
+    _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), one));
+  }
+  SFParticleStepScalar(x + i, y + i, vx + i, vy + i, age + i, n - i, drag, gravity);
+}
+#endif
+
+void SFParticleStep(float * x, float * y, float * vx, float * vy, float * age, int n, float drag, float gravity) {
+#ifdef SF_RASTER_SSE2
+  SFParticleStepSSE2(x, y, vx, vy, age, n, drag, gravity);
+#else
+  SFParticleStepScalar(x, y, vx, vy, age, n, drag, gravity);
+#endif
+}
+
+SFParticlePool::SFParticlePool(int capacity, const SFParticleStyle & style) : style(style), capacity(max(0, capacity)), count(0), dropped(0),
+  x(this->capacity), y(this->capacity), vx(this->capacity), vy(this->capacity), age(this->capacity), life(this->capacity) {
+}
+
+bool SFParticlePool::Emit(float px, float py, float pvx, float pvy, float plife) {
+  if(count == capacity) {
+    dropped++;
+    return false;
+  }
+  x[count]    = px;
+  y[count]    = py;
+  vx[count]   = pvx;
+  vy[count]   = pvy;
+  age[count]  = 0.0f;
+  life[count] = plife;
+  count++;
+  return true;
+}
+
+/*********************************************************
+  Moves every particle with the kernel, then takes out the
+  dead ones by moving the last live particle into their
+  place. The order of the particles changes, but nothing
+  depends on it, and it keeps the kernel running over one
+  packed block.
+*********************************************************/
+void SFParticlePool::Update() {
+  SFParticleStep(x.data(), y.data(), vx.data(), vy.data(), age.data(), count, style.drag, style.gravity);
+
+  for(int i = 0; i < count; ) {
+    if(age[i] < life[i]) {
+      i++;
+      continue;
+    }
+    count--;
+    x[i]    = x[count];
+    y[i]    = y[count];
+    vx[i]   = vx[count];
+    vy[i]   = vy[count];
+    age[i]  = age[count];
+    life[i] = life[count];
+  }
+}
+
+/*********************************************************
+  Works out how far through its life each particle is,
+  which gives its size, how faded it is and which frame
+  of the sheet it's on. Particles that have shrunk to
+  nothing or are off the screen are left out.
+*********************************************************/
+void SFParticlePool::BuildSprites(vector<SFSprite> & out, int screenW, int screenH) const {
+  for(int i = 0; i < count; i++) {
+    float t = age[i] / life[i];
+    int size = (int) (style.sizeStart + (style.sizeEnd - style.sizeStart) * t + 0.5f);
+    int sx = (int) x[i] - size / 2, sy = screenH - (int) y[i] - size / 2;
+    if(size <= 0 || sx >= screenW || sy >= screenH || sx + size <= 0 || sy + size <= 0) {
+      continue;
+    }
+
+    int frame = min(style.frames - 1, (int) (t * style.frames));
+    SFSprite sprite;
+    sprite.src   = { (frame % style.columns) * style.frameW, (frame / style.columns) * style.frameH, style.frameW, style.frameH };
+    sprite.dst   = { sx, sy, size, size };
+    sprite.alpha = (uint8_t) (255.0f * (1.0f - t));
+    out.push_back(sprite);
+  }
+}
+
+int SFParticlePool::GetCount() const {
+  return count;
+}
+
+int SFParticlePool::GetCapacity() const {
+  return capacity;
+}
+
+long SFParticlePool::GetDropped() const {
+  return dropped;
+}
+
+float SFParticlePool::GetX(int i) const {
+  return x[i];
+}
+
+float SFParticlePool::GetY(int i) const {
+  return y[i];
+}
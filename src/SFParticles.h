@@ -0,0 +1,85 @@
+#ifndef SFPARTICLES_H
+#define SFPARTICLES_H
+
+#include <vector>
+
+using namespace std;
+
+#include "SFRaster.h"
+
+/*
+ * Particle update kernels. One tick for n particles, each array holding
+ * one field of every particle:
+ *
+ *   v   = v * drag, then vy += gravity
+ *   pos = pos + v
+ *   age = age + 1
+ *
+ * The SSE2 kernel does four particles at a time with the same sums in the
+ * same order, so it moves them exactly as far as the scalar one does.
+ * SFParticleStep picks the fastest one built in.
+ */
+void SFParticleStepScalar(float * x, float * y, float * vx, float * vy, float * age, int n, float drag, float gravity);
+#ifdef SF_RASTER_SSE2
+void SFParticleStepSSE2(float * x, float * y, float * vx, float * vy, float * age, int n, float drag, float gravity);
+#endif
+void SFParticleStep(float * x, float * y, float * vx, float * vy, float * age, int n, float drag, float gravity);
+
+/**
+ * How one kind of particle looks and moves. Particles shrink or grow from
+ * sizeStart to sizeEnd pixels across and fade out over their life, and
+ * play the frames of their sprite sheet once, in order. The sheet is laid
+ * out left to right, top to bottom, columns frames a row.
+ */
+struct SFParticleStyle {
+  float gravity;          // Added to the vertical speed each tick (up is positive)
+  float drag;             // Speed is multiplied by this each tick
+  float sizeStart;
+  float sizeEnd;
+  int   frames;
+  int   columns;
+  int   frameW, frameH;   // One frame of the sheet
+};
+
+/**
+ * A fixed number of particles of one style, stored a field to an array
+ * (structure of arrays) so the update is a straight run over each field
+ * and the SIMD kernel can load four at once. Nothing is allocated after
+ * the pool is made: emitting into a full pool drops the particle, and a
+ * dead one is replaced with the last one so the live ones stay packed at
+ * the front.
+ *
+ * Positions are in game space (0,0 at the bottom left), speeds in pixels
+ * a tick and lives in ticks.
+ */
+class SFParticlePool {
+public:
+  SFParticlePool(int capacity, const SFParticleStyle &);
+
+  // Returns false if the pool was full and the particle was dropped
+  bool     Emit(float x, float y, float vx, float vy, float life);
+
+  // One tick: moves and ages every particle, then removes the ones whose life is up
+  void     Update();
+
+  // Adds a sprite for each particle that would show on a screenW by screenH screen
+  void     BuildSprites(vector<SFSprite> & out, int screenW, int screenH) const;
+
+  int      GetCount() const;
+  int      GetCapacity() const;
+  long     GetDropped() const;
+
+  // Where particle i is, for tests
+  float    GetX(int i) const;
+  float    GetY(int i) const;
+
+private:
+  SFParticleStyle style;
+  int             capacity;
+  int             count;
+  long            dropped;
+
+  vector<float>   x, y, vx, vy, age, life;
+};
+
+#endif
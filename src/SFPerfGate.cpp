@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "SFPerfGate.h"
+#include "SFProfiler.h"
+
+const char * SFPerfMetricName(int metric) {
+  return metric == SF_PERF_FRAME ? "frame" : SFProfiler::GetPhaseName((SFPHASE) metric);
+}
+
+// Nearest-rank percentile of an already sorted list
+static double Percentile(const vector<double> & sorted, double p) {
+  if(sorted.empty()) {
+    return 0.0;
+  }
+  return sorted[(size_t) (p / 100.0 * (sorted.size() - 1) + 0.5)];
+}
+
+SFRunSummary SFRunSummary::Of(const vector<SFFrameSample> & samples) {
+  SFRunSummary s;
+  s.frames = samples.size();
+  s.allocs = 0.0;
+  for(auto & f : samples) {
+    s.allocs += f.allocs;
+  }
+  s.allocs = samples.empty() ? 0.0 : s.allocs / samples.size();
+
+  vector<double> ms(samples.size()), deviation(samples.size());
+  for(int m = 0; m < SF_PERF_METRICS; m++) {
+    for(size_t i = 0; i < samples.size(); i++) {
+      if(m == SF_PERF_FRAME) {
+        ms[i] = 0.0;
+        for(int p = 0; p < SFPHASE_LAST; p++) {
+          ms[i] += samples[i].phaseMs[p];
+        }
+      }
+      else {
+        ms[i] = samples[i].phaseMs[m];
+      }
+    }
+    sort(ms.begin(), ms.end());
+    s.median[m] = Percentile(ms, 50.0);
+    s.p95[m]    = Percentile(ms, 95.0);
+
+    for(size_t i = 0; i < ms.size(); i++) {
+      deviation[i] = fabs(ms[i] - s.median[m]);
+    }
+    sort(deviation.begin(), deviation.end());
+    s.mad[m] = Percentile(deviation, 50.0);
+  }
+  return s;
+}
+
+SFRunSummary SFRunSummary::Best(const SFRunSummary & a, const SFRunSummary & b) {
+  SFRunSummary s = a;
+  for(int m = 0; m < SF_PERF_METRICS; m++) {
+    if(b.median[m] < a.median[m]) {
+      s.median[m] = b.median[m];
+      s.mad[m]    = b.mad[m];
+    }
+    s.p95[m] = min(a.p95[m], b.p95[m]);
+  }
+  s.allocs = min(a.allocs, b.allocs);
+  return s;
+}
+
+/*********************************************************
+  Reads a baseline saved by Save. Returns false, after
+  saying why, if it can't.
+*********************************************************/
+bool SFPerfBaseline::Load(const string & path) {
+  ifstream in(path.c_str());
+  if(!in) {
+    cerr << "Could not open baseline " << path << endl;
+    return false;
+  }
+
+  runs.clear();
+  string line;
+  getline(in, line);
+  for(int number = 2; getline(in, line); number++) {
+    for(auto & c : line) {
+      c = c == ',' ? ' ' : c;
+    }
+    istringstream fields(line);
+    string session, metric;
+    long frames;
+    double median, p95, mad;
+    if(!(fields >> session >> metric >> frames >> median >> p95 >> mad)) {
+      cerr << path << ":" << number << ": expected session,metric,frames,median_ms,p95_ms,mad_ms" << endl;
+      return false;
+    }
+
+    SFRunSummary & run = runs[session];
+    run.frames = frames;
+    if(metric == "allocs") {
+      run.allocs = median;
+      continue;
+    }
+    int m = 0;
+    while(m < SF_PERF_METRICS && metric != SFPerfMetricName(m)) {
+      m++;
+    }
+    if(m == SF_PERF_METRICS) {
+      cerr << path << ":" << number << ": unknown metric " << metric << endl;
+      return false;
+    }
+    run.median[m] = median;
+    run.p95[m]    = p95;
+    run.mad[m]    = mad;
+  }
+  return true;
+}
+
+bool SFPerfBaseline::Save(const string & path) const {
+  FILE * out = fopen(path.c_str(), "w");
+  if(!out) {
+    cerr << "Could not write baseline " << path << endl;
+    return false;
+  }
+  fprintf(out, "session,metric,frames,median_ms,p95_ms,mad_ms\n");
+  for(auto & run : runs) {
+    const SFRunSummary & s = run.second;
+    for(int m = 0; m < SF_PERF_METRICS; m++) {
+      fprintf(out, "%s,%s,%ld,%.6f,%.6f,%.6f\n", run.first.c_str(), SFPerfMetricName(m), s.frames, s.median[m], s.p95[m], s.mad[m]);
+    }
+    fprintf(out, "%s,allocs,%ld,%.6f,0,0\n", run.first.c_str(), s.frames, s.allocs);
+  }
+  return fclose(out) == 0;
+}
+
+bool SFPerfBaseline::Has(const string & session) const {
+  return runs.count(session) > 0;
+}
+
+const SFRunSummary & SFPerfBaseline::Get(const string & session) const {
+  return runs.at(session);
+}
+
+void SFPerfBaseline::Set(const string & session, const SFRunSummary & summary) {
+  runs[session] = summary;
+}
+
+// How far off the true median a median of n frames is likely to be (the MAD standing in for the spread)
+static double StandardError(double mad, long frames) {
+  return frames > 0 ? 1.858 * mad / sqrt((double) frames) : 0.0;
+}
+
+/*********************************************************
+  Checks every metric of a run against the baseline, and
+  writes a line for each: the median and 95th percentile
+  then and now, how much slower the median is and how much
+  slower it was allowed to be.
+*********************************************************/
+bool SFPerfCompare(const SFRunSummary & base, const SFRunSummary & now, const SFPerfTolerance & tolerance, ostream & os) {
+  bool passed = true;
+  char line[160];
+  snprintf(line, sizeof(line), "  %-10s %10s %10s %8s %8s %10s %10s\n", "metric", "base ms", "now ms", "change", "limit", "base p95", "now p95");
+  os << line;
+
+  for(int m = 0; m < SF_PERF_METRICS; m++) {
+    double noise = tolerance.sigmas * sqrt(pow(StandardError(base.mad[m], base.frames), 2) + pow(StandardError(now.mad[m], now.frames), 2));
+    double limit = max(max(tolerance.relative * base.median[m], noise), tolerance.floorMs);
+    double p95Limit = max(tolerance.p95Relative * base.p95[m], tolerance.floorMs);
+
+    bool slower = now.median[m] - base.median[m] > limit;
+    bool spikier = now.p95[m] - base.p95[m] > p95Limit;
+    passed = passed && !slower && !spikier;
+
+    double change = base.median[m] > 0.0 ? 100.0 * (now.median[m] - base.median[m]) / base.median[m] : 0.0;
+    snprintf(line, sizeof(line), "  %-10s %10.4f %10.4f %+7.1f%% %8.4f %10.4f %10.4f  %s\n", SFPerfMetricName(m), base.median[m], now.median[m],
+             change, limit, base.p95[m], now.p95[m], slower ? "SLOWER" : (spikier ? "SPIKIER" : ""));
+    os << line;
+  }
+
+  bool allocs = now.allocs > base.allocs * (1.0 + tolerance.allocs) + 0.01;
+  passed = passed && !allocs;
+  snprintf(line, sizeof(line), "  %-10s %10.2f %10.2f  a frame  %s\n", "allocs", base.allocs, now.allocs, allocs ? "MORE" : "");
+  os << line;
+
+  return passed;
+}
@@ -0,0 +1,82 @@
+#ifndef SFPERFGATE_H
+#define SFPERFGATE_H
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+
+// What runs are compared on: each phase of the frame, then the whole frame
+static const int SF_PERF_METRICS = SFPHASE_LAST + 1;
+static const int SF_PERF_FRAME   = SFPHASE_LAST;
+
+const char * SFPerfMetricName(int metric);
+
+// One frame of a benchmark run
+struct SFFrameSample {
+  double phaseMs[SFPHASE_LAST];
+  int    allocs;
+};
+
+/**
+ * The numbers a run of a session is judged by. Medians rather than means,
+ * so a few slow frames (the OS taking the CPU away) don't move them, and
+ * the median absolute deviation to say how noisy the frames were.
+ */
+struct SFRunSummary {
+  long   frames;
+  double median[SF_PERF_METRICS];
+  double p95[SF_PERF_METRICS];
+  double mad[SF_PERF_METRICS];
+  double allocs;                   // Heap allocations a frame, on average
+
+  static SFRunSummary Of(const vector<SFFrameSample> &);
+
+  // The faster of two runs of the same session, metric by metric
+  static SFRunSummary Best(const SFRunSummary &, const SFRunSummary &);
+};
+
+/**
+ * How much slower a run can be before it counts as a regression. A
+ * median has to be slower by the relative amount and by more than the
+ * noise in the two runs (sigmas standard errors of the medians), and by
+ * at least floorMs, which keeps phases that take next to no time from
+ * failing on jitter.
+ */
+struct SFPerfTolerance {
+  double relative    = 0.10;
+  double sigmas      = 3.0;
+  double p95Relative = 0.25;
+  double floorMs     = 0.02;
+  double allocs      = 0.01;
+};
+
+/**
+ * A summary for each session, saved as CSV:
+ *
+ *   session,metric,frames,median_ms,p95_ms,mad_ms
+ *
+ * with one row for each metric and one for allocs (allocations a frame in
+ * the median column).
+ */
+class SFPerfBaseline {
+public:
+  bool     Load(const string & path);
+  bool     Save(const string & path) const;
+
+  bool     Has(const string & session) const;
+  const SFRunSummary & Get(const string & session) const;
+  void     Set(const string & session, const SFRunSummary &);
+
+private:
+  map<string, SFRunSummary> runs;
+};
+
+// Writes a table of every metric, then and now. Returns false if any of them regressed.
+bool SFPerfCompare(const SFRunSummary & base, const SFRunSummary & now, const SFPerfTolerance &, ostream &);
+
+#endif
@@ -0,0 +1,459 @@
+/*********************************************************
+  This is the profiler used to find out where the game
+  spends its time and heap allocations.
+
+  SFApp calls SFProfiler::BeginFrame() when a frame starts,
+  SFProfiler::BeginPhase() as it moves through the frame
+  (input, movement, collision, ...) and
+  SFProfiler::EndFrame() once the frame has been rendered.
+  The time spent in each phase is measured on the way.
+
+  The allocation hooks at the bottom of the file are only
+  compiled in when SF_ALLOC_TRACKING is defined, so normal
+  builds pay nothing for this.
+*********************************************************/
+
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <iomanip>
+#include <algorithm>
+
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+#include "SFProfiler.h"
+
+SFPHASE  SFProfiler::phase = SFPHASE_OTHER;
+long     SFProfiler::frame = 0;
+
+int      SFProfiler::frameAllocs[SFPHASE_LAST];
+size_t   SFProfiler::frameBytes[SFPHASE_LAST];
+long     SFProfiler::intervalAllocs[SFPHASE_LAST];
+size_t   SFProfiler::intervalBytes[SFPHASE_LAST];
+long     SFProfiler::totalAllocs[SFPHASE_LAST];
+size_t   SFProfiler::totalBytes[SFPHASE_LAST];
+
+size_t   SFProfiler::liveBytes = 0;
+size_t   SFProfiler::peakLiveBytes = 0;
+int      SFProfiler::lastFrameAllocs = 0;
+int      SFProfiler::peakFrameAllocs = 0;
+size_t   SFProfiler::peakFrameBytes = 0;
+long     SFProfiler::peakFrame = 0;
+
+SFProfiler::Clock::time_point SFProfiler::phaseStart = SFProfiler::Clock::now();
+SFProfiler::Clock::time_point SFProfiler::lastFrameEnd = SFProfiler::Clock::now();
+double   SFProfiler::phaseMs[SFPHASE_LAST];
+double   SFProfiler::lastPhaseMs[SFPHASE_LAST];
+double   SFProfiler::frameIntervalMs = 0.0;
+
+int      SFProfiler::drawCalls = 0;
+int      SFProfiler::lastDrawCalls = 0;
+int      SFProfiler::liveTextures = 0;
+
+SFEntityCounts SFProfiler::peakEntities = {0, 0, 0, 0, 0, 0};
+long     SFProfiler::peakResidentBytes = 0;
+long     SFProfiler::entityFrames = 0;
+FILE *   SFProfiler::memoryLog = nullptr;
+bool     SFProfiler::memoryLogEnabled = false;
+
+SFProfiler::CallSite SFProfiler::callSites[SFProfiler::SF_PROFILER_CALLSITES];
+FILE *   SFProfiler::csv = nullptr;
+
+bool SFProfiler::IsTracking() {
+#ifdef SF_ALLOC_TRACKING
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*********************************************************
+  Starts timing a new frame. Time spent waiting for the
+  frame to start isn't counted against any phase.
+*********************************************************/
+void SFProfiler::BeginFrame() {
+  phaseStart = Clock::now();
+  phase = SFPHASE_OTHER;
+}
+
+/*********************************************************
+  Everything that happens from now until the next call is
+  counted against this phase.
+*********************************************************/
+void SFProfiler::BeginPhase(SFPHASE p) {
+  phaseMs[phase] += MsSince(phaseStart);
+  phase = p;
+}
+
+// Milliseconds from `since` until now, and moves `since` to now
+double SFProfiler::MsSince(Clock::time_point & since) {
+  Clock::time_point now = Clock::now();
+  double ms = chrono::duration<double, milli>(now - since).count();
+  since = now;
+  return ms;
+}
+
+SFPHASE SFProfiler::GetPhase() {
+  return phase;
+}
+
+const char * SFProfiler::GetPhaseName(SFPHASE p) {
+  switch(p) {
+    case SFPHASE_INPUT:     return "input";
+    case SFPHASE_MOVEMENT:  return "movement";
+    case SFPHASE_COLLISION: return "collision";
+    case SFPHASE_EVENTS:    return "events";
+    case SFPHASE_CLEANUP:   return "cleanup";
+    case SFPHASE_HUD:       return "hud";
+    case SFPHASE_RENDER:    return "render";
+    default:                return "other";
+  }
+}
+
+int SFProfiler::GetFrameAllocs(SFPHASE p) {
+  return frameAllocs[p];
+}
+
+size_t SFProfiler::GetFrameBytes(SFPHASE p) {
+  return frameBytes[p];
+}
+
+double SFProfiler::GetPhaseMs(SFPHASE p) {
+  return lastPhaseMs[p];
+}
+
+// Everything but rendering counts as updating
+double SFProfiler::GetUpdateMs() {
+  double ms = 0.0;
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    if(p != SFPHASE_RENDER) {
+      ms += lastPhaseMs[p];
+    }
+  }
+  return ms;
+}
+
+// Time between the end of the last two frames
+double SFProfiler::GetFrameIntervalMs() {
+  return frameIntervalMs;
+}
+
+int SFProfiler::GetDrawCalls() {
+  return lastDrawCalls;
+}
+
+// Heap allocations in the last frame (0 unless built with -DSF_ALLOC_TRACKING)
+int SFProfiler::GetAllocs() {
+  return lastFrameAllocs;
+}
+
+// How many frames have finished
+long SFProfiler::GetFrame() {
+  return frame;
+}
+
+int SFProfiler::GetLiveTextures() {
+  return liveTextures;
+}
+
+/*********************************************************
+  How much memory the game is really using (its resident
+  set size). Only Linux is supported, elsewhere it's 0.
+*********************************************************/
+long SFProfiler::GetResidentBytes() {
+  long pages = 0;
+#ifdef __linux__
+  FILE * statm = fopen("/proc/self/statm", "r");
+  if(statm) {
+    long size;
+    if(fscanf(statm, "%ld %ld", &size, &pages) != 2) {
+      pages = 0;
+    }
+    fclose(statm);
+  }
+  return pages * sysconf(_SC_PAGESIZE);
+#else
+  return pages;
+#endif
+}
+
+/*********************************************************
+  Keeps the highest entity counts seen. Once a second (60
+  frames) the resident memory is checked too, and written
+  to sf_memory.csv along with the counts if asked for.
+  A healthy long game should have these level off.
+*********************************************************/
+void SFProfiler::TrackEntities(const SFEntityCounts & counts) {
+  peakEntities.aliens       = max(peakEntities.aliens, counts.aliens);
+  peakEntities.pProjectiles = max(peakEntities.pProjectiles, counts.pProjectiles);
+  peakEntities.eProjectiles = max(peakEntities.eProjectiles, counts.eProjectiles);
+  peakEntities.coins        = max(peakEntities.coins, counts.coins);
+  peakEntities.powers       = max(peakEntities.powers, counts.powers);
+  peakEntities.particles    = max(peakEntities.particles, counts.particles);
+
+  if(entityFrames++ % SF_PROFILER_RSS_FRAMES != 0) {
+    return;
+  }
+
+  long rss = GetResidentBytes();
+  peakResidentBytes = max(peakResidentBytes, rss);
+
+  if(!memoryLogEnabled) {
+    return;
+  }
+  if(!memoryLog) {
+    memoryLog = fopen("sf_memory.csv", "w");
+    if(!memoryLog) {
+      memoryLogEnabled = false;
+      return;
+    }
+    fprintf(memoryLog, "frame,resident_bytes,aliens,player_projectiles,enemy_projectiles,coins,powerups,particles\n");
+  }
+  fprintf(memoryLog, "%ld,%ld,%d,%d,%d,%d,%d,%d\n", entityFrames - 1, rss, counts.aliens, counts.pProjectiles,
+          counts.eProjectiles, counts.coins, counts.powers, counts.particles);
+  fflush(memoryLog);
+}
+
+void SFProfiler::SetMemoryLog(bool enabled) {
+  memoryLogEnabled = enabled;
+}
+
+void SFProfiler::PrintHighWater(ostream & out) {
+  out << "High-water: aliens " << peakEntities.aliens << " | player projectiles " << peakEntities.pProjectiles
+      << " | enemy projectiles " << peakEntities.eProjectiles << " | coins " << peakEntities.coins
+      << " | powerups " << peakEntities.powers << " | particles " << peakEntities.particles << " | resident memory " << peakResidentBytes / 1024 << " KiB" << endl;
+}
+
+void SFProfiler::CountDrawCalls(int calls) {
+  drawCalls += calls;
+}
+
+void SFProfiler::CountTextures(int delta) {
+  liveTextures += delta;
+}
+
+/*********************************************************
+  Stores this frame's timings, then rolls its allocation
+  counters into the interval and the
+  session totals, checks the high-water marks and writes a
+  CSV row every SF_PROFILER_CSV_FRAMES frames.
+*********************************************************/
+void SFProfiler::EndFrame() {
+  BeginPhase(SFPHASE_OTHER);
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    lastPhaseMs[p] = phaseMs[p];
+    phaseMs[p] = 0.0;
+  }
+  frameIntervalMs = MsSince(lastFrameEnd);
+  lastDrawCalls = drawCalls;
+  drawCalls = 0;
+
+  int allocs = 0;
+  size_t bytes = 0;
+
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    allocs += frameAllocs[p];
+    bytes  += frameBytes[p];
+    intervalAllocs[p] += frameAllocs[p];
+    intervalBytes[p]  += frameBytes[p];
+    totalAllocs[p]    += frameAllocs[p];
+    totalBytes[p]     += frameBytes[p];
+  }
+
+  lastFrameAllocs = allocs;
+  if(allocs > peakFrameAllocs) {
+    peakFrameAllocs = allocs;
+    peakFrameBytes  = bytes;
+    peakFrame       = frame;
+  }
+
+  frame++;
+  if(IsTracking() && frame % SF_PROFILER_CSV_FRAMES == 0) {
+    WriteCsvRow();
+  }
+
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    frameAllocs[p] = 0;
+    frameBytes[p]  = 0;
+  }
+  phase = SFPHASE_OTHER;
+}
+
+/*********************************************************
+  Appends the allocations made over the last interval to
+  sf_alloc.csv, one count and byte column per phase.
+*********************************************************/
+void SFProfiler::WriteCsvRow() {
+  if(!csv) {
+    csv = fopen("sf_alloc.csv", "w");
+    if(!csv) {
+      return;
+    }
+    fprintf(csv, "frame");
+    for(int p = 0; p < SFPHASE_LAST; p++) {
+      fprintf(csv, ",%s_allocs,%s_bytes", GetPhaseName((SFPHASE) p), GetPhaseName((SFPHASE) p));
+    }
+    fprintf(csv, ",live_bytes\n");
+  }
+
+  fprintf(csv, "%ld", frame);
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    fprintf(csv, ",%ld,%lu", intervalAllocs[p], (unsigned long) intervalBytes[p]);
+    intervalAllocs[p] = 0;
+    intervalBytes[p]  = 0;
+  }
+  fprintf(csv, ",%lu\n", (unsigned long) liveBytes);
+  fflush(csv);
+}
+
+/*********************************************************
+  Prints the session totals per phase, the high-water
+  marks and the call sites that allocated the most bytes.
+*********************************************************/
+void SFProfiler::PrintSummary(ostream & out) {
+  if(!IsTracking()) {
+    return;
+  }
+
+  long allocs = 0;
+  size_t bytes = 0;
+  out << endl << "Heap allocations over " << frame << " frame(s):" << endl;
+  for(int p = 0; p < SFPHASE_LAST; p++) {
+    allocs += totalAllocs[p];
+    bytes  += totalBytes[p];
+    out << "  " << setw(10) << left << GetPhaseName((SFPHASE) p) << right
+        << setw(10) << totalAllocs[p] << " allocs " << setw(12) << totalBytes[p] << " bytes";
+    if(frame > 0) {
+      out << " (" << (totalAllocs[p] / (double) frame) << " per frame)";
+    }
+    out << endl;
+  }
+  out << "  Total: " << allocs << " allocs, " << bytes << " bytes" << endl;
+  out << "  Worst frame: " << peakFrame << " with " << peakFrameAllocs << " allocs, " << peakFrameBytes << " bytes" << endl;
+  out << "  Peak live heap: " << peakLiveBytes << " bytes" << endl;
+
+  // Pick out the ten call sites with the most bytes allocated
+  static CallSite sites[SF_PROFILER_CALLSITES];
+  int used = 0;
+  for(int i = 0; i < SF_PROFILER_CALLSITES; i++) {
+    if(callSites[i].caller) {
+      sites[used++] = callSites[i];
+    }
+  }
+  int found = min(used, 10);
+  partial_sort(sites, sites + found, sites + used,
+               [](const CallSite & a, const CallSite & b) { return a.bytes > b.bytes; });
+
+  out << "  Top call sites:" << endl;
+  for(int i = 0; i < found; i++) {
+    out << "    " << setw(10) << sites[i].count << " allocs " << setw(12) << sites[i].bytes << " bytes  ";
+#ifdef __GLIBC__
+    // Resolves to module(symbol+offset), which addr2line understands
+    out << flush;
+    backtrace_symbols_fd(&sites[i].caller, 1, STDOUT_FILENO);
+#else
+    out << sites[i].caller << endl;
+#endif
+  }
+}
+
+void SFProfiler::RecordAlloc(size_t bytes, void * caller) {
+  frameAllocs[phase]++;
+  frameBytes[phase] += bytes;
+
+  liveBytes += bytes;
+  if(liveBytes > peakLiveBytes) {
+    peakLiveBytes = liveBytes;
+  }
+
+  // Open addressing on the caller address, the table never grows
+  size_t slot = (reinterpret_cast<uintptr_t>(caller) >> 2) % SF_PROFILER_CALLSITES;
+  for(int probe = 0; probe < SF_PROFILER_CALLSITES; probe++) {
+    CallSite & site = callSites[slot];
+    if(site.caller == caller || !site.caller) {
+      site.caller = caller;
+      site.count++;
+      site.bytes += bytes;
+      return;
+    }
+    slot = (slot + 1) % SF_PROFILER_CALLSITES;
+  }
+}
+
+void SFProfiler::RecordFree(size_t bytes) {
+  liveBytes -= bytes;
+}
+
+#ifdef SF_ALLOC_TRACKING
+/*********************************************************
+  Replacement global allocation functions. Each block gets
+  a small header holding its size so that delete knows how
+  many bytes are going back.
+*********************************************************/
+static const size_t SF_ALLOC_HEADER = 16;
+
+static void * TrackedAlloc(size_t bytes, void * caller) {
+  char * block = static_cast<char *>(malloc(bytes + SF_ALLOC_HEADER));
+  if(!block) {
+    return nullptr;
+  }
+  *reinterpret_cast<size_t *>(block) = bytes;
+  SFProfiler::RecordAlloc(bytes, caller);
+  return block + SF_ALLOC_HEADER;
+}
+
+static void TrackedFree(void * p) {
+  if(!p) {
+    return;
+  }
+  char * block = static_cast<char *>(p) - SF_ALLOC_HEADER;
+  SFProfiler::RecordFree(*reinterpret_cast<size_t *>(block));
+  free(block);
+}
+
+void * operator new(size_t bytes) {
+  void * p = TrackedAlloc(bytes, __builtin_return_address(0));
+  if(!p) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void * operator new[](size_t bytes) {
+  void * p = TrackedAlloc(bytes, __builtin_return_address(0));
+  if(!p) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void * operator new(size_t bytes, const nothrow_t &) noexcept {
+  return TrackedAlloc(bytes, __builtin_return_address(0));
+}
+
+void * operator new[](size_t bytes, const nothrow_t &) noexcept {
+  return TrackedAlloc(bytes, __builtin_return_address(0));
+}
+
+void operator delete(void * p) noexcept {
+  TrackedFree(p);
+}
+
+void operator delete[](void * p) noexcept {
+  TrackedFree(p);
+}
+
+void operator delete(void * p, const nothrow_t &) noexcept {
+  TrackedFree(p);
+}
+
+void operator delete[](void * p, const nothrow_t &) noexcept {
+  TrackedFree(p);
+}
+#endif
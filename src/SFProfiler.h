@@ -0,0 +1,115 @@
+#ifndef SFPROFILER_H
+#define SFPROFILER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <chrono>
+
+using namespace std;
+
+#include "SFCommon.h"
+
+/**
+ * Keeps track of which phase of the frame the game is in, how long each
+ * phase took and how many draw calls and textures there are. When built
+ * with -DSF_ALLOC_TRACKING (make FLAGS=-DSF_ALLOC_TRACKING), counts every
+ * heap allocation against that phase by hooking the global operator new
+ * and operator delete.
+ *
+ * Every SF_PROFILER_CSV_FRAMES frames a row of per-phase counts is appended
+ * to sf_alloc.csv, and PrintSummary() gives the totals at the end of a game.
+ */
+class SFProfiler {
+public:
+  static bool        IsTracking();
+  static void        BeginFrame();
+  static void        BeginPhase(SFPHASE);
+  static SFPHASE     GetPhase();
+  static const char* GetPhaseName(SFPHASE);
+  static void        EndFrame();
+  static void        PrintSummary(ostream &);
+
+  static int         GetFrameAllocs(SFPHASE);
+  static size_t      GetFrameBytes(SFPHASE);
+
+  // Timings and counts of the last finished frame
+  static double      GetPhaseMs(SFPHASE);
+  static double      GetUpdateMs();
+  static double      GetFrameIntervalMs();
+  static int         GetDrawCalls();
+  static int         GetAllocs();
+  static long        GetFrame();
+  static int         GetLiveTextures();
+
+  static long        GetResidentBytes();
+
+  // Memory and entity count high-water marks
+  static void        TrackEntities(const SFEntityCounts &);
+  static void        SetMemoryLog(bool);
+  static void        PrintHighWater(ostream &);
+
+  static void        CountDrawCalls(int calls);
+  static void        CountTextures(int delta);
+
+  // Called by the operator new/delete hooks, these must never allocate
+  static void        RecordAlloc(size_t bytes, void * caller);
+  static void        RecordFree(size_t bytes);
+
+private:
+  typedef chrono::steady_clock Clock;
+
+  static void        WriteCsvRow();
+  static double      MsSince(Clock::time_point &);
+
+  struct CallSite {
+    void * caller;
+    long   count;
+    size_t bytes;
+  };
+
+  static const int SF_PROFILER_CALLSITES  = 1024;
+  static const int SF_PROFILER_CSV_FRAMES = 60;
+  static const int SF_PROFILER_RSS_FRAMES = 60;
+
+  static SFPHASE   phase;
+  static long      frame;
+
+  // This frame, the current CSV interval, and the whole session
+  static int       frameAllocs[SFPHASE_LAST];
+  static size_t    frameBytes[SFPHASE_LAST];
+  static long      intervalAllocs[SFPHASE_LAST];
+  static size_t    intervalBytes[SFPHASE_LAST];
+  static long      totalAllocs[SFPHASE_LAST];
+  static size_t    totalBytes[SFPHASE_LAST];
+
+  // High-water marks
+  static size_t    liveBytes;
+  static size_t    peakLiveBytes;
+  static int       lastFrameAllocs;
+  static int       peakFrameAllocs;
+  static size_t    peakFrameBytes;
+  static long      peakFrame;
+
+  // Phase timing
+  static Clock::time_point phaseStart;
+  static Clock::time_point lastFrameEnd;
+  static double    phaseMs[SFPHASE_LAST];
+  static double    lastPhaseMs[SFPHASE_LAST];
+  static double    frameIntervalMs;
+
+  static int       drawCalls;
+  static int       lastDrawCalls;
+  static int       liveTextures;
+
+  static SFEntityCounts peakEntities;
+  static long      peakResidentBytes;
+  static long      entityFrames;
+  static FILE    * memoryLog;
+  static bool      memoryLogEnabled;
+
+  static CallSite  callSites[SF_PROFILER_CALLSITES];
+  static FILE    * csv;
+};
+
+#endif
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "SFRaster.h"
+
+#ifdef SF_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+// x / 255 rounded to the nearest, exact for anything up to 255 * 255
+static inline uint32_t Div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+/*********************************************************
+  One pixel of SDL_BLENDMODE_BLEND. Treating the source
+  alpha channel as 255 makes the alpha come out as
+  src.a + dst.a * (1 - src.a) from the same sum as the
+  colours, which is what lets the SSE2 kernel do all four
+  channels the same way. Fully opaque and fully clear
+  pixels come out of the sum unchanged too, the shortcuts
+  are only there for speed.
+*********************************************************/
+static inline uint32_t BlendPixel(uint32_t d, uint32_t s) {
+  uint32_t a = s & 0xFF;
+  if(a == 255) {
+    return s;
+  }
+  if(a == 0) {
+    return d;
+  }
+
+  uint32_t ia = 255 - a, out = 0;
+  s |= 0xFF;
+  for(int shift = 0; shift < 32; shift += 8) {
+    out |= Div255(((s >> shift) & 0xFF) * a + ((d >> shift) & 0xFF) * ia) << shift;
+  }
+  return out;
+}
+
+// The pixel with its alpha scaled by fade / 255, as SDL_SetTextureAlphaMod does
+static inline uint32_t FadePixel(uint32_t p, uint32_t fade) {
+  return (p & 0xFFFFFF00) | Div255((p & 0xFF) * fade);
+}
+
+/*********************************************************
+  One pixel of a premultiplied source: src + dst * (1 -
+  src.a) for all four channels. The colours have already
+  been multiplied by the alpha, so they're added as they
+  are, which also makes a clear pixel leave dst alone.
+*********************************************************/
+static inline uint32_t CompositePixel(uint32_t d, uint32_t s) {
+  uint32_t a = s & 0xFF;
+  if(a == 255) {
+    return s;
+  }
+  if(a == 0) {
+    return d;
+  }
+
+  uint32_t ia = 255 - a, out = 0;
+  for(int shift = 0; shift < 32; shift += 8) {
+    out |= min(((s >> shift) & 0xFF) + Div255(((d >> shift) & 0xFF) * ia), 255u) << shift;
+  }
+  return out;
+}
+
+// A premultiplied pixel faded by fade / 255, which scales its colours along with its alpha
+static inline uint32_t FadeComposite(uint32_t p, uint32_t fade) {
+  uint32_t out = 0;
+  for(int shift = 0; shift < 32; shift += 8) {
+    out |= Div255(((p >> shift) & 0xFF) * fade) << shift;
+  }
+  return out;
+}
+
+void SFBlendSpanScalar(uint32_t * dst, const uint32_t * src, int n) {
+  for(int i = 0; i < n; i++) {
+    dst[i] = BlendPixel(dst[i], src[i]);
+  }
+}
+
+#ifdef SF_RASTER_SSE2
+/*********************************************************
+  Four pixels at a time. Each half of the register is
+  widened to 16 bits a channel, so two pixels' worth of
+  s * a + d * (255 - a) fit in one multiply (at most
+  255 * 255, which leaves room for the rounding in
+  Div255). Sprites are mostly fully opaque or fully clear,
+  so four of either are dealt with without any maths.
+*********************************************************/
+void SFBlendSpanSSE2(uint32_t * dst, const uint32_t * src, int n) {
+  const __m128i zero   = _mm_setzero_si128();
+  const __m128i alpha  = _mm_set1_epi32(0xFF);
+  const __m128i max    = _mm_set1_epi16(255);
+  const __m128i half   = _mm_set1_epi16(128);
+
+  int i = 0;
+  for(; i + 4 <= n; i += 4) {
+    __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+    __m128i a = _mm_and_si128(s, alpha);
+
+    if(_mm_movemask_epi8(_mm_cmpeq_epi32(a, alpha)) == 0xFFFF) {
+      _mm_storeu_si128((__m128i *) (dst + i), s);
+      continue;
+    }
+    if(_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xFFFF) {
+      continue;
+    }
+
+    __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+    s = _mm_or_si128(s, alpha);
+
+    // Each pixel's alpha in all four of its 16 bit channels
+    a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+    __m128i aLo = _mm_unpacklo_epi32(a, a);
+    __m128i aHi = _mm_unpackhi_epi32(a, a);
+
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), aLo),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(max, aLo)));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), aHi),
+                               _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(max, aHi)));
+
+    lo = _mm_add_epi16(lo, half);
+    hi = _mm_add_epi16(hi, half);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+    _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(lo, hi));
+  }
+
+  SFBlendSpanScalar(dst + i, src + i, n - i);
+}
+#endif
+
+void SFBlendSpan(uint32_t * dst, const uint32_t * src, int n) {
+#ifdef SF_RASTER_SSE2
+  SFBlendSpanSSE2(dst, src, n);
+#else
+  SFBlendSpanScalar(dst, src, n);
+#endif
+}
+
+void SFBlendFill(uint32_t * dst, uint32_t colour, int n) {
+  uint32_t a = colour & 0xFF;
+  if(a == 255) {
+    fill(dst, dst + n, colour);
+    return;
+  }
+  for(int i = 0; i < n; i++) {
+    dst[i] = BlendPixel(dst[i], colour);
+  }
+}
+
+SFImage::SFImage() : w(0), h(0) {
+}
+
+SFImage::SFImage(int w, int h, uint32_t colour) : w(w), h(h), pixels(w * h, colour) {
+}
+
+SFImage::SFImage(int w, int h, const uint32_t * pixels) : w(w), h(h), pixels(pixels, pixels + w * h) {
+}
+
+int SFImage::GetWidth() const {
+  return w;
+}
+
+int SFImage::GetHeight() const {
+  return h;
+}
+
+uint32_t * SFImage::GetPixels() {
+  return pixels.data();
+}
+
+const uint32_t * SFImage::GetPixels() const {
+  return pixels.data();
+}
+
+uint32_t SFImage::GetPixel(int x, int y) const {
+  return pixels[y * w + x];
+}
+
+void SFImage::Clear(uint32_t colour) {
+  fill(pixels.begin(), pixels.end(), colour);
+}
+
+// Cuts a rectangle down to the part inside the image, false if there's nothing left
+bool SFImage::Clip(SFRect & r) const {
+  int x0 = max(r.x, 0), y0 = max(r.y, 0);
+  int x1 = min(r.x + r.w, w), y1 = min(r.y + r.h, h);
+  r.x = x0;
+  r.y = y0;
+  r.w = x1 - x0;
+  r.h = y1 - y0;
+  return r.w > 0 && r.h > 0;
+}
+
+void SFImage::Fill(const SFRect & rect, uint32_t colour) {
+  SFRect r = rect;
+  if(!Clip(r)) {
+    return;
+  }
+  for(int y = r.y; y < r.y + r.h; y++) {
+    SFBlendFill(&pixels[y * w + r.x], colour, r.w);
+  }
+}
+
+/*********************************************************
+  Blends part of src (all of it without a srcRect) over
+  dstRect, scaling it to fit by taking the nearest source
+  pixel to the middle of each destination pixel, which is
+  what SDL does without smoothing. The usual case is a
+  sprite drawn at its own size, which blends straight out
+  of the source rows. An alpha under 255 fades the whole
+  thing, for particles. A premultiplied source (a cached
+  layer) goes pixel by pixel, it's one copy a frame.
+*********************************************************/
+void SFImage::Blit(const SFImage & src, const SFRect * srcRect, const SFRect & dstRect, uint8_t alpha, SFBLEND blend) {
+  SFRect s = srcRect ? *srcRect : SFRect { 0, 0, src.w, src.h };
+  SFRect d = dstRect;
+  if(alpha == 0 || !src.Clip(s) || dstRect.w <= 0 || dstRect.h <= 0 || !Clip(d)) {
+    return;
+  }
+
+  bool sameSize = s.w == dstRect.w && s.h == dstRect.h;
+  if(!sameSize || alpha < 255 || blend == SFBLEND_PREMULTIPLIED) {
+    columns.resize(max((int) columns.size(), d.w));
+    for(int i = 0; i < d.w; i++) {
+      columns[i] = s.x + ((2 * (d.x + i - dstRect.x) + 1) * s.w) / (2 * dstRect.w);
+    }
+  }
+
+  for(int y = d.y; y < d.y + d.h; y++) {
+    int sy = s.y + ((2 * (y - dstRect.y) + 1) * s.h) / (2 * dstRect.h);
+    const uint32_t * in = &src.pixels[sy * src.w];
+    uint32_t * out = &pixels[y * w + d.x];
+
+    if(blend == SFBLEND_PREMULTIPLIED) {
+      for(int i = 0; i < d.w; i++) {
+        out[i] = CompositePixel(out[i], alpha < 255 ? FadeComposite(in[columns[i]], alpha) : in[columns[i]]);
+      }
+    }
+    else if(alpha < 255) {
+      for(int i = 0; i < d.w; i++) {
+        out[i] = BlendPixel(out[i], FadePixel(in[columns[i]], alpha));
+      }
+    }
+    else if(sameSize) {
+      SFBlendSpan(out, in + s.x + (d.x - dstRect.x), d.w);
+    }
+    else {
+      for(int i = 0; i < d.w; i++) {
+        out[i] = BlendPixel(out[i], in[columns[i]]);
+      }
+    }
+  }
+}
+
+// Bresenham's line, both ends included
+void SFImage::Line(int x0, int y0, int x1, int y1, uint32_t colour) {
+  int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+  int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+
+  while(true) {
+    if(x0 >= 0 && x0 < w && y0 >= 0 && y0 < h) {
+      SFBlendFill(&pixels[y0 * w + x0], colour, 1);
+    }
+    if(x0 == x1 && y0 == y1) {
+      break;
+    }
+    int e2 = 2 * err;
+    if(e2 >= dy) {
+      err += dy;
+      x0  += sx;
+    }
+    if(e2 <= dx) {
+      err += dx;
+      y0  += sy;
+    }
+  }
+}
+
+uint32_t SFImage::Checksum() const {
+  uint32_t hash = 2166136261u;
+  for(auto p : pixels) {
+    for(int shift = 24; shift >= 0; shift -= 8) {
+      hash = (hash ^ ((p >> shift) & 0xFF)) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+/*********************************************************
+  Writes the image as a PAM file (RGBA, what netpbm and
+  most image viewers read), for looking at a frame that
+  didn't match its golden checksum.
+*********************************************************/
+bool SFImage::Save(const string & path) const {
+  FILE * out = fopen(path.c_str(), "wb");
+  if(!out) {
+    return false;
+  }
+  fprintf(out, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", w, h);
+  for(auto p : pixels) {
+    unsigned char rgba[4] = { (unsigned char) (p >> 24), (unsigned char) (p >> 16), (unsigned char) (p >> 8), (unsigned char) p };
+    fwrite(rgba, 1, 4, out);
+  }
+  return fclose(out) == 0;
+}
@@ -0,0 +1,98 @@
+#ifndef SFRASTER_H
+#define SFRASTER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define SF_RASTER_SSE2
+#endif
+
+// A rectangle of pixels, y going down from the top left (the same layout as SDL_Rect)
+struct SFRect {
+  int x, y, w, h;
+};
+
+// A pixel position (the same layout as SDL_Point)
+struct SFPoint {
+  int x, y;
+};
+
+// How a Blit mixes the source into what's there. Blending into a clear image leaves premultiplied
+// colours behind (see SFLayerCache.h), which SFBLEND_PREMULTIPLIED puts down again unchanged.
+enum SFBLEND {SFBLEND_ALPHA, SFBLEND_PREMULTIPLIED};
+
+// One textured quad of a batch: a part of the texture, where it goes and how see-through (255 is as it is)
+struct SFSprite {
+  SFRect  src;
+  SFRect  dst;
+  uint8_t alpha;
+};
+
+// Packs a colour the way SFImage stores it, 0xRRGGBBAA
+inline uint32_t SFRgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+  return ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | a;
+}
+
+/*
+ * Alpha blending kernels. Each blends n source pixels over n destination
+ * pixels the way SDL_BLENDMODE_BLEND does:
+ *
+ *   dst.rgb = src.rgb * src.a + dst.rgb * (1 - src.a)
+ *   dst.a   = src.a + dst.a * (1 - src.a)
+ *
+ * in exact integer arithmetic (rounded to the nearest), so the SSE2 kernel
+ * gives the same bytes as the scalar one and a frame is the same on every
+ * machine. SFBlendSpan picks the fastest one built in.
+ */
+void SFBlendSpanScalar(uint32_t * dst, const uint32_t * src, int n);
+#ifdef SF_RASTER_SSE2
+void SFBlendSpanSSE2(uint32_t * dst, const uint32_t * src, int n);
+#endif
+void SFBlendSpan(uint32_t * dst, const uint32_t * src, int n);
+
+// Blends one colour over n destination pixels
+void SFBlendFill(uint32_t * dst, uint32_t colour, int n);
+
+/**
+ * An RGBA image in memory, one uint32_t per pixel (0xRRGGBBAA, which is
+ * SDL_PIXELFORMAT_RGBA8888), rows top to bottom with no padding. It's both
+ * what the software renderer draws into and what its textures are.
+ *
+ * Everything drawn is clipped to the image and blended, apart from Clear.
+ */
+class SFImage {
+public:
+  SFImage();
+  SFImage(int w, int h, uint32_t colour = 0);
+  SFImage(int w, int h, const uint32_t * pixels);
+
+  int         GetWidth() const;
+  int         GetHeight() const;
+  uint32_t  * GetPixels();
+  const uint32_t * GetPixels() const;
+  uint32_t    GetPixel(int x, int y) const;
+
+  void        Clear(uint32_t colour);
+  void        Fill(const SFRect &, uint32_t colour);
+  void        Blit(const SFImage & src, const SFRect * srcRect, const SFRect & dstRect, uint8_t alpha = 255, SFBLEND blend = SFBLEND_ALPHA);
+  void        Line(int x0, int y0, int x1, int y1, uint32_t colour);
+
+  // FNV-1a over the pixels, what the golden frame tests compare
+  uint32_t    Checksum() const;
+  bool        Save(const string & path) const;
+
+private:
+  bool        Clip(SFRect &) const;
+
+  int              w, h;
+  vector<uint32_t> pixels;
+
+  // Which source column each destination column of a scaled Blit comes from
+  vector<int>      columns;
+};
+
+#endif
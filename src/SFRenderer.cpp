@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <iostream>
+
+#include <SDL2/SDL_image.h>
+
+#include "SFRenderer.h"
+#include "SFSoftwareRenderer.h"
+#include "SFProfiler.h"
+
+// SFRect and SFPoint are handed straight to SDL, so they have to match its types
+static_assert(sizeof(SFRect) == sizeof(SDL_Rect) && sizeof(SFPoint) == sizeof(SDL_Point), "SFRect and SFPoint must match SDL_Rect and SDL_Point");
+
+SFTexture::SFTexture(int w, int h) : w(w), h(h) {
+}
+
+int SFTexture::GetWidth() const {
+  return w;
+}
+
+int SFTexture::GetHeight() const {
+  return h;
+}
+
+/*********************************************************
+  Makes the renderer picked on the command line. The SDL
+  one draws on the window, the software one doesn't need
+  one. Returns nullptr if SDL couldn't make a renderer.
+*********************************************************/
+shared_ptr<SFRenderer> SFRenderer::Create(SFRENDERER type, SDL_Window * window, bool vsync) {
+  switch(type) {
+    case SFRENDERER_SDL: {
+      SDL_Renderer * renderer = SDL_CreateRenderer(window, -1, vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+      if(!renderer) {
+        return nullptr;
+      }
+      return make_shared<SFSDLRenderer>(renderer);
+    }
+    case SFRENDERER_SOFTWARE:
+      return make_shared<SFSoftwareRenderer>(640, 480);
+  }
+  return nullptr;
+}
+
+shared_ptr<SFTexture> SFRenderer::Counted(SFTexture * texture) {
+  if(!texture) {
+    return nullptr;
+  }
+  SFProfiler::CountTextures(1);
+  return shared_ptr<SFTexture>(texture, [](SFTexture * t) {
+    delete t;
+    SFProfiler::CountTextures(-1);
+  });
+}
+
+void SFRenderer::RestoreDrawColour(uint32_t rgba) {
+  SetDrawColour(rgba >> 24, (rgba >> 16) & 0xFF, (rgba >> 8) & 0xFF, rgba & 0xFF);
+}
+
+/*********************************************************
+  Loads an image with SDL_image (which doesn't need a
+  window) and converts it to 0xRRGGBBAA pixels.
+*********************************************************/
+bool SFRenderer::LoadImage(const string & path, SFImage & out) {
+  SDL_Surface * loaded = IMG_Load(path.c_str());
+  if(!loaded) {
+    return false;
+  }
+  SDL_Surface * rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA8888, 0);
+  SDL_FreeSurface(loaded);
+  if(!rgba) {
+    return false;
+  }
+
+  out = SFImage(rgba->w, rgba->h);
+  SDL_LockSurface(rgba);
+  for(int y = 0; y < rgba->h; y++) {
+    const uint32_t * row = (const uint32_t *) ((const uint8_t *) rgba->pixels + y * rgba->pitch);
+    copy(row, row + rgba->w, out.GetPixels() + y * rgba->w);
+  }
+  SDL_UnlockSurface(rgba);
+  SDL_FreeSurface(rgba);
+  return true;
+}
+
+static int QueryWidth(SDL_Texture * texture) {
+  int w = 0;
+  SDL_QueryTexture(texture, NULL, NULL, &w, NULL);
+  return w;
+}
+
+static int QueryHeight(SDL_Texture * texture) {
+  int h = 0;
+  SDL_QueryTexture(texture, NULL, NULL, NULL, &h);
+  return h;
+}
+
+SFSDLTexture::SFSDLTexture(SDL_Texture * texture) : SFTexture(QueryWidth(texture), QueryHeight(texture)), texture(texture) {
+}
+
+SFSDLTexture::~SFSDLTexture() {
+  SDL_DestroyTexture(texture);
+}
+
+SDL_Texture * SFSDLTexture::GetTexture() {
+  return texture;
+}
+
+SFSDLRenderer::SFSDLRenderer(SDL_Renderer * renderer) : renderer(renderer), target(nullptr), colour({ 0, 0, 0, 255 }) {
+  // The overlay draws see-through boxes, which SDL only blends if it's asked to
+  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+}
+
+void SFSDLRenderer::GetOutputSize(int & w, int & h) {
+  SDL_GetRendererOutputSize(renderer, &w, &h);
+}
+
+SFTexture * SFSDLRenderer::LoadTexture(const string & path) {
+  SDL_Texture * texture = IMG_LoadTexture(renderer, path.c_str());
+  return texture ? new SFSDLTexture(texture) : nullptr;
+}
+
+SFTexture * SFSDLRenderer::CreateTexture(int w, int h, const uint32_t * pixels) {
+  SDL_Texture * texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, w, h);
+  if(!texture) {
+    return nullptr;
+  }
+  SDL_UpdateTexture(texture, NULL, pixels, w * sizeof(uint32_t));
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  return new SFSDLTexture(texture);
+}
+
+/*********************************************************
+  A texture SDL can draw into. It starts out as whatever
+  was in video memory, so it's cleared to see-through
+  before anything else draws into it.
+*********************************************************/
+SFTexture * SFSDLRenderer::CreateTarget(int w, int h) {
+  if(!SDL_RenderTargetSupported(renderer)) {
+    return nullptr;
+  }
+  SDL_Texture * texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+  if(!texture) {
+    return nullptr;
+  }
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+  SDL_SetRenderTarget(renderer, texture);
+  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+  SDL_RenderClear(renderer);
+  SDL_SetRenderDrawColor(renderer, colour.r, colour.g, colour.b, colour.a);
+  SDL_SetRenderTarget(renderer, target ? static_cast<SFSDLTexture *>(target)->GetTexture() : NULL);
+  return new SFSDLTexture(texture);
+}
+
+void SFSDLRenderer::SetTarget(SFTexture * texture) {
+  target = texture;
+  SDL_SetRenderTarget(renderer, texture ? static_cast<SFSDLTexture *>(texture)->GetTexture() : NULL);
+}
+
+/*********************************************************
+  SDL has no premultiplied blend mode of its own before
+  2.0.12, but any SDL since 2.0.6 can make one. If the
+  renderer can't do it the texture is left blending
+  normally, which only darkens see-through edges.
+*********************************************************/
+void SFSDLRenderer::SetBlend(SFTexture * texture, SFBLEND blend) {
+  SDL_Texture * t = static_cast<SFSDLTexture *>(texture)->GetTexture();
+  if(blend == SFBLEND_PREMULTIPLIED) {
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+    SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                                             SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if(SDL_SetTextureBlendMode(t, premultiplied) == 0) {
+      return;
+    }
+#endif
+  }
+  SDL_SetTextureBlendMode(t, SDL_BLENDMODE_BLEND);
+}
+
+void SFSDLRenderer::SetDrawColour(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+  colour = { r, g, b, a };
+  SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+uint32_t SFSDLRenderer::GetDrawColour() const {
+  return SFRgba(colour.r, colour.g, colour.b, colour.a);
+}
+
+void SFSDLRenderer::Clear() {
+  SDL_RenderClear(renderer);
+}
+
+void SFSDLRenderer::Copy(SFTexture * texture, const SFRect * src, const SFRect & dst) {
+  SDL_RenderCopy(renderer, static_cast<SFSDLTexture *>(texture)->GetTexture(), (const SDL_Rect *) src, (const SDL_Rect *) &dst);
+}
+
+/*********************************************************
+  With SDL 2.0.18 or later the whole batch is one
+  SDL_RenderGeometry call: two triangles a sprite, faded
+  by the vertex colour. Older SDL has to copy them one at
+  a time, setting the texture's alpha for each.
+*********************************************************/
+int SFSDLRenderer::CopyBatch(SFTexture * texture, const SFSprite * sprites, int count) {
+  SDL_Texture * t = static_cast<SFSDLTexture *>(texture)->GetTexture();
+  if(count <= 0) {
+    return 0;
+  }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  float u = 1.0f / texture->GetWidth(), v = 1.0f / texture->GetHeight();
+  vertices.resize(count * 4);
+  if((int) indices.size() < count * 6) {
+    indices.resize(count * 6);
+    for(int i = 0; i < count; i++) {
+      int q[6] = { 0, 1, 2, 2, 1, 3 };
+      for(int k = 0; k < 6; k++) {
+        indices[i * 6 + k] = i * 4 + q[k];
+      }
+    }
+  }
+
+  for(int i = 0; i < count; i++) {
+    const SFSprite & s = sprites[i];
+    SDL_Color colour = { 255, 255, 255, s.alpha };
+    for(int k = 0; k < 4; k++) {
+      SDL_Vertex & out = vertices[i * 4 + k];
+      int right = k & 1, bottom = k >> 1;
+      out.position.x  = (float) (s.dst.x + right * s.dst.w);
+      out.position.y  = (float) (s.dst.y + bottom * s.dst.h);
+      out.color       = colour;
+      out.tex_coord.x = (s.src.x + right * s.src.w) * u;
+      out.tex_coord.y = (s.src.y + bottom * s.src.h) * v;
+    }
+  }
+  SDL_RenderGeometry(renderer, t, vertices.data(), count * 4, indices.data(), count * 6);
+  return 1;
+#else
+  for(int i = 0; i < count; i++) {
+    SDL_SetTextureAlphaMod(t, sprites[i].alpha);
+    SDL_RenderCopy(renderer, t, (const SDL_Rect *) &sprites[i].src, (const SDL_Rect *) &sprites[i].dst);
+  }
+  SDL_SetTextureAlphaMod(t, 255);
+  return count;
+#endif
+}
+
+void SFSDLRenderer::FillRect(const SFRect & rect) {
+  SDL_RenderFillRect(renderer, (const SDL_Rect *) &rect);
+}
+
+void SFSDLRenderer::DrawLine(int x0, int y0, int x1, int y1) {
+  SDL_RenderDrawLine(renderer, x0, y0, x1, y1);
+}
+
+void SFSDLRenderer::DrawLines(const SFPoint * points, int count) {
+  SDL_RenderDrawLines(renderer, (const SDL_Point *) points, count);
+}
+
+void SFSDLRenderer::Present() {
+  SDL_RenderPresent(renderer);
+}
+
+/*********************************************************
+  SDL can only switch vsync on a renderer it's already
+  made from 2.0.18. Before that it's whatever the
+  renderer was made with.
+*********************************************************/
+bool SFSDLRenderer::SetVSync(bool vsync) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  return SDL_RenderSetVSync(renderer, vsync ? 1 : 0) == 0;
+#else
+  return false;
+#endif
+}
+
+const char * SFSDLRenderer::GetName() const {
+  return "sdl";
+}
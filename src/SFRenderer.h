@@ -0,0 +1,131 @@
+#ifndef SFRENDERER_H
+#define SFRENDERER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFRaster.h"
+
+/**
+ * An image a renderer can draw, made by the renderer that draws it.
+ */
+class SFTexture {
+public:
+  SFTexture(int w, int h);
+  virtual ~SFTexture() {}
+
+  int      GetWidth() const;
+  int      GetHeight() const;
+
+protected:
+  int      w, h;
+};
+
+/**
+ * Everything the game draws goes through one of these, so the same frame
+ * can go to the screen through SDL or into memory with no display at all
+ * (see SFSoftwareRenderer.h). It's the part of SDL_Renderer the game uses,
+ * with the same meanings: rectangles are in pixels from the top left,
+ * textures and the draw colour are alpha blended, apart from Clear.
+ */
+class SFRenderer {
+public:
+  virtual ~SFRenderer() {}
+
+  virtual void        GetOutputSize(int & w, int & h) = 0;
+
+  // Both return nullptr if the texture couldn't be made. CreateTexture takes 0xRRGGBBAA pixels.
+  virtual SFTexture * LoadTexture(const string & path) = 0;
+  virtual SFTexture * CreateTexture(int w, int h, const uint32_t * pixels) = 0;
+
+  // A see-through texture that can be drawn into, or nullptr if the renderer can't draw into textures
+  virtual SFTexture * CreateTarget(int w, int h) = 0;
+  // Where drawing goes: a texture from CreateTarget, or nullptr for the screen
+  virtual void        SetTarget(SFTexture *) = 0;
+  // How the texture is mixed in when it's copied. Textures start as SFBLEND_ALPHA.
+  virtual void        SetBlend(SFTexture *, SFBLEND) = 0;
+
+  virtual void        SetDrawColour(uint8_t r, uint8_t g, uint8_t b, uint8_t a) = 0;
+  // As 0xRRGGBBAA, so whatever changes it for a while can put it back with RestoreDrawColour
+  virtual uint32_t    GetDrawColour() const = 0;
+  void                RestoreDrawColour(uint32_t rgba);
+  virtual void        Clear() = 0;
+  virtual void        Copy(SFTexture *, const SFRect * src, const SFRect & dst) = 0;
+  // Lots of parts of one texture in one go, for particles. Returns how many draw calls it took.
+  virtual int         CopyBatch(SFTexture *, const SFSprite * sprites, int count) = 0;
+  virtual void        FillRect(const SFRect &) = 0;
+  virtual void        DrawLine(int x0, int y0, int x1, int y1) = 0;
+  virtual void        DrawLines(const SFPoint *, int count) = 0;
+  virtual void        Present() = 0;
+  // Whether Present waits for the display's refresh. False if the renderer can't change it.
+  virtual bool        SetVSync(bool) = 0;
+
+  virtual const char * GetName() const = 0;
+
+  static shared_ptr<SFRenderer> Create(SFRENDERER, SDL_Window *, bool vsync = false);
+
+  // Owns a texture a renderer made, counted by SFProfiler::CountTextures until it's deleted. nullptr stays nullptr.
+  static shared_ptr<SFTexture> Counted(SFTexture *);
+
+  // Loads an image file into memory as 0xRRGGBBAA pixels, without needing a renderer. False if it couldn't.
+  static bool         LoadImage(const string & path, SFImage & out);
+};
+
+class SFSDLTexture : public SFTexture {
+public:
+  SFSDLTexture(SDL_Texture *);
+  virtual ~SFSDLTexture();
+
+  SDL_Texture * GetTexture();
+
+private:
+  SDL_Texture * texture;
+};
+
+/**
+ * Draws with an SDL_Renderer on the window, which is what the game has
+ * always done. The SDL_Renderer goes when the window does.
+ */
+class SFSDLRenderer : public SFRenderer {
+public:
+  SFSDLRenderer(SDL_Renderer *);
+
+  void        GetOutputSize(int & w, int & h);
+  SFTexture * LoadTexture(const string & path);
+  SFTexture * CreateTexture(int w, int h, const uint32_t * pixels);
+  SFTexture * CreateTarget(int w, int h);
+  void        SetTarget(SFTexture *);
+  void        SetBlend(SFTexture *, SFBLEND);
+  void        SetDrawColour(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+  uint32_t    GetDrawColour() const;
+  void        Clear();
+  void        Copy(SFTexture *, const SFRect * src, const SFRect & dst);
+  int         CopyBatch(SFTexture *, const SFSprite * sprites, int count);
+  void        FillRect(const SFRect &);
+  void        DrawLine(int x0, int y0, int x1, int y1);
+  void        DrawLines(const SFPoint *, int count);
+  void        Present();
+  bool        SetVSync(bool);
+
+  const char * GetName() const;
+
+private:
+  SDL_Renderer * renderer;
+  SFTexture    * target;
+  SDL_Color      colour;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  // Kept from batch to batch so drawing one doesn't allocate
+  vector<SDL_Vertex> vertices;
+  vector<int>        indices;
+#endif
+};
+
+#endif
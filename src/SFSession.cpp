@@ -0,0 +1,91 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "SFSession.h"
+
+SFSession::SFSession(unsigned seed) : seed(seed) {
+}
+
+void SFSession::Record(const SFInputState & input) {
+  frames.push_back(input);
+}
+
+/*********************************************************
+  Reads a session saved by Save (or written by hand).
+  Returns false, after saying why, if the file can't be
+  read or a line doesn't make sense.
+*********************************************************/
+bool SFSession::Load(const string & path) {
+  ifstream in(path.c_str());
+  if(!in) {
+    cerr << "Could not open session " << path << endl;
+    return false;
+  }
+
+  frames.clear();
+  string line;
+  for(int number = 1; getline(in, line); number++) {
+    if(line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    istringstream words(line);
+    string first;
+    words >> first;
+    if(first == "seed") {
+      words >> seed;
+      continue;
+    }
+
+    int count = atoi(first.c_str());
+    string held;
+    SFInputState input;
+    if(!(words >> held >> input.fires) || count <= 0 || input.fires < 0 || held.find_first_not_of("UDLR-") != string::npos) {
+      cerr << path << ":" << number << ": expected <frames> <UDLR or -> <fires>" << endl;
+      return false;
+    }
+    input.up    = held.find('U') != string::npos;
+    input.down  = held.find('D') != string::npos;
+    input.left  = held.find('L') != string::npos;
+    input.right = held.find('R') != string::npos;
+    frames.insert(frames.end(), count, input);
+  }
+  return true;
+}
+
+bool SFSession::Save(const string & path) const {
+  ofstream out(path.c_str());
+  if(!out) {
+    cerr << "Could not write session " << path << endl;
+    return false;
+  }
+
+  out << "# StarShip Fontana input session, " << frames.size() << " frames" << endl;
+  out << "seed " << seed << endl;
+  for(size_t i = 0; i < frames.size(); ) {
+    size_t run = 1;
+    while(i + run < frames.size() && frames[i + run] == frames[i]) {
+      run++;
+    }
+
+    const SFInputState & f = frames[i];
+    string held = string(f.up ? "U" : "") + (f.down ? "D" : "") + (f.left ? "L" : "") + (f.right ? "R" : "");
+    out << run << " " << (held.empty() ? "-" : held) << " " << f.fires << endl;
+    i += run;
+  }
+  return (bool) out;
+}
+
+int SFSession::GetFrames() const {
+  return frames.size();
+}
+
+const SFInputState & SFSession::GetFrame(int i) const {
+  return frames[i];
+}
+
+unsigned SFSession::GetSeed() const {
+  return seed;
+}
@@ -0,0 +1,46 @@
+#ifndef SFSESSION_H
+#define SFSESSION_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#include "SFInput.h"
+
+/**
+ * The input of a game, one SFInputState per frame, so it can be played
+ * again exactly. The game is the same every time it's given the same
+ * input from the same random seed, so replaying a session replays the
+ * whole game, which is what the performance gate (tests/PerfGate.cpp)
+ * times. That holds only while nothing depends on how fast the machine
+ * is: waves have to spawn by count alone while recording and replaying
+ * (see SFSpawnBudget in SFWave.h).
+ *
+ * Saved as text, one line per run of identical frames:
+ *
+ *   seed 1
+ *   120 R 0      120 frames holding right, no fire
+ *   1 UL 1       one frame holding up and left, fire pressed once
+ *   60 - 0       60 frames with nothing held
+ *
+ * Lines starting with # are comments.
+ */
+class SFSession {
+public:
+  SFSession(unsigned seed = 1);
+
+  void     Record(const SFInputState &);
+  bool     Load(const string & path);
+  bool     Save(const string & path) const;
+
+  int      GetFrames() const;
+  const SFInputState & GetFrame(int) const;
+  unsigned GetSeed() const;
+
+private:
+  unsigned             seed;
+  vector<SFInputState> frames;
+};
+
+#endif
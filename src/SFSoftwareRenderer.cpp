@@ -0,0 +1,111 @@
+#include "SFSoftwareRenderer.h"
+
+SFSoftwareTexture::SFSoftwareTexture(const SFImage & image) : SFTexture(image.GetWidth(), image.GetHeight()), image(image), blend(SFBLEND_ALPHA) {
+}
+
+const SFImage & SFSoftwareTexture::GetImage() const {
+  return image;
+}
+
+SFImage & SFSoftwareTexture::GetImage() {
+  return image;
+}
+
+SFBLEND SFSoftwareTexture::GetBlend() const {
+  return blend;
+}
+
+void SFSoftwareTexture::SetBlend(SFBLEND blend) {
+  this->blend = blend;
+}
+
+SFSoftwareRenderer::SFSoftwareRenderer(int w, int h) : frame(w, h, SFRgba(0, 0, 0)), target(&frame), colour(SFRgba(0, 0, 0)), frames(0) {
+}
+
+void SFSoftwareRenderer::GetOutputSize(int & w, int & h) {
+  w = frame.GetWidth();
+  h = frame.GetHeight();
+}
+
+SFTexture * SFSoftwareRenderer::LoadTexture(const string & path) {
+  SFImage image;
+  return LoadImage(path, image) ? new SFSoftwareTexture(image) : nullptr;
+}
+
+SFTexture * SFSoftwareRenderer::CreateTexture(int w, int h, const uint32_t * pixels) {
+  return new SFSoftwareTexture(SFImage(w, h, pixels));
+}
+
+SFTexture * SFSoftwareRenderer::CreateTarget(int w, int h) {
+  return new SFSoftwareTexture(SFImage(w, h));
+}
+
+void SFSoftwareRenderer::SetTarget(SFTexture * texture) {
+  target = texture ? &static_cast<SFSoftwareTexture *>(texture)->GetImage() : &frame;
+}
+
+void SFSoftwareRenderer::SetBlend(SFTexture * texture, SFBLEND blend) {
+  static_cast<SFSoftwareTexture *>(texture)->SetBlend(blend);
+}
+
+void SFSoftwareRenderer::SetDrawColour(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+  colour = SFRgba(r, g, b, a);
+}
+
+uint32_t SFSoftwareRenderer::GetDrawColour() const {
+  return colour;
+}
+
+void SFSoftwareRenderer::Clear() {
+  target->Clear(colour);
+}
+
+void SFSoftwareRenderer::Copy(SFTexture * texture, const SFRect * src, const SFRect & dst) {
+  auto t = static_cast<SFSoftwareTexture *>(texture);
+  target->Blit(t->GetImage(), src, dst, 255, t->GetBlend());
+}
+
+// There are no draw calls to save in memory, so a batch is just a Blit each
+int SFSoftwareRenderer::CopyBatch(SFTexture * texture, const SFSprite * sprites, int count) {
+  auto t = static_cast<SFSoftwareTexture *>(texture);
+  for(int i = 0; i < count; i++) {
+    target->Blit(t->GetImage(), &sprites[i].src, sprites[i].dst, sprites[i].alpha, t->GetBlend());
+  }
+  return 1;
+}
+
+void SFSoftwareRenderer::FillRect(const SFRect & rect) {
+  target->Fill(rect, colour);
+}
+
+void SFSoftwareRenderer::DrawLine(int x0, int y0, int x1, int y1) {
+  target->Line(x0, y0, x1, y1, colour);
+}
+
+// Joins the points up in order, the same as SDL_RenderDrawLines
+void SFSoftwareRenderer::DrawLines(const SFPoint * points, int count) {
+  for(int i = 1; i < count; i++) {
+    target->Line(points[i - 1].x, points[i - 1].y, points[i].x, points[i].y, colour);
+  }
+}
+
+void SFSoftwareRenderer::Present() {
+  frames++;
+}
+
+// There's no display to wait for
+bool SFSoftwareRenderer::SetVSync(bool) {
+  return false;
+}
+
+const char * SFSoftwareRenderer::GetName() const {
+  return "software";
+}
+
+const SFImage & SFSoftwareRenderer::GetFrame() const {
+  return frame;
+}
+
+long SFSoftwareRenderer::GetFrames() const {
+  return frames;
+}
@@ -0,0 +1,63 @@
+#ifndef SFSOFTWARERENDERER_H
+#define SFSOFTWARERENDERER_H
+
+#include "SFRenderer.h"
+#include "SFRaster.h"
+
+class SFSoftwareTexture : public SFTexture {
+public:
+  SFSoftwareTexture(const SFImage &);
+
+  const SFImage & GetImage() const;
+  SFImage       & GetImage();
+
+  SFBLEND         GetBlend() const;
+  void            SetBlend(SFBLEND);
+
+private:
+  SFImage  image;
+  SFBLEND  blend;
+};
+
+/**
+ * Draws into an RGBA framebuffer in memory instead of on a window, using
+ * the blending kernels in SFRaster.h. It doesn't need a display or a GPU,
+ * so the stress test can run on a machine without either, and the same
+ * frame always comes out as the same bytes, which is what golden frame
+ * tests need. Present only counts the frame; what was drawn stays in
+ * GetFrame until the next Clear.
+ */
+class SFSoftwareRenderer : public SFRenderer {
+public:
+  SFSoftwareRenderer(int w, int h);
+
+  void        GetOutputSize(int & w, int & h);
+  SFTexture * LoadTexture(const string & path);
+  SFTexture * CreateTexture(int w, int h, const uint32_t * pixels);
+  SFTexture * CreateTarget(int w, int h);
+  void        SetTarget(SFTexture *);
+  void        SetBlend(SFTexture *, SFBLEND);
+  void        SetDrawColour(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+  uint32_t    GetDrawColour() const;
+  void        Clear();
+  void        Copy(SFTexture *, const SFRect * src, const SFRect & dst);
+  int         CopyBatch(SFTexture *, const SFSprite * sprites, int count);
+  void        FillRect(const SFRect &);
+  void        DrawLine(int x0, int y0, int x1, int y1);
+  void        DrawLines(const SFPoint *, int count);
+  void        Present();
+  bool        SetVSync(bool);
+
+  const char * GetName() const;
+
+  const SFImage & GetFrame() const;
+  long        GetFrames() const;
+
+private:
+  SFImage     frame;
+  SFImage   * target;     // The frame, or the image of a texture from CreateTarget
+  uint32_t    colour;
+  long        frames;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SFStarfield.h"
+
+// xorshift, the same as SFEffects uses, 0 to n - 1
+static int Random(uint32_t & state, int n) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return (state >> 8) % n;
+}
+
+/*********************************************************
+  Layer 0 is the farthest. Nearer layers are faster,
+  bigger and brighter, and have fewer stars: layer i of n
+  gets a share of n - i, so the far layer of three has
+  half of them.
+*********************************************************/
+SFStarfield::SFStarfield(unsigned seed, int w, int h, int layers, int stars) : w(w), h(h) {
+  int shares = layers * (layers + 1) / 2, given = 0;
+  for(int i = 0; i < layers; i++) {
+    float depth = (i + 1) / (float) layers;
+    SFStarLayer layer;
+    layer.count = stars * (layers - i) / shares;
+    layer.speed = depth;
+    layer.size  = 1 + (2 * i) / layers;
+    layer.alpha = (uint8_t) (96 + 159 * depth);
+    this->layers.push_back(layer);
+    given += layer.count;
+  }
+  // What the shares didn't divide evenly goes to the far layer
+  if(layers > 0) {
+    this->layers[0].count += stars - given;
+  }
+
+  offset.assign(layers, 0.0f);
+  uint32_t state = seed ? seed : 1;
+  for(int i = 0; i < layers; i++) {
+    first.push_back(x.size());
+    for(int s = 0; s < this->layers[i].count; s++) {
+      x.push_back(Random(state, w));
+      y.push_back(Random(state, h));
+    }
+  }
+}
+
+bool SFStarfield::Scroll(float pixels) {
+  bool moved = false;
+  for(size_t i = 0; i < layers.size(); i++) {
+    int before = (int) offset[i];
+    offset[i] = fmodf(offset[i] + pixels * layers[i].speed, (float) h);
+    moved = moved || (int) offset[i] != before;
+  }
+  return moved;
+}
+
+void SFStarfield::BuildSprites(vector<SFSprite> & out, int dotW, int dotH, int farthest) const {
+  for(size_t l = max(farthest, 0); l < layers.size(); l++) {
+    const SFStarLayer & layer = layers[l];
+    int scroll = (int) offset[l];
+    for(int i = first[l]; i < first[l] + layer.count; i++) {
+      int sy = (y[i] + scroll) % h;
+      out.push_back(SFSprite { { 0, 0, dotW, dotH }, { x[i], sy, layer.size, layer.size }, layer.alpha });
+    }
+  }
+}
+
+int SFStarfield::GetCount() const {
+  return x.size();
+}
+
+int SFStarfield::GetLayers() const {
+  return layers.size();
+}
+
+const SFStarLayer & SFStarfield::GetLayer(int i) const {
+  return layers[i];
+}
+
+int SFStarfield::LayerOf(int i) const {
+  int l = 0;
+  while(l + 1 < (int) first.size() && first[l + 1] <= i) {
+    l++;
+  }
+  return l;
+}
+
+int SFStarfield::GetX(int i) const {
+  return x[i];
+}
+
+int SFStarfield::GetY(int i) const {
+  return (y[i] + (int) offset[LayerOf(i)]) % h;
+}
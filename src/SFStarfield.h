@@ -0,0 +1,66 @@
+#ifndef SFSTARFIELD_H
+#define SFSTARFIELD_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+#include "SFRaster.h"
+
+/**
+ * One layer of the starfield. The nearer a layer is, the faster it
+ * scrolls past and the bigger and brighter its stars are.
+ */
+struct SFStarLayer {
+  int     count;
+  float   speed;      // Share of the scroll, 1 for the nearest layer
+  int     size;       // Pixels across
+  uint8_t alpha;
+};
+
+/**
+ * The stars behind everything, in layers that scroll at different speeds
+ * so the near ones seem to pass faster (parallax). The stars are placed
+ * once from a seed, with their own random numbers so the game's rand()
+ * comes out the same with any number of them. Scrolling only moves each
+ * layer's offset, and a star wraps from the bottom of the screen to the
+ * top, so there's never a seam or a gap.
+ *
+ * Drawing is a small square sprite for each star, all of them one
+ * SFRenderer::CopyBatch, which fills a few hundred pixels a frame instead
+ * of the two screens' worth stars.png used to.
+ *
+ * Positions are in screen space (0,0 at the top left), and the stars
+ * move down the screen.
+ */
+class SFStarfield {
+public:
+  // stars are shared out between the layers, the far ones getting the most
+  SFStarfield(unsigned seed, int w, int h, int layers, int stars);
+
+  // Moves each layer down by pixels times its speed. True if any star ended up on a different pixel.
+  bool                Scroll(float pixels);
+
+  // Adds a sprite for each star from layer farthest in, drawing the whole of a dotW by dotH texture
+  void                BuildSprites(vector<SFSprite> & out, int dotW, int dotH, int farthest = 0) const;
+
+  int                 GetCount() const;
+  int                 GetLayers() const;
+  const SFStarLayer & GetLayer(int) const;
+
+  // Where star i is on the screen, for tests
+  int                 GetX(int i) const;
+  int                 GetY(int i) const;
+
+private:
+  int                 LayerOf(int i) const;
+
+  int                 w, h;
+  vector<SFStarLayer> layers;
+  vector<float>       offset;    // How far each layer has scrolled, kept under h
+  vector<int>         first;     // Each layer's first star. A layer's stars are together.
+  vector<int16_t>     x, y;      // Where each star is with no scroll
+};
+
+#endif
@@ -0,0 +1,223 @@
+/*********************************************************
+  Sweep and prune broadphase (see SFSweepAndPrune.h).
+*********************************************************/
+
+#include <algorithm>
+
+#include "SFSweepAndPrune.h"
+
+SFSweepAndPrune::SFSweepAndPrune() : dirty(false), swaps(0), maxHeight(0.0f) {
+}
+
+SFProxyId SFSweepAndPrune::CreateProxy(const SFAABB & aabb, void * userData, SFFACTION faction) {
+  Proxy proxy = { aabb, userData, faction, true, true, -1 };
+
+  SFProxyId id;
+  if(!freeIds.empty()) {
+    id = freeIds.back();
+    freeIds.pop_back();
+    proxies[id] = proxy;
+  }
+  else {
+    proxies.push_back(proxy);
+    id = proxies.size() - 1;
+  }
+
+  // The values are filled in when the array is next sorted
+  Endpoint lo = { 0.0f, (unsigned) id << 1 }, hi = { 0.0f, ((unsigned) id << 1) | 1 };
+  endpoints.push_back(lo);
+  endpoints.push_back(hi);
+  dirty = true;
+  return id;
+}
+
+void SFSweepAndPrune::DestroyProxy(SFProxyId id) {
+  proxies[id].used = false;
+  proxies[id].userData = nullptr;
+  pendingFree.push_back(id);
+  dirty = true;
+}
+
+void SFSweepAndPrune::MoveProxy(SFProxyId id, const SFAABB & aabb, const Vector2 &) {
+  Proxy & p = proxies[id];
+  if(aabb.lo_y - p.aabb.lo_y > SF_SAP_JUMP || p.aabb.lo_y - aabb.lo_y > SF_SAP_JUMP) {
+    p.jumped = true;
+  }
+  p.aabb = aabb;
+  dirty = true;
+}
+
+void * SFSweepAndPrune::GetUserData(SFProxyId id) const {
+  return proxies[id].userData;
+}
+
+SFFACTION SFSweepAndPrune::GetFaction(SFProxyId id) const {
+  return proxies[id].faction;
+}
+
+int SFSweepAndPrune::GetProxyCount() const {
+  return proxies.size() - freeIds.size() - pendingFree.size();
+}
+
+// Bottoms go before tops at the same height, so boxes that only touch still count
+bool SFSweepAndPrune::Less(const Endpoint & a, const Endpoint & b) {
+  return a.value < b.value || (a.value == b.value && !(a.data & 1) && (b.data & 1));
+}
+
+/*********************************************************
+  Brings the endpoint array up to date: drops destroyed
+  proxies, copies in where everything moved to and puts it
+  back in order.
+*********************************************************/
+void SFSweepAndPrune::Sort() {
+  if(!dirty) {
+    return;
+  }
+  dirty = false;
+
+  // Refresh the values, leaving out destroyed boxes and pulling out ones that jumped
+  size_t kept = 0;
+  maxHeight = 0.0f;
+  jumped.clear();
+  for(size_t i = 0; i < endpoints.size(); i++) {
+    Endpoint e = endpoints[i];
+    const Proxy & p = proxies[e.data >> 1];
+    if(!p.used) {
+      continue;
+    }
+
+    e.value = (e.data & 1) ? p.aabb.hi_y : p.aabb.lo_y;
+    maxHeight = max(maxHeight, p.aabb.hi_y - p.aabb.lo_y);
+    if(p.jumped) {
+      jumped.push_back(e);
+    }
+    else {
+      endpoints[kept++] = e;
+    }
+  }
+  endpoints.resize(kept);
+
+  // Destroyed ids have no endpoints left now, so they can be reused
+  freeIds.insert(freeIds.end(), pendingFree.begin(), pendingFree.end());
+  pendingFree.clear();
+
+  // Everything else only moved a little, so this is nearly one pass
+  swaps = 0;
+  for(size_t i = 1; i < endpoints.size(); i++) {
+    Endpoint e = endpoints[i];
+    size_t j = i;
+    while(j > 0 && Less(e, endpoints[j - 1])) {
+      endpoints[j] = endpoints[j - 1];
+      j--;
+      swaps++;
+    }
+    endpoints[j] = e;
+  }
+
+  if(!jumped.empty()) {
+    for(auto & e : jumped) {
+      proxies[e.data >> 1].jumped = false;
+    }
+    sort(jumped.begin(), jumped.end(), Less);
+
+    merged.resize(endpoints.size() + jumped.size());
+    merge(endpoints.begin(), endpoints.end(), jumped.begin(), jumped.end(), merged.begin(), Less);
+    endpoints.swap(merged);
+  }
+}
+
+/*********************************************************
+  The sweep. Going up the array, a bottom endpoint opens a
+  box and a top one closes it. Every box that is open when
+  another opens overlaps it on Y, so only X is left to
+  check.
+*********************************************************/
+void SFSweepAndPrune::FindPairs(vector<SFProxyPair> & out) {
+  Sort();
+
+  for(int f = 0; f < SFFACTION_LAST; f++) {
+    active[f].clear();
+  }
+
+  for(const auto & e : endpoints) {
+    SFProxyId id = e.data >> 1;
+    Proxy & p = proxies[id];
+
+    if(e.data & 1) {
+      // Closing: swap the last open box of this faction into its place
+      vector<SFProxyId> & open = active[p.faction];
+      SFProxyId last = open.back();
+      open[p.active] = last;
+      proxies[last].active = p.active;
+      open.pop_back();
+      continue;
+    }
+
+    for(int f = 0; f < SFFACTION_LAST; f++) {
+      if(!SFFactionsMeet(p.faction, (SFFACTION) f)) {
+        continue;
+      }
+      for(auto other : active[f]) {
+        const SFAABB & o = proxies[other].aabb;
+        if(p.aabb.lo_x <= o.hi_x && o.lo_x <= p.aabb.hi_x) {
+          SFProxyPair pair = { id, other };
+          if(f < p.faction) {
+            swap(pair.a, pair.b);
+          }
+          out.push_back(pair);
+        }
+      }
+    }
+
+    p.active = active[p.faction].size();
+    active[p.faction].push_back(id);
+  }
+}
+
+/*********************************************************
+  Queries binary search for the lowest bottom that could
+  still reach the box (no box is taller than maxHeight)
+  and walk up the array until they're past its top.
+*********************************************************/
+void SFSweepAndPrune::Query(const SFAABB & aabb, vector<SFProxyId> & out) {
+  Sort();
+
+  Endpoint from = { aabb.lo_y - maxHeight, 0 };
+  for(auto e = lower_bound(endpoints.begin(), endpoints.end(), from, Less); e != endpoints.end(); ++e) {
+    if(e->value > aabb.hi_y) {
+      break;
+    }
+    if(!(e->data & 1) && proxies[e->data >> 1].aabb.Overlaps(aabb)) {
+      out.push_back(e->data >> 1);
+    }
+  }
+}
+
+void SFSweepAndPrune::QueryPoint(const Point2 & p, vector<SFProxyId> & out) {
+  SFAABB aabb = { p.getX(), p.getY(), p.getX(), p.getY() };
+  Query(aabb, out);
+}
+
+// A ray can cross the whole array, so this just tests every box
+void SFSweepAndPrune::RayCast(const Point2 & from, const Point2 & to, vector<SFRayHit> & out) {
+  Vector2 d = to - from;
+  for(size_t i = 0; i < proxies.size(); i++) {
+    float fraction;
+    if(proxies[i].used && proxies[i].aabb.RayHit(from, d, fraction)) {
+      SFRayHit hit = { (SFProxyId) i, fraction };
+      out.push_back(hit);
+    }
+  }
+}
+
+const char * SFSweepAndPrune::GetName() const {
+  return "sap";
+}
+
+int SFSweepAndPrune::GetSwaps() const {
+  return swaps;
+}
+
+bool SFSweepAndPrune::IsSorted() const {
+  return is_sorted(endpoints.begin(), endpoints.end(), Less);
+}
@@ -0,0 +1,91 @@
+#ifndef SFSWEEPANDPRUNE_H
+#define SFSWEEPANDPRUNE_H
+
+#include <vector>
+
+using namespace std;
+
+#include "SFBroadphase.h"
+
+// A box that moves further than this in one go (a respawn) is taken out and merged back in
+const float SF_SAP_JUMP = 64.0f;
+
+/**
+ * Sweep and prune along the Y axis. The top and bottom of every box are
+ * kept in one sorted array that is never thrown away. Almost everything
+ * in the game moves straight up or down at its own steady speed, so from
+ * one tick to the next that order hardly changes and an insertion sort
+ * puts it right in close to one pass. New boxes, and ones that jumped
+ * (an alien respawning at the top), would have to be shuffled past half
+ * the array, so they're sorted on their own and merged in instead.
+ *
+ * FindPairs then sweeps down the array keeping a list of open boxes for
+ * each faction. A box that opens only has to be checked against the open
+ * boxes of the factions it can hit, so a screen full of aliens is never
+ * tested alien against alien.
+ */
+class SFSweepAndPrune : public SFBroadphase {
+public:
+  SFSweepAndPrune();
+
+  SFProxyId CreateProxy(const SFAABB &, void * userData, SFFACTION);
+  void      DestroyProxy(SFProxyId);
+  void      MoveProxy(SFProxyId, const SFAABB &, const Vector2 & displacement);
+  void *    GetUserData(SFProxyId) const;
+  SFFACTION GetFaction(SFProxyId) const;
+  int       GetProxyCount() const;
+
+  void      Query(const SFAABB &, vector<SFProxyId> &);
+  void      QueryPoint(const Point2 &, vector<SFProxyId> &);
+  void      RayCast(const Point2 & from, const Point2 & to, vector<SFRayHit> &);
+  void      FindPairs(vector<SFProxyPair> &);
+
+  const char * GetName() const;
+
+  int       GetSwaps() const;
+  bool      IsSorted() const;
+
+private:
+  struct Proxy {
+    SFAABB    aabb;
+    void    * userData;
+    SFFACTION faction;
+    bool      used;
+    bool      jumped;   // New, or moved too far for the insertion sort
+    int       active;   // Where it is in its faction's open list during a sweep
+  };
+
+  // The top or bottom of a proxy's box. data is the proxy id << 1, plus 1 for the top
+  struct Endpoint {
+    float     value;
+    unsigned  data;
+  };
+
+  static bool Less(const Endpoint &, const Endpoint &);
+  void  Sort();
+
+  vector<Proxy>     proxies;
+  vector<Endpoint>  endpoints;
+
+  // Destroyed proxies still have endpoints in the array until the next
+  // sort, so their ids can't be handed out again until then
+  vector<SFProxyId> freeIds;
+  vector<SFProxyId> pendingFree;
+
+  // Something changed since the last sort
+  bool              dirty;
+
+  // Endpoints of boxes that jumped, and room to merge them back in
+  vector<Endpoint>  jumped;
+  vector<Endpoint>  merged;
+
+  // Swaps the insertion sort needed last time, a measure of how much the order changed
+  int               swaps;
+
+  // Tallest box, so a query knows how far below it to start looking
+  float             maxHeight;
+
+  vector<SFProxyId> active[SFFACTION_LAST];
+};
+
+#endif
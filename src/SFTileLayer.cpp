@@ -0,0 +1,99 @@
+#include <cmath>
+#include <iostream>
+
+#include "SFTileLayer.h"
+#include "SFAsset.h"
+#include "SFProfiler.h"
+
+SFTileLayer::SFTileLayer(shared_ptr<SFWindow> window, const SFTileMap & map) : sf_window(window), map(map), canBake(true), bakes(0) {
+  wall = SFAsset::LoadTexture(sf_window->getRenderer(), "assets/wall.png");
+  if(!wall) {
+    cerr << "Could not load assets/wall.png" << endl;
+    throw SF_ERROR_LOAD_ASSET;
+  }
+  for(int i = 0; i < SF_RESIDENT_CHUNKS; i++) {
+    bakedVersion[i] = -1;
+  }
+}
+
+/*********************************************************
+  Draws the chunks that are on the screen, baking any
+  that have streamed in since the last frame.
+*********************************************************/
+void SFTileLayer::OnRender() {
+  SFRenderer * renderer = sf_window->getRenderer();
+  int w, h;
+  renderer->GetOutputSize(w, h);
+
+  for(int slot = 0; slot < SF_RESIDENT_CHUNKS; slot++) {
+    const SFChunk & chunk = map.GetSlot(slot);
+    if(chunk.index < 0) {
+      continue;
+    }
+    int top = (int) floorf(h - map.GetChunkBottom(chunk.index) - SF_CHUNK_H);
+    if(top >= h || top + SF_CHUNK_H <= 0) {
+      continue;
+    }
+
+    if(canBake && bakedVersion[slot] != chunk.version) {
+      Bake(slot);
+    }
+    if(canBake) {
+      SFRect dst = { 0, top, SF_CHUNK_COLUMNS * SF_TILE_W, SF_CHUNK_H };
+      renderer->Copy(baked[slot].get(), NULL, dst);
+      SFProfiler::CountDrawCalls(1);
+    }
+    else {
+      DrawTiles(chunk, top);
+    }
+  }
+}
+
+/*********************************************************
+  Draws a slot's chunk into the slot's texture, making the
+  texture the first time. The texture is kept for the
+  next chunk to stream into the slot.
+*********************************************************/
+void SFTileLayer::Bake(int slot) {
+  SFRenderer * renderer = sf_window->getRenderer();
+  if(!baked[slot]) {
+    SFTexture * target = renderer->CreateTarget(SF_CHUNK_COLUMNS * SF_TILE_W, SF_CHUNK_H);
+    if(!target) {
+      canBake = false;
+      return;
+    }
+    baked[slot] = SFRenderer::Counted(target);
+  }
+
+  renderer->SetTarget(baked[slot].get());
+  uint32_t colour = renderer->GetDrawColour();
+  renderer->SetDrawColour(0, 0, 0, 0);
+  renderer->Clear();
+  DrawTiles(map.GetSlot(slot), 0);
+  renderer->SetTarget(nullptr);
+  renderer->RestoreDrawColour(colour);
+
+  bakedVersion[slot] = map.GetSlot(slot).version;
+  bakes++;
+}
+
+// Every wall of the chunk, one Copy each, with the top of the chunk at top
+void SFTileLayer::DrawTiles(const SFChunk & chunk, int top) {
+  SFRenderer * renderer = sf_window->getRenderer();
+  int calls = 0;
+  for(int row = 0; row < SF_CHUNK_ROWS; row++) {
+    for(int column = 0; column < SF_CHUNK_COLUMNS; column++) {
+      if(chunk.tiles[row][column] != SFTILE_WALL) {
+        continue;
+      }
+      SFRect dst = { column * SF_TILE_W, top + (SF_CHUNK_ROWS - 1 - row) * SF_TILE_H, SF_TILE_W, SF_TILE_H };
+      renderer->Copy(wall.get(), NULL, dst);
+      calls++;
+    }
+  }
+  SFProfiler::CountDrawCalls(calls);
+}
+
+long SFTileLayer::GetBakes() const {
+  return bakes;
+}
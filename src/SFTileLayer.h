@@ -0,0 +1,45 @@
+#ifndef SFTILELAYER_H
+#define SFTILELAYER_H
+
+#include <memory>
+
+using namespace std;
+
+#include "SFTileMap.h"
+#include "SFWindow.h"
+
+/**
+ * Draws an SFTileMap. The walls don't change once a chunk is streamed in,
+ * so each chunk is drawn into a texture of its own (baked) the first time
+ * it's seen and after that is one Copy, which makes a screen of walls
+ * three or four draw calls however many tiles it has. If the renderer
+ * can't draw into textures the tiles are drawn one by one instead.
+ *
+ * wall.png is squashed into each 32x16 tile. It's opaque, so baking it
+ * and blending the bake onto the screen comes out the same as drawing it
+ * straight onto the screen.
+ */
+class SFTileLayer {
+public:
+  SFTileLayer(shared_ptr<SFWindow>, const SFTileMap &);
+
+  void OnRender();
+
+  long GetBakes() const;
+
+private:
+  void Bake(int slot);
+  void DrawTiles(const SFChunk &, int top);
+
+  shared_ptr<SFWindow>  sf_window;
+  const SFTileMap     & map;
+  shared_ptr<SFTexture> wall;
+
+  // A baked texture for each of the map's slots, and which version of the slot's chunk is in it
+  shared_ptr<SFTexture> baked[SF_RESIDENT_CHUNKS];
+  int                   bakedVersion[SF_RESIDENT_CHUNKS];
+  bool                  canBake;
+  long                  bakes;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include <cmath>
+#include <cstring>
+
+#include "SFTileMap.h"
+
+// Mixes the numbers up into a random looking one, the same for the same numbers
+static uint32_t Hash(uint32_t a, uint32_t b, uint32_t c) {
+  uint32_t h = a * 0x9E3779B1u ^ b * 0x85EBCA77u ^ c * 0xC2B2AE3Du;
+  h ^= h >> 15;
+  h *= 0x2C1B3C6Du;
+  h ^= h >> 12;
+  h *= 0x297A2D39u;
+  h ^= h >> 15;
+  return h;
+}
+
+SFTileMap::SFTileMap(unsigned seed, int screenH) : seed(seed), screenH(screenH), scroll(0.0f), streamed(0), evicted(0) {
+  for(auto & slot : slots) {
+    slot.index   = -1;
+    slot.version = 0;
+    memset(slot.tiles, SFTILE_EMPTY, sizeof(slot.tiles));
+  }
+  Stream();
+}
+
+void SFTileMap::Advance(float pixels) {
+  scroll += pixels;
+  Stream();
+}
+
+/*********************************************************
+  Makes sure the chunks from the bottom of the screen to
+  one past the top are in their slots, and empties the
+  slots of any that have scrolled off the bottom.
+*********************************************************/
+void SFTileMap::Stream() {
+  int first = (int) floorf(scroll / SF_CHUNK_H);
+  int last  = (int) floorf((scroll + screenH + SF_CHUNK_H) / SF_CHUNK_H);
+  last = first + SF_RESIDENT_CHUNKS - 1 < last ? first + SF_RESIDENT_CHUNKS - 1 : last;
+
+  for(auto & slot : slots) {
+    if(slot.index >= 0 && slot.index < first) {
+      slot.index = -1;
+      evicted++;
+    }
+  }
+
+  for(int index = first; index <= last; index++) {
+    SFChunk & slot = slots[index % SF_RESIDENT_CHUNKS];
+    if(slot.index == index) {
+      continue;
+    }
+    if(slot.index >= 0) {
+      evicted++;
+    }
+    Generate(slot, index);
+    streamed++;
+  }
+}
+
+/*********************************************************
+  Lays out a chunk. The first two are left empty so the
+  game doesn't start in a wall. After that a chunk has up
+  to two walls across it, neither more than 11 tiles of
+  the 20, and sometimes a block between them, so there's
+  always a gap several times the width of the player.
+*********************************************************/
+void SFTileMap::Generate(SFChunk & chunk, int index) {
+  chunk.index = index;
+  chunk.version++;
+  memset(chunk.tiles, SFTILE_EMPTY, sizeof(chunk.tiles));
+  if(index < 2) {
+    return;
+  }
+
+  const int bands[2] = { 4, 12 };
+  for(int b = 0; b < 2; b++) {
+    uint32_t h = Hash(seed, index, b);
+    if(h % 4 == 0) {
+      continue;
+    }
+    int length = 4 + (h >> 2) % 8;
+    int start  = (h >> 5) % (SF_CHUNK_COLUMNS - length + 1);
+    memset(&chunk.tiles[bands[b]][start], SFTILE_WALL, length);
+  }
+
+  uint32_t h = Hash(seed, index, 2);
+  if(h % 2 == 0) {
+    int column = (h >> 1) % (SF_CHUNK_COLUMNS - 1);
+    chunk.tiles[7][column] = chunk.tiles[7][column + 1] = SFTILE_WALL;
+    chunk.tiles[8][column] = chunk.tiles[8][column + 1] = SFTILE_WALL;
+  }
+}
+
+const SFChunk * SFTileMap::Find(int index) const {
+  const SFChunk & slot = slots[index % SF_RESIDENT_CHUNKS];
+  return index >= 0 && slot.index == index ? &slot : nullptr;
+}
+
+// A tile by its column and its row from the start of the level. Anywhere not streamed in is empty.
+SFTILE SFTileMap::TileAt(int column, int row) const {
+  if(column < 0 || column >= SF_CHUNK_COLUMNS || row < 0) {
+    return SFTILE_EMPTY;
+  }
+  const SFChunk * chunk = Find(row / SF_CHUNK_ROWS);
+  return chunk ? (SFTILE) chunk->tiles[row % SF_CHUNK_ROWS][column] : SFTILE_EMPTY;
+}
+
+SFTILE SFTileMap::GetTile(float x, float y) const {
+  return TileAt((int) floorf(x / SF_TILE_W), (int) floorf((y + scroll) / SF_TILE_H));
+}
+
+bool SFTileMap::IsSolid(float x, float y) const {
+  return GetTile(x, y) == SFTILE_WALL;
+}
+
+/*********************************************************
+  Checks the tiles the box covers, at most a few for
+  anything the size of the player. A box that ends right
+  on the edge of a tile doesn't count as covering it.
+*********************************************************/
+bool SFTileMap::IsSolid(const SFAABB & box) const {
+  int x0 = (int) floorf(box.lo_x / SF_TILE_W), x1 = (int) ceilf(box.hi_x / SF_TILE_W) - 1;
+  int y0 = (int) floorf((box.lo_y + scroll) / SF_TILE_H), y1 = (int) ceilf((box.hi_y + scroll) / SF_TILE_H) - 1;
+
+  for(int row = y0; row <= y1; row++) {
+    for(int column = x0; column <= x1; column++) {
+      if(TileAt(column, row) == SFTILE_WALL) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+float SFTileMap::GetScroll() const {
+  return scroll;
+}
+
+const SFChunk & SFTileMap::GetSlot(int slot) const {
+  return slots[slot];
+}
+
+float SFTileMap::GetChunkBottom(int index) const {
+  return index * (float) SF_CHUNK_H - scroll;
+}
+
+long SFTileMap::GetStreamed() const {
+  return streamed;
+}
+
+long SFTileMap::GetEvicted() const {
+  return evicted;
+}
@@ -0,0 +1,80 @@
+#ifndef SFTILEMAP_H
+#define SFTILEMAP_H
+
+#include <cstdint>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFBroadphase.h"
+
+// Size of a tile in pixels, and of a chunk in tiles. A chunk is the width of the screen.
+static const int SF_TILE_W        = 32;
+static const int SF_TILE_H        = 16;
+static const int SF_CHUNK_COLUMNS = 20;
+static const int SF_CHUNK_ROWS    = 16;
+static const int SF_CHUNK_H       = SF_CHUNK_ROWS * SF_TILE_H;
+
+// How many chunks are kept at once: enough for a screen, one streamed in ahead and one on its way out
+static const int SF_RESIDENT_CHUNKS = 4;
+
+/**
+ * One screen wide piece of the level, SF_CHUNK_ROWS tiles high. Row 0 is
+ * the bottom row. version goes up every time a different chunk is streamed
+ * into the slot, so anything cached from it can tell it's out of date.
+ */
+struct SFChunk {
+  int     index;                                     // Which chunk of the level, -1 if the slot is empty
+  int     version;
+  uint8_t tiles[SF_CHUNK_ROWS][SF_CHUNK_COLUMNS];    // SFTILE values
+};
+
+/**
+ * The walls of the level: a grid of tiles that scrolls down the screen.
+ * Only the few chunks around the screen are kept, in a fixed ring of
+ * slots (chunk i always goes in slot i % SF_RESIDENT_CHUNKS), so scrolling
+ * any distance uses the same memory. Chunks are made as they stream in,
+ * from the seed and their index, so the level is endless and the same
+ * every time.
+ *
+ * Positions are in game space (0,0 at the bottom left of the screen).
+ * Finding the tile under a point is some division and an array index, so
+ * testing a box against the walls costs the handful of tiles it covers,
+ * however many walls there are.
+ */
+class SFTileMap {
+public:
+  SFTileMap(unsigned seed, int screenH);
+
+  // Scrolls the level down the screen, streaming chunks in ahead and dropping the ones gone past
+  void            Advance(float pixels);
+
+  SFTILE          GetTile(float x, float y) const;
+  bool            IsSolid(float x, float y) const;
+  bool            IsSolid(const SFAABB &) const;
+
+  float           GetScroll() const;
+  const SFChunk & GetSlot(int slot) const;
+
+  // Game space y of the bottom of a chunk, at the current scroll
+  float           GetChunkBottom(int index) const;
+
+  long            GetStreamed() const;
+  long            GetEvicted() const;
+
+private:
+  void            Stream();
+  void            Generate(SFChunk &, int index);
+  const SFChunk * Find(int index) const;
+  SFTILE          TileAt(int column, int row) const;
+
+  unsigned        seed;
+  int             screenH;
+  float           scroll;
+  SFChunk         slots[SF_RESIDENT_CHUNKS];
+
+  long            streamed;
+  long            evicted;
+};
+
+#endif
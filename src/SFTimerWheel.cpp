@@ -0,0 +1,168 @@
+#include "SFTimerWheel.h"
+
+SFTimerWheel::SFTimerWheel() : heads(ROOT_SLOTS + (LEVELS - 1) * LEVEL_SLOTS, -1), now(0), fired(0), cascaded(0) {
+}
+
+// Goes off delay ticks from now (at least the next tick)
+SFTimerId SFTimerWheel::Schedule(int delay, SFTIMER kind, SFHandle target, int data) {
+  return Add(delay, 0, kind, target, data);
+}
+
+// Goes off delay ticks from now and then every period ticks until it's cancelled
+SFTimerId SFTimerWheel::Repeat(int period, int delay, SFTIMER kind, SFHandle target, int data) {
+  return Add(delay, period < 1 ? 1 : period, kind, target, data);
+}
+
+SFTimerId SFTimerWheel::Add(uint32_t delay, uint32_t period, SFTIMER kind, SFHandle target, int data) {
+  SFTimerId id = ids.Create(nullptr);
+  int index = SFHandleIndex(id);
+  if(index >= (int) timers.size()) {
+    timers.resize(index + 1);
+  }
+
+  Timer & t = timers[index];
+  t.id      = id;
+  t.kind    = kind;
+  t.target  = target;
+  t.data    = data;
+  t.expires = now + (delay < 1 ? 1 : delay);
+  t.period  = period;
+  Link(index);
+  return id;
+}
+
+void SFTimerWheel::Cancel(SFTimerId id) {
+  if(!ids.IsValid(id)) {
+    return;
+  }
+  Unlink(SFHandleIndex(id));
+  ids.Destroy(id);
+}
+
+bool SFTimerWheel::IsPending(SFTimerId id) const {
+  return ids.IsValid(id);
+}
+
+/*********************************************************
+  Puts a timer in the slot for when it expires. Anything
+  due in the next 256 ticks goes straight in the root
+  level, later ones in the slot of the first level that
+  reaches that far. Anything further off than the wheel
+  goes round waits in the last slot and is put back in
+  when that slot cascades.
+*********************************************************/
+void SFTimerWheel::Link(int index) {
+  Timer & t = timers[index];
+  uint32_t delay = t.expires - now;
+
+  int slot;
+  if(delay < (uint32_t) ROOT_SLOTS) {
+    slot = t.expires & (ROOT_SLOTS - 1);
+  }
+  else {
+    int level = 1, shift = ROOT_BITS;
+    while(level < LEVELS - 1 && delay >= (1u << (shift + LEVEL_BITS))) {
+      level++;
+      shift += LEVEL_BITS;
+    }
+
+    uint32_t when = t.expires;
+    if(delay >= (1u << (shift + LEVEL_BITS))) {
+      when = now + (1u << (shift + LEVEL_BITS)) - 1;
+    }
+    slot = ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + ((when >> shift) & (LEVEL_SLOTS - 1));
+  }
+
+  t.slot = slot;
+  t.prev = -1;
+  t.next = heads[slot];
+  if(t.next != -1) {
+    timers[t.next].prev = index;
+  }
+  heads[slot] = index;
+}
+
+void SFTimerWheel::Unlink(int index) {
+  Timer & t = timers[index];
+  if(t.prev != -1) {
+    timers[t.prev].next = t.next;
+  }
+  else {
+    heads[t.slot] = t.next;
+  }
+  if(t.next != -1) {
+    timers[t.next].prev = t.prev;
+  }
+}
+
+// Empties one slot of a higher level back down the wheel
+void SFTimerWheel::Cascade(int level, int slot) {
+  int head = ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + slot;
+  int index = heads[head];
+  heads[head] = -1;
+
+  while(index != -1) {
+    int next = timers[index].next;
+    Link(index);
+    cascaded++;
+    index = next;
+  }
+}
+
+/*********************************************************
+  Moves the wheel on to the given tick, adding every timer
+  that went off on the way to the list. Repeating timers
+  are put back for their next turn, one-shot ones are
+  finished with and their ids go stale.
+*********************************************************/
+void SFTimerWheel::Advance(uint32_t tick, vector<SFTimerFired> & out) {
+  while(now != tick) {
+    now++;
+
+    int root = now & (ROOT_SLOTS - 1);
+    if(root == 0) {
+      // The root level came round, so bring down the next slot of each level that did too
+      for(int level = 1, shift = ROOT_BITS; level < LEVELS; level++, shift += LEVEL_BITS) {
+        int slot = (now >> shift) & (LEVEL_SLOTS - 1);
+        Cascade(level, slot);
+        if(slot != 0) {
+          break;
+        }
+      }
+    }
+
+    while(heads[root] != -1) {
+      int index = heads[root];
+      Timer & t = timers[index];
+      Unlink(index);
+
+      SFTimerFired f = { t.id, t.kind, t.target, t.data };
+      out.push_back(f);
+      fired++;
+
+      if(t.period) {
+        t.expires = now + t.period;
+        Link(index);
+      }
+      else {
+        ids.Destroy(t.id);
+      }
+    }
+  }
+}
+
+uint32_t SFTimerWheel::GetTick() const {
+  return now;
+}
+
+int SFTimerWheel::GetPending() const {
+  return ids.GetLive();
+}
+
+long SFTimerWheel::GetFired() const {
+  return fired;
+}
+
+long SFTimerWheel::GetCascaded() const {
+  return cascaded;
+}
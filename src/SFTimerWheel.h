@@ -0,0 +1,90 @@
+#ifndef SFTIMERWHEEL_H
+#define SFTIMERWHEEL_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFHandle.h"
+
+// Timers are referred to by handles, so cancelling one that already went off does nothing
+typedef SFHandle SFTimerId;
+
+// A timer that went off: what it was for, and the asset and number it was given
+struct SFTimerFired {
+  SFTimerId id;
+  SFTIMER   kind;
+  SFHandle  target;
+  int       data;
+};
+
+/**
+ * Schedules things to happen a number of simulation ticks from now, once
+ * or over and over, and lets them be cancelled.
+ *
+ * Timers are kept in a hierarchical wheel. The first level has a slot
+ * for each of the next 256 ticks. Each level after that has 64 slots
+ * that each cover a whole turn of the level below, and when the level
+ * below comes round again the next slot is emptied down into it. So
+ * scheduling and cancelling are O(1), and a tick only costs the timers
+ * that go off in it (plus the occasional cascade), however many are
+ * waiting.
+ *
+ * Advance() doesn't call anything, it fills in a list of the timers that
+ * went off for the caller to handle, like the broadphase does with pairs.
+ */
+class SFTimerWheel {
+public:
+  SFTimerWheel();
+
+  SFTimerId Schedule(int delay, SFTIMER kind, SFHandle target = SF_NULL_HANDLE, int data = 0);
+  SFTimerId Repeat(int period, int delay, SFTIMER kind, SFHandle target = SF_NULL_HANDLE, int data = 0);
+  void      Cancel(SFTimerId);
+  bool      IsPending(SFTimerId) const;
+
+  void      Advance(uint32_t tick, vector<SFTimerFired> & fired);
+
+  uint32_t  GetTick() const;
+  int       GetPending() const;
+  long      GetFired() const;
+  long      GetCascaded() const;
+
+private:
+  struct Timer {
+    SFTimerId id;
+    SFTIMER   kind;
+    SFHandle  target;
+    int       data;
+    uint32_t  expires;
+    uint32_t  period;   // 0 for a one-shot timer
+    int       slot;
+    int       prev;
+    int       next;
+  };
+
+  SFTimerId Add(uint32_t delay, uint32_t period, SFTIMER kind, SFHandle target, int data);
+  void      Link(int index);
+  void      Unlink(int index);
+  void      Cascade(int level, int slot);
+
+  static const int ROOT_BITS  = 8;
+  static const int LEVEL_BITS = 6;
+  static const int LEVELS     = 4;
+  static const int ROOT_SLOTS  = 1 << ROOT_BITS;
+  static const int LEVEL_SLOTS = 1 << LEVEL_BITS;
+
+  // Gives out the timer ids. A timer's index in timers is its handle's slot.
+  SFHandleTable   ids;
+  vector<Timer>   timers;
+
+  // First timer in each slot, the root level's slots then each level's in turn
+  vector<int>     heads;
+
+  uint32_t        now;
+  long            fired;
+  long            cascaded;
+};
+
+#endif
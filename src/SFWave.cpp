@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "SFWave.h"
+
+typedef chrono::steady_clock Clock;
+
+// The spawn band above the screen that aliens come down from
+static const float SF_WAVE_LEFT   = 32.0f;
+static const float SF_WAVE_RIGHT  = 632.0f;
+static const float SF_WAVE_TOP    = 600.0f;
+
+SFSpawnBudget::SFSpawnBudget(int spawns, double ms, double usualMs) : spawnsLeft(spawns), timed(ms > 0.0), msLeft(ms), usualMs(usualMs), spawned(0), usedMs(0.0) {
+}
+
+bool SFSpawnBudget::CanSpawn() const {
+  if(spawnsLeft <= 0) {
+    return false;
+  }
+  return spawned == 0 || !timed || usualMs <= msLeft;
+}
+
+void SFSpawnBudget::Spent(double ms) {
+  spawnsLeft--;
+  msLeft -= ms;
+  usedMs += ms;
+  spawned++;
+}
+
+int SFSpawnBudget::GetSpawned() const {
+  return spawned;
+}
+
+double SFSpawnBudget::GetUsedMs() const {
+  return usedMs;
+}
+
+SFWave::SFWave(const char * name) : name(name), step(0), progress(0), repeats(0) {
+}
+
+SFWave & SFWave::Spawn(int count, SFWAVEPATTERN pattern) {
+  SFWaveStep s = { SFWAVE_SPAWN, count, pattern };
+  steps.push_back(s);
+  return *this;
+}
+
+SFWave & SFWave::Wait(int ticks) {
+  SFWaveStep s = { SFWAVE_WAIT, ticks, SFWAVE_RANDOM };
+  steps.push_back(s);
+  return *this;
+}
+
+SFWave & SFWave::WaitFewer(int aliens) {
+  SFWaveStep s = { SFWAVE_WAIT_FEWER, aliens, SFWAVE_RANDOM };
+  steps.push_back(s);
+  return *this;
+}
+
+SFWave & SFWave::Repeat(int times) {
+  SFWaveStep s = { SFWAVE_REPEAT, times, SFWAVE_RANDOM };
+  steps.push_back(s);
+  return *this;
+}
+
+/*********************************************************
+  Carries the script on from where it stopped. Each step
+  either finishes and moves on, or leaves progress where
+  it got to and returns, to pick up from there next time:
+  a spawn that ran out of budget, or a wait that isn't
+  over (a wait uses up this tick).
+*********************************************************/
+bool SFWave::Resume(SFWaveHost & host, SFSpawnBudget & budget) {
+  while(step < (int) steps.size()) {
+    const SFWaveStep & s = steps[step];
+
+    switch(s.op) {
+      case SFWAVE_SPAWN:
+        while(progress < s.count) {
+          if(!budget.CanSpawn()) {
+            return false;
+          }
+          Clock::time_point start = Clock::now();
+          host.SpawnWaveAlien(PatternPosition(s.pattern, progress, s.count));
+          budget.Spent(chrono::duration<double, milli>(Clock::now() - start).count());
+          progress++;
+        }
+        break;
+
+      case SFWAVE_WAIT:
+        if(progress < s.count) {
+          progress++;
+          return false;
+        }
+        break;
+
+      case SFWAVE_WAIT_FEWER:
+        if(host.GetAlienCount() >= s.count) {
+          return false;
+        }
+        break;
+
+      case SFWAVE_REPEAT:
+        if(repeats < s.count) {
+          repeats++;
+          step = 0;
+          progress = 0;
+          continue;
+        }
+        repeats = 0;
+        break;
+    }
+
+    step++;
+    progress = 0;
+  }
+  return true;
+}
+
+bool SFWave::IsFinished() const {
+  return step >= (int) steps.size();
+}
+
+const char * SFWave::GetName() const {
+  return name;
+}
+
+/*********************************************************
+  Where alien index of count goes in a pattern. Lines are
+  spread evenly across the band and a vee points down at
+  the middle of the screen, both just above the top.
+*********************************************************/
+Point2 SFWave::PatternPosition(SFWAVEPATTERN pattern, int index, int count) {
+  switch(pattern) {
+    case SFWAVE_LINE: {
+      float gap = (SF_WAVE_RIGHT - SF_WAVE_LEFT) / count;
+      return Point2(SF_WAVE_LEFT + gap * (index + 0.5f), SF_WAVE_TOP);
+    }
+    case SFWAVE_VEE: {
+      // The point first, then one each side of it per row
+      int row = (index + 1) / 2;
+      float side = (index % 2) ? -1.0f : 1.0f;
+      return Point2(320.0f + side * 48.0f * row, SF_WAVE_TOP + 40.0f * row);
+    }
+    default:
+      return Point2(rand() % 600 + 32, rand() % 400 + 600);
+  }
+}
+
+SFWaveRunner::SFWaveRunner(int spawnsPerFrame, double budgetMs) : spawnsPerFrame(spawnsPerFrame), budgetMs(budgetMs),
+  usualMs(0.0), spawned(0), deferred(0), worstMs(0.0) {
+}
+
+void SFWaveRunner::Start(const SFWave & wave) {
+  waves.push_back(wave);
+}
+
+/*********************************************************
+  Gives each running wave a turn with what's left of this
+  frame's budget, and drops the ones that finished.
+*********************************************************/
+void SFWaveRunner::Update(SFWaveHost & host) {
+  if(waves.empty()) {
+    return;
+  }
+
+  SFSpawnBudget budget(spawnsPerFrame, budgetMs, usualMs);
+  size_t kept = 0;
+  for(size_t i = 0; i < waves.size(); i++) {
+    if(!waves[i].Resume(host, budget)) {
+      waves[kept++] = waves[i];
+    }
+  }
+  waves.erase(waves.begin() + kept, waves.end());
+
+  int count = budget.GetSpawned();
+  if(count > 0) {
+    spawned += count;
+    worstMs = max(worstMs, budget.GetUsedMs());
+
+    // Leans towards recent spawns, a slow first one shouldn't hold every wave back for good
+    usualMs = usualMs == 0.0 ? budget.GetUsedMs() / count : 0.8 * usualMs + 0.2 * budget.GetUsedMs() / count;
+  }
+  if(!budget.CanSpawn() && !waves.empty()) {
+    deferred++;
+  }
+}
+
+int SFWaveRunner::GetRunning() const {
+  return waves.size();
+}
+
+long SFWaveRunner::GetSpawned() const {
+  return spawned;
+}
+
+long SFWaveRunner::GetDeferred() const {
+  return deferred;
+}
+
+double SFWaveRunner::GetWorstMs() const {
+  return worstMs;
+}
@@ -0,0 +1,139 @@
+#ifndef SFWAVE_H
+#define SFWAVE_H
+
+#include <vector>
+
+using namespace std;
+
+#include "SFMath.h"
+
+// Where the aliens of a spawn step go (all of them start above the screen)
+enum SFWAVEPATTERN {SFWAVE_RANDOM, SFWAVE_LINE, SFWAVE_VEE};
+
+// What a step of a wave script does
+enum SFWAVEOP {SFWAVE_SPAWN, SFWAVE_WAIT, SFWAVE_WAIT_FEWER, SFWAVE_REPEAT};
+
+/**
+ * One step of a wave script.
+ *
+ *   SPAWN       count aliens in the given pattern
+ *   WAIT        count ticks
+ *   WAIT_FEWER  until there are fewer than count aliens
+ *   REPEAT      go back to the start of the script count more times
+ */
+struct SFWaveStep {
+  SFWAVEOP      op;
+  int           count;
+  SFWAVEPATTERN pattern;
+};
+
+/**
+ * What a wave needs from the game: somewhere to put an alien and how
+ * many there are.
+ */
+class SFWaveHost {
+public:
+  virtual ~SFWaveHost() {}
+
+  virtual void SpawnWaveAlien(const Point2 &) = 0;
+  virtual int  GetAlienCount() = 0;
+};
+
+/**
+ * How much spawning one frame can still do: a number of aliens and a
+ * time limit. An alien is only spawned if what a spawn usually costs
+ * still fits, apart from the first one of the frame, so a wave always
+ * gets somewhere.
+ *
+ * With no time limit (ms of 0) only the number of aliens counts. The time
+ * a spawn takes depends on the machine, so anything that has to play the
+ * same game every time (recording or replaying a session, see SFSession.h)
+ * must spawn by count only.
+ */
+class SFSpawnBudget {
+public:
+  SFSpawnBudget(int spawns, double ms, double usualMs);
+
+  bool     CanSpawn() const;
+  void     Spent(double ms);
+
+  int      GetSpawned() const;
+  double   GetUsedMs() const;
+
+private:
+  int      spawnsLeft;
+  bool     timed;      // False if only the count limits it
+  double   msLeft;
+  double   usualMs;
+  int      spawned;
+  double   usedMs;
+};
+
+/**
+ * A wave script that runs a bit at a time. Resume carries on from
+ * wherever it stopped last time, until the script has to wait or the
+ * frame's spawn budget runs out, so a big wave is spread over several
+ * frames instead of all landing in one. It's a coroutine written out by
+ * hand: the step it's on and how far through that step it is are all
+ * the state it needs.
+ */
+class SFWave {
+public:
+  SFWave(const char * name);
+
+  SFWave & Spawn(int count, SFWAVEPATTERN = SFWAVE_RANDOM);
+  SFWave & Wait(int ticks);
+  SFWave & WaitFewer(int aliens);
+  SFWave & Repeat(int times);
+
+  // Returns true once the script has finished
+  bool     Resume(SFWaveHost &, SFSpawnBudget &);
+  bool     IsFinished() const;
+
+  const char * GetName() const;
+
+private:
+  Point2   PatternPosition(SFWAVEPATTERN, int index, int count);
+
+  const char *        name;
+  vector<SFWaveStep>  steps;
+
+  // Where the script is up to
+  int      step;
+  int      progress;   // Aliens spawned or ticks waited in the current step
+  int      repeats;    // Times the current REPEAT has gone back
+};
+
+/**
+ * Runs the waves that have been started, a slice of each every tick, in
+ * the order they were started. The main loop calls Update once per tick
+ * with the budget for the frame, and whatever doesn't fit waits for the
+ * next one.
+ */
+class SFWaveRunner {
+public:
+  // budgetMs of 0 limits each frame by spawnsPerFrame alone (see SFSpawnBudget)
+  SFWaveRunner(int spawnsPerFrame, double budgetMs);
+
+  void     Start(const SFWave &);
+  void     Update(SFWaveHost &);
+
+  int      GetRunning() const;
+  long     GetSpawned() const;
+  long     GetDeferred() const;
+  double   GetWorstMs() const;
+
+private:
+  vector<SFWave> waves;
+  int      spawnsPerFrame;
+  double   budgetMs;
+
+  // Running average of what one spawn costs, so the budget knows if another fits
+  double   usualMs;
+
+  long     spawned;
+  long     deferred;   // Frames that used up the budget with waves still running
+  double   worstMs;    // Most time spawning took in one frame
+};
+
+#endif
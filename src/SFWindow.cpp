@@ -1,12 +1,12 @@
 #include "SFWindow.h"
 
-SFWindow::SFWindow(SDL_Window * w, SDL_Renderer * r): window(w), renderer(r) {
+SFWindow::SFWindow(SDL_Window * w, shared_ptr<SFRenderer> r): window(w), renderer(r) {
 }
 
 SDL_Window * SFWindow::getWindow() {
   return window;
 }
 
-SDL_Renderer * SFWindow::getRenderer() {
-  return renderer;
+SFRenderer * SFWindow::getRenderer() {
+  return renderer.get();
 }
@@ -1,16 +1,22 @@
 #ifndef SFWINDOW_H
 #define SFWINDOW_H
 
+#include <memory>
+
 #include <SDL2/SDL.h>
 
+using namespace std;
+
+#include "SFRenderer.h"
+
 class SFWindow {
  public:
-  SFWindow(SDL_Window*, SDL_Renderer*);
+  SFWindow(SDL_Window*, shared_ptr<SFRenderer>);
   SDL_Window* getWindow();
-  SDL_Renderer* getRenderer();
+  SFRenderer* getRenderer();
  private:
-  SDL_Window*   window;
-  SDL_Renderer* renderer;
+  SDL_Window*   window;     // nullptr with the software renderer
+  shared_ptr<SFRenderer> renderer;
 };
 
 #endif
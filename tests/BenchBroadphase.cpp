@@ -0,0 +1,243 @@
+/*********************************************************
+  Benchmark for the broadphases.
+
+  Runs what OnUpdateWorld does each tick: every entity
+  moves and has its proxy updated, then every projectile
+  queries for the entities it might hit. This is done for
+  a few ways of spreading the entities out:
+
+    uniform   spread evenly over the screen
+    band      the game's spawn band above the screen, all
+              falling at one of a few speeds
+    clustered tight groups, so many boxes overlap
+    mixed     sizes from projectiles up to the stars
+              background, the case a grid handles badly
+
+  Then FindPairs is timed on a copy of the game's own
+  motion: aliens and pickups falling at their speeds and
+  wrapping round, player shots going up, enemy shots
+  coming down from emitters, and the player sweeping from
+  side to side.
+
+  Build and run with `make bench`.
+*********************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+#include "SFBroadphase.h"
+#include "SFAABBTree.h"
+#include "SFSweepAndPrune.h"
+
+static const int TICKS       = 200;
+static const int PROJECTILES = 200;
+static const int EMITTERS    = 50;
+
+typedef chrono::steady_clock Clock;
+
+enum Layout {UNIFORM, BAND, CLUSTERED, MIXED};
+static const char * layoutNames[] = {"uniform", "band", "clustered", "mixed"};
+
+struct Entity {
+  SFAABB    box;
+  Vector2   velocity;
+  SFFACTION faction;
+  SFProxyId proxy;
+};
+
+static float Rand(float lo, float hi) {
+  return lo + (hi - lo) * (rand() / (float) RAND_MAX);
+}
+
+static SFAABB Box(float x, float y, float w, float h) {
+  SFAABB b = { x - w / 2.0f, y - h / 2.0f, x + w / 2.0f, y + h / 2.0f };
+  return b;
+}
+
+static vector<Entity> MakeEntities(Layout layout, int count) {
+  static const float sizes[][2] = { {19, 18}, {50, 50}, {32, 32}, {163, 52}, {700, 700} };
+  vector<Entity> entities;
+  float cx = 0.0f, cy = 0.0f;
+
+  for(int i = 0; i < count; i++) {
+    Entity e = { Box(0, 0, 32, 32), Vector2(0.0f, -2.0f - (i % 4)), SFFACTION_ALIEN, SF_NULL_PROXY };
+    switch(layout) {
+      case UNIFORM:
+        e.box = Box(Rand(0, 640), Rand(0, 480), 32, 32);
+        break;
+      case BAND:
+        e.box = Box(Rand(32, 632), Rand(600, 1000), 32, 32);
+        break;
+      case CLUSTERED:
+        if(i % 50 == 0) {
+          cx = Rand(0, 640);
+          cy = Rand(0, 480);
+        }
+        e.box = Box(cx + Rand(-20, 20), cy + Rand(-20, 20), 32, 32);
+        break;
+      case MIXED: {
+        // Mostly small things, a few big ones
+        const float * size = sizes[i % 50 == 0 ? 3 + (i / 50) % 2 : i % 3];
+        e.box = Box(Rand(0, 640), Rand(0, 480), size[0], size[1]);
+        break;
+      }
+    }
+    entities.push_back(e);
+  }
+  return entities;
+}
+
+// Moves everything one tick, wrapping back to the top like the game's aliens do
+static void Move(vector<Entity> & entities) {
+  for(auto & e : entities) {
+    float dy = e.velocity.getY();
+    if(e.box.hi_y + dy < -100.0f) {
+      dy += 1100.0f;
+    }
+    e.box.lo_y += dy;
+    e.box.hi_y += dy;
+  }
+}
+
+static void Run(SFBroadphase & bp, Layout layout, int count) {
+  srand(count + layout);
+  vector<Entity> entities = MakeEntities(layout, count);
+  vector<SFProxyId> ids, found;
+  for(size_t i = 0; i < entities.size(); i++) {
+    ids.push_back(bp.CreateProxy(entities[i].box, &entities[i], SFFACTION_ALIEN));
+  }
+
+  long candidates = 0;
+  Clock::time_point start = Clock::now();
+  for(int t = 0; t < TICKS; t++) {
+    Move(entities);
+    for(size_t i = 0; i < entities.size(); i++) {
+      bp.MoveProxy(ids[i], entities[i].box, entities[i].velocity);
+    }
+
+    // Projectiles fly up from the bottom of the screen
+    for(int p = 0; p < PROJECTILES; p++) {
+      float x = (p * 37 % 640), y = (t * 10 + p * 13) % 480;
+      found.clear();
+      bp.Query(Box(x, y, 19, 28), found);
+      candidates += found.size();
+    }
+  }
+  double us = chrono::duration<double, micro>(Clock::now() - start).count() / TICKS;
+
+  printf("  %-6s %-10s %6d entities  %9.1f us/tick  %8.1f candidates/tick\n", bp.GetName(), layoutNames[layout], count, us, candidates / (double) TICKS);
+}
+
+static Entity Spawn(SFBroadphase & bp, const SFAABB & box, const Vector2 & velocity, SFFACTION faction, vector<Entity> & list) {
+  Entity e = { box, velocity, faction, SF_NULL_PROXY };
+  e.proxy = bp.CreateProxy(box, nullptr, faction);
+  list.push_back(e);
+  return e;
+}
+
+// One tick of the game's movement. Shots that leave the screen are destroyed, everything else wraps.
+static void GameMove(SFBroadphase & bp, vector<Entity> & list) {
+  for(size_t i = 0; i < list.size(); ) {
+    Entity & e = list[i];
+    e.box.lo_y += e.velocity.getY();
+    e.box.hi_y += e.velocity.getY();
+
+    bool shot = e.faction == SFFACTION_PPROJECTILE || e.faction == SFFACTION_EPROJECTILE;
+    if(shot && (e.box.lo_y > 480.0f || e.box.hi_y < 0.0f)) {
+      bp.DestroyProxy(e.proxy);
+      list[i] = list.back();
+      list.pop_back();
+      continue;
+    }
+    if(e.box.hi_y < -32.0f) {
+      e.box.lo_y += 1000.0f;
+      e.box.hi_y += 1000.0f;
+    }
+    bp.MoveProxy(e.proxy, e.box, e.velocity);
+    i++;
+  }
+}
+
+static void RunGame(SFBroadphase & bp, int aliens) {
+  srand(aliens);
+  vector<Entity> entities;
+  for(int i = 0; i < aliens; i++) {
+    Spawn(bp, Box(Rand(32, 632), Rand(600, 1000), 32, 32), Vector2(0.0f, -2.0f), SFFACTION_ALIEN, entities);
+  }
+  for(int i = 0; i < aliens / 10; i++) {
+    bool coin = i % 2;
+    Spawn(bp, Box(Rand(32, 632), Rand(600, 1000), coin ? 50 : 19, coin ? 50 : 18), Vector2(0.0f, coin ? -1.0f : -3.0f), SFFACTION_PICKUP, entities);
+  }
+  Entity player = Spawn(bp, Box(320, 88, 32, 32), Vector2(0.0f, 0.0f), SFFACTION_PLAYER, entities);
+  entities.pop_back();
+
+  vector<SFProxyPair> pairs;
+  long total = 0, swaps = 0;
+  Clock::time_point start = Clock::now();
+  for(int t = 0; t < TICKS * 2; t++) {
+    // The stress test's player: sweep, bob and fire every third tick
+    float dx = (t / 120) % 2 ? -5.0f : 5.0f, dy = (t / 60) % 2 ? -2.0f : 4.0f;
+    player.box = { player.box.lo_x + dx, player.box.lo_y + dy, player.box.hi_x + dx, player.box.hi_y + dy };
+    bp.MoveProxy(player.proxy, player.box, Vector2(dx, dy));
+    if(t % 3 == 0) {
+      float x = (player.box.lo_x + player.box.hi_x) / 2.0f, y = (player.box.lo_y + player.box.hi_y) / 2.0f;
+      Spawn(bp, Box(x, y, 19, 18), Vector2(0.0f, 10.0f), SFFACTION_PPROJECTILE, entities);
+    }
+    for(int i = 0; i < EMITTERS; i++) {
+      if((t + i) % 30 == 0) {
+        Spawn(bp, Box((i + 0.5f) * 640 / EMITTERS, 464, 19, 18), Vector2(0.0f, -5.0f), SFFACTION_EPROJECTILE, entities);
+      }
+    }
+    GameMove(bp, entities);
+
+    pairs.clear();
+    bp.FindPairs(pairs);
+    total += pairs.size();
+    if(auto sap = dynamic_cast<SFSweepAndPrune *>(&bp)) {
+      swaps += sap->GetSwaps();
+    }
+  }
+  double us = chrono::duration<double, micro>(Clock::now() - start).count() / (TICKS * 2);
+
+  printf("  %-6s %6d aliens  %9.1f us/tick  %8.1f pairs/tick", bp.GetName(), aliens, us, total / (TICKS * 2.0));
+  if(swaps) {
+    printf("  %8.1f sort swaps/tick", swaps / (TICKS * 2.0));
+  }
+  printf("\n");
+}
+
+int main(int argc, char ** argv) {
+  printf("Move every proxy then %d projectile queries per tick, %d ticks\n", PROJECTILES, TICKS);
+
+  const int counts[] = { 100, 1000, 5000 };
+  for(int layout = UNIFORM; layout <= MIXED; layout++) {
+    for(auto count : counts) {
+      SFBruteForceBroadphase brute;
+      SFAABBTree tree;
+      SFSweepAndPrune sap;
+      Run(brute, (Layout) layout, count);
+      Run(tree, (Layout) layout, count);
+      Run(sap, (Layout) layout, count);
+    }
+  }
+
+  printf("FindPairs with the game's motion, %d emitters, %d ticks\n", EMITTERS, TICKS * 2);
+  for(auto count : counts) {
+    SFBruteForceBroadphase brute;
+    SFAABBTree tree;
+    SFSweepAndPrune sap;
+    // Brute force pairs are quadratic, it would take all day with the most aliens
+    if(count <= 1000) {
+      RunGame(brute, count);
+    }
+    RunGame(tree, count);
+    RunGame(sap, count);
+  }
+
+  return 0;
+}
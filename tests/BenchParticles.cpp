@@ -0,0 +1,78 @@
+/*********************************************************
+  Particle benchmark.
+
+  Runs the update kernels over 50000 particles, scalar
+  and SSE2, then a whole tick of a full pool the way the
+  game does it: update, take out the dead, emit more and
+  build the sprites for a batch. A 60 Hz frame has about
+  16.7 ms, so this says how much of it particles cost.
+
+  Build and run with `make bench`.
+*********************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#include "SFParticles.h"
+
+static const int PARTICLES = 50000;
+static const int ROUNDS    = 500;
+
+typedef chrono::steady_clock Clock;
+
+static void Report(const char * name, Clock::time_point start, double particles) {
+  double s = chrono::duration<double>(Clock::now() - start).count();
+  printf("  %-28s %8.1f Mparticles/s  (%.3f ms a tick)\n", name, particles / s / 1e6, s * 1000.0 / ROUNDS);
+}
+
+static float Random(float lo, float hi) {
+  return lo + (hi - lo) * rand() / (float) RAND_MAX;
+}
+
+int main(int argc, char ** argv) {
+  srand(1);
+  vector<float> x(PARTICLES), y(PARTICLES), vx(PARTICLES), vy(PARTICLES), age(PARTICLES);
+  for(int i = 0; i < PARTICLES; i++) {
+    x[i] = Random(0, 640);
+    y[i] = Random(0, 480);
+    vx[i] = Random(-3, 3);
+    vy[i] = Random(-3, 3);
+  }
+
+  printf("Update kernel, %d particles, %d ticks\n", PARTICLES, ROUNDS);
+  Clock::time_point t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    SFParticleStepScalar(x.data(), y.data(), vx.data(), vy.data(), age.data(), PARTICLES, 0.98f, -0.01f);
+  }
+  Report("scalar", t, (double) PARTICLES * ROUNDS);
+
+#ifdef SF_RASTER_SSE2
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    SFParticleStepSSE2(x.data(), y.data(), vx.data(), vy.data(), age.data(), PARTICLES, 0.98f, -0.01f);
+  }
+  Report("SSE2", t, (double) PARTICLES * ROUNDS);
+#endif
+
+  printf("Whole tick of a full pool\n");
+  SFParticleStyle style = { 0.0f, 0.94f, 20.0f, 4.0f, 1, 1, 65, 65 };
+  SFParticlePool pool(PARTICLES, style);
+  vector<SFSprite> sprites;
+  sprites.reserve(PARTICLES);
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    pool.Update();
+    while(pool.Emit(Random(0, 640), Random(0, 480), Random(-3, 3), Random(-3, 3), Random(20, 45))) {
+    }
+    sprites.clear();
+    pool.BuildSprites(sprites, 640, 480);
+  }
+  Report("update, emit, sprites", t, (double) PARTICLES * ROUNDS);
+  printf("  %zu sprites in the last batch\n", sprites.size());
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*********************************************************
+  Fill rate benchmark for the software renderer.
+
+  Blends a full screen layer with soft edges (the size of
+  the stars background) over a 640x480 frame, with the
+  scalar kernel and with SSE2, and then a screen's worth
+  of small sprites the way the aliens are drawn. Needs no
+  display, so it can run anywhere.
+
+  Build and run with `make bench`.
+*********************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#include "SFRaster.h"
+
+static const int ROUNDS = 200;
+
+typedef chrono::steady_clock Clock;
+
+static void Report(const char * name, Clock::time_point start, double pixels, uint32_t checksum) {
+  double s = chrono::duration<double>(Clock::now() - start).count();
+  printf("  %-28s %8.1f Mpixels/s  (checksum %08x)\n", name, pixels / s / 1e6, checksum);
+}
+
+// Mostly clear with opaque and see-through dots, like stars.png
+static SFImage Layer(int w, int h) {
+  SFImage layer(w, h);
+  for(int i = 0; i < w * h; i++) {
+    int r = rand() % 100;
+    layer.GetPixels()[i] = r < 90 ? 0 : SFRgba(255, 255, 255, r < 95 ? 255 : rand() % 256);
+  }
+  return layer;
+}
+
+int main(int argc, char ** argv) {
+  srand(1);
+  SFImage frame(640, 480);
+  SFImage stars = Layer(700, 700);
+  vector<uint32_t> row(640);
+
+  printf("Full screen layer, %d frames\n", ROUNDS);
+  Clock::time_point t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    for(int y = 0; y < 480; y++) {
+      SFBlendSpanScalar(frame.GetPixels() + y * 640, stars.GetPixels() + y * 700, 640);
+    }
+  }
+  Report("scalar", t, 640.0 * 480 * ROUNDS, frame.Checksum());
+
+#ifdef SF_RASTER_SSE2
+  frame.Clear(0);
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    for(int y = 0; y < 480; y++) {
+      SFBlendSpanSSE2(frame.GetPixels() + y * 640, stars.GetPixels() + y * 700, 640);
+    }
+  }
+  Report("SSE2", t, 640.0 * 480 * ROUNDS, frame.Checksum());
+#endif
+
+  frame.Clear(0);
+  SFRect back = { -30, -110, 700, 700 };
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    frame.Blit(stars, NULL, back);
+  }
+  Report("SFImage::Blit", t, 640.0 * 480 * ROUNDS, frame.Checksum());
+
+  printf("1000 32x34 sprites, %d frames\n", ROUNDS);
+  SFImage alien = Layer(32, 34);
+  frame.Clear(0);
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    for(int i = 0; i < 1000; i++) {
+      SFRect at = { (i * 37) % 620 - 10, (i * 53) % 470 - 10, 32, 34 };
+      frame.Blit(alien, NULL, at);
+    }
+  }
+  Report("SFImage::Blit", t, 32.0 * 34 * 1000 * ROUNDS, frame.Checksum());
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+/*********************************************************
+  Microbenchmarks for SFMath.
+
+  Compares the Vector2 type as it was before it became
+  trivially copyable (copied in below as LegacyVector2)
+  with the current Vector2, on the jobs the game does
+  with whole entity lists: moving, clamping to the
+  screen and finding the bounds.
+
+  Build and run with `make bench`.
+*********************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#include "SFMath.h"
+
+// Vector2 as it was: user-defined copy constructor and const by-value accessors
+class LegacyVector2 {
+public:
+  inline LegacyVector2(const float x, const float y) : m_x(x), m_y(y) {}
+  inline LegacyVector2(const LegacyVector2 & v) : m_x(v.m_x), m_y(v.m_y) {}
+  inline LegacyVector2 & operator=(const LegacyVector2 & v) { m_x = v.m_x; m_y = v.m_y; return *this; }
+  inline const float getX() const { return m_x; }
+  inline const float getY() const { return m_y; }
+  inline const LegacyVector2 operator +( const LegacyVector2 & v) const { return LegacyVector2(m_x + v.m_x, m_y + v.m_y); }
+  inline const LegacyVector2 operator *( float s) const { return LegacyVector2(m_x * s, m_y * s); }
+private:
+  float m_x, m_y;
+};
+
+static const int ENTITIES = 10000;
+static const int ROUNDS   = 2000;
+
+typedef chrono::steady_clock Clock;
+
+static double Report(const char * name, Clock::time_point start, float checksum) {
+  double ns = chrono::duration<double, nano>(Clock::now() - start).count() / ((double) ENTITIES * ROUNDS);
+  printf("  %-28s %8.3f ns/entity  (checksum %g)\n", name, ns, checksum);
+  return ns;
+}
+
+// Stops the compiler from merging or reordering the benchmark rounds
+template <class T>
+static void Clobber(T & data) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&data) : "memory");
+#endif
+}
+
+static float Rand(float lo, float hi) {
+  return lo + (hi - lo) * (rand() / (float) RAND_MAX);
+}
+
+int main(int argc, char ** argv) {
+  srand(1);
+  vector<LegacyVector2> lpos, lvel;
+  vector<Vector2> pos, vel;
+  for(int i = 0; i < ENTITIES; i++) {
+    float px = Rand(0.0f, 640.0f), py = Rand(0.0f, 480.0f), vx = Rand(-5.0f, 5.0f), vy = Rand(-10.0f, 10.0f);
+    lpos.push_back(LegacyVector2(px, py));
+    lvel.push_back(LegacyVector2(vx, vy));
+    pos.push_back(Vector2(px, py));
+    vel.push_back(Vector2(vx, vy));
+  }
+  const Vector2 lo(0.0f, 0.0f), hi(640.0f, 480.0f);
+
+  printf("Move (pos += vel * dt), %d entities x %d rounds\n", ENTITIES, ROUNDS);
+  Clock::time_point t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    Clobber(lpos);
+    for(int i = 0; i < ENTITIES; i++) {
+      lpos[i] = lpos[i] + lvel[i] * 0.016f;
+    }
+  }
+  Report("LegacyVector2", t, lpos[ENTITIES / 2].getX());
+
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    Clobber(pos);
+    for(int i = 0; i < ENTITIES; i++) {
+      pos[i] = pos[i] + vel[i] * 0.016f;
+    }
+  }
+  Report("Vector2", t, pos[ENTITIES / 2].getX());
+
+  printf("Clamp to the screen\n");
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    Clobber(lpos);
+    for(int i = 0; i < ENTITIES; i++) {
+      float x = lpos[i].getX(), y = lpos[i].getY();
+      lpos[i] = LegacyVector2(x < 0.0f ? 0.0f : (x > 640.0f ? 640.0f : x), y < 0.0f ? 0.0f : (y > 480.0f ? 480.0f : y));
+    }
+  }
+  Report("LegacyVector2", t, lpos[ENTITIES / 2].getY());
+
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    Clobber(pos);
+    for(int i = 0; i < ENTITIES; i++) {
+      pos[i] = clampPerElem(pos[i], lo, hi);
+    }
+  }
+  Report("Vector2 clampPerElem", t, pos[ENTITIES / 2].getY());
+
+  printf("Bounds of every entity\n");
+  float sum = 0.0f;
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    Clobber(lpos);
+    float mnx = lpos[0].getX(), mny = lpos[0].getY(), mxx = mnx, mxy = mny;
+    for(int i = 1; i < ENTITIES; i++) {
+      mnx = lpos[i].getX() < mnx ? lpos[i].getX() : mnx;
+      mny = lpos[i].getY() < mny ? lpos[i].getY() : mny;
+      mxx = lpos[i].getX() > mxx ? lpos[i].getX() : mxx;
+      mxy = lpos[i].getY() > mxy ? lpos[i].getY() : mxy;
+    }
+    sum += mnx + mny + mxx + mxy;
+  }
+  Report("LegacyVector2", t, sum);
+
+  sum = 0.0f;
+  t = Clock::now();
+  for(int r = 0; r < ROUNDS; r++) {
+    Clobber(pos);
+    Vector2 mn = pos[0], mx = pos[0];
+    for(int i = 1; i < ENTITIES; i++) {
+      mn = minPerElem(mn, pos[i]);
+      mx = maxPerElem(mx, pos[i]);
+    }
+    sum += mn.getX() + mn.getY() + mx.getX() + mx.getY();
+  }
+  Report("Vector2 min/maxPerElem", t, sum);
+
+  return 0;
+}
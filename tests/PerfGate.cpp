@@ -0,0 +1,158 @@
+/*********************************************************
+  Frame time regression gate.
+
+  Plays back recorded sessions (see SFSession.h) through
+  the whole game with the software renderer, so it needs
+  no display, and times every phase of every frame. Each
+  session is played a few times and the fastest run kept,
+  then compared with the baseline from the last time it
+  was saved. Exits with 1 if any phase got slower than
+  SFPerfTolerance allows, printing what did.
+
+  Run with `make perf`. The first run on a machine (or
+  `make perf-baseline` after a change that is meant to
+  be slower) saves the baseline instead, timings from one
+  machine mean nothing on another.
+
+    ./PerfGate [--save] [--baseline FILE] [--repeat N]
+               session.sfs ...
+*********************************************************/
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+#include "SFApp.h"
+#include "SFPerfGate.h"
+#include "SFProfiler.h"
+#include "SFSession.h"
+
+// The name a session goes by in the baseline: its file name without the path or .sfs
+static string SessionName(const string & path) {
+  size_t slash = path.find_last_of('/');
+  string name = slash == string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.rfind('.');
+  return dot == string::npos ? name : name.substr(0, dot);
+}
+
+// Plays the session once, from a fresh game, and returns a sample for every frame
+static vector<SFFrameSample> Play(const SFSession & session) {
+  SFOptions options;
+  options.renderer = SFRENDERER_SOFTWARE;
+  options.hitchMs  = 0;
+  options.frameBudgetMs = 0;
+  options.spawnBudgetUs = 0;    // Spawn by count only, as the session was recorded (see SFWave.h)
+
+  srand(session.GetSeed());
+  auto window = make_shared<SFWindow>((SDL_Window *) nullptr, SFRenderer::Create(SFRENDERER_SOFTWARE, nullptr));
+
+  // The game talks to the player on cout, which would bury the results
+  ostringstream quiet;
+  streambuf * out = cout.rdbuf(quiet.rdbuf());
+
+  vector<SFFrameSample> samples;
+  samples.reserve(session.GetFrames());
+  {
+    SFApp app(window, options);
+    for(int i = 0; i < session.GetFrames() && app.IsRunning(); i++) {
+      app.SetInput(session.GetFrame(i));
+      app.StepFrame();
+
+      SFFrameSample sample;
+      for(int p = 0; p < SFPHASE_LAST; p++) {
+        sample.phaseMs[p] = SFProfiler::GetPhaseMs((SFPHASE) p);
+      }
+      sample.allocs = SFProfiler::GetAllocs();
+      samples.push_back(sample);
+    }
+  }
+
+  cout.rdbuf(out);
+  return samples;
+}
+
+int main(int argc, char ** argv) {
+  string baselinePath = "perf_baseline.csv";
+  bool save = false;
+  int repeat = 3;
+  vector<string> sessions;
+
+  for(int i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "--save") == 0) {
+      save = true;
+    }
+    else if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baselinePath = argv[++i];
+    }
+    else if(strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+      repeat = max(1, atoi(argv[++i]));
+    }
+    else {
+      sessions.push_back(argv[i]);
+    }
+  }
+  if(sessions.empty()) {
+    cerr << "Usage: " << argv[0] << " [--save] [--baseline FILE] [--repeat N] session.sfs ..." << endl;
+    return 2;
+  }
+
+  if(SDL_Init(SDL_INIT_TIMER) < 0) {
+    cerr << "Failed to initialise SDL: " << SDL_GetError() << endl;
+    return 2;
+  }
+
+  SFPerfBaseline baseline;
+  if(!save && !baseline.Load(baselinePath)) {
+    cout << "No baseline yet, saving one" << endl;
+    save = true;
+  }
+
+  SFPerfTolerance tolerance;
+  int regressions = 0;
+  for(auto & path : sessions) {
+    SFSession session;
+    if(!session.Load(path)) {
+      return 2;
+    }
+
+    string name = SessionName(path);
+    SFRunSummary best = SFRunSummary::Of(Play(session));
+    for(int r = 1; r < repeat; r++) {
+      best = SFRunSummary::Best(best, SFRunSummary::Of(Play(session)));
+    }
+    cout << name << ": " << best.frames << " frames, " << best.median[SF_PERF_FRAME] << " ms median" << endl;
+
+    if(save) {
+      baseline.Set(name, best);
+    }
+    else if(!baseline.Has(name)) {
+      cout << "  not in the baseline, skipped (make perf-baseline to add it)" << endl;
+    }
+    else if(!SFPerfCompare(baseline.Get(name), best, tolerance, cout)) {
+      regressions++;
+    }
+  }
+
+  SDL_Quit();
+
+  if(save) {
+    if(!baseline.Save(baselinePath)) {
+      return 2;
+    }
+    cout << "Baseline saved to " << baselinePath << endl;
+    return 0;
+  }
+  if(regressions > 0) {
+    cout << regressions << " of " << sessions.size() << " sessions got slower" << endl;
+    return 1;
+  }
+  cout << "No regressions" << endl;
+  return 0;
+}
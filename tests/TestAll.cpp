@@ -1,10 +1,46 @@
 #include <cppunit/ui/text/TestRunner.h>
 
 #include "TestSFBoundingBox.h"
+#include "TestSFMath.h"
+#include "TestSFArena.h"
+#include "TestSFBroadphase.h"
+#include "TestSFHandle.h"
+#include "TestSFTimerWheel.h"
+#include "TestSFEventBus.h"
+#include "TestSFWave.h"
+#include "TestSFFlightRecorder.h"
+#include "TestSFRaster.h"
+#include "TestSFSession.h"
+#include "TestSFPerfGate.h"
+#include "TestSFParticles.h"
+#include "TestSFTileMap.h"
+#include "TestSFStarfield.h"
+#include "TestSFMask.h"
+#include "TestSFInputQueue.h"
+#include "TestSFLatency.h"
+#include "TestSFGovernor.h"
 
 int main( int argc, char **argv) {
   CppUnit::TextUi::TestRunner runner;
   runner.addTest( TestSFBoundingBox::suite() );
+  runner.addTest( TestSFMath::suite() );
+  runner.addTest( TestSFArena::suite() );
+  runner.addTest( TestSFBroadphase::suite() );
+  runner.addTest( TestSFHandle::suite() );
+  runner.addTest( TestSFTimerWheel::suite() );
+  runner.addTest( TestSFEventBus::suite() );
+  runner.addTest( TestSFWave::suite() );
+  runner.addTest( TestSFFlightRecorder::suite() );
+  runner.addTest( TestSFRaster::suite() );
+  runner.addTest( TestSFSession::suite() );
+  runner.addTest( TestSFPerfGate::suite() );
+  runner.addTest( TestSFParticles::suite() );
+  runner.addTest( TestSFTileMap::suite() );
+  runner.addTest( TestSFStarfield::suite() );
+  runner.addTest( TestSFMask::suite() );
+  runner.addTest( TestSFInputQueue::suite() );
+  runner.addTest( TestSFLatency::suite() );
+  runner.addTest( TestSFGovernor::suite() );
   runner.run();
   return 0;
 }
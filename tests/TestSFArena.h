@@ -0,0 +1,94 @@
+#ifndef TESTSFARENA_H
+#define TESTSFARENA_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdint>
+
+using namespace std;
+
+#include "SFArena.h"
+
+class TestSFArena : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFArena );
+  CPPUNIT_TEST( testAlignment );
+  CPPUNIT_TEST( testResetReuses );
+  CPPUNIT_TEST( testOverflow );
+  CPPUNIT_TEST( testFrameVector );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSFArena( ) : CppUnit::TestCase( "TestSFArena" ) {}
+  TestSFArena( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testAlignment() {
+    SFArena arena(256);
+    arena.Allocate(1, 1);
+
+    // Each allocation starts on its own alignment, whatever came before it
+    void * a = arena.Allocate(4, 4);
+    void * b = arena.Allocate(1, 1);
+    void * c = arena.Allocate(8, 16);
+    CPPUNIT_ASSERT_EQUAL( (uintptr_t) 0, (uintptr_t) a % 4 );
+    CPPUNIT_ASSERT_EQUAL( (uintptr_t) 0, (uintptr_t) c % 16 );
+    CPPUNIT_ASSERT( (char *) b >= (char *) a + 4 );
+    CPPUNIT_ASSERT( (char *) c >= (char *) b + 1 );
+    CPPUNIT_ASSERT( arena.Owns(a) && arena.Owns(b) && arena.Owns(c) );
+  }
+
+  void testResetReuses() {
+    SFArena arena(128);
+    void * first = arena.Allocate(40, 8);
+    arena.Allocate(40, 8);
+    CPPUNIT_ASSERT( arena.GetUsed() >= 80 );
+
+    // The next frame starts at the beginning of the buffer again, but the peak is kept
+    arena.Reset();
+    CPPUNIT_ASSERT_EQUAL( (size_t) 0, arena.GetUsed() );
+    CPPUNIT_ASSERT( arena.GetPeak() >= 80 );
+    CPPUNIT_ASSERT( arena.Allocate(40, 8) == first );
+    CPPUNIT_ASSERT_EQUAL( 0, arena.GetOverflows() );
+  }
+
+  void testOverflow() {
+    SFArena arena(64);
+    void * fits = arena.Allocate(48, 8);
+    size_t used = arena.GetUsed();
+
+    // Too big for what's left, so it comes from the heap and the arena is untouched
+    void * spilled = arena.Allocate(32, 8);
+    CPPUNIT_ASSERT( spilled != nullptr );
+    CPPUNIT_ASSERT( !arena.Owns(spilled) );
+    CPPUNIT_ASSERT_EQUAL( 1, arena.GetOverflows() );
+    CPPUNIT_ASSERT_EQUAL( used, arena.GetUsed() );
+
+    // Giving back heap memory frees it, giving back arena memory waits for Reset
+    arena.Deallocate(spilled);
+    arena.Deallocate(fits);
+    CPPUNIT_ASSERT_EQUAL( used, arena.GetUsed() );
+    CPPUNIT_ASSERT( arena.GetPeak() <= arena.GetCapacity() );
+  }
+
+  void testFrameVector() {
+    SFArena arena(1024);
+    {
+      SFFrameVector<int> v(arena);
+      v.reserve(16);
+      for(int i = 0; i < 16; i++) {
+        v.push_back(i * i);
+      }
+      CPPUNIT_ASSERT( arena.Owns(v.data()) );
+      CPPUNIT_ASSERT_EQUAL( 225, v[15] );
+    }
+    CPPUNIT_ASSERT( arena.GetUsed() >= 16 * sizeof(int) );
+
+    arena.Reset();
+    CPPUNIT_ASSERT_EQUAL( (size_t) 0, arena.GetUsed() );
+    CPPUNIT_ASSERT_EQUAL( 0, arena.GetOverflows() );
+  }
+};
+
+#endif
@@ -18,6 +18,10 @@ class TestSFBoundingBox : public CPPUNIT_NS::TestCase {
   CPPUNIT_TEST( testOverlap );
   CPPUNIT_TEST( testDisjoint );
   CPPUNIT_TEST( testSmallLarge );
+  CPPUNIT_TEST( testSweptTunnel );
+  CPPUNIT_TEST( testSweptMiss );
+  CPPUNIT_TEST( testSweptTimeOfImpact );
+  CPPUNIT_TEST( testSweptStationary );
   CPPUNIT_TEST_SUITE_END();
 
 public: 
@@ -57,6 +61,51 @@ public:
     CPPUNIT_ASSERT( b1->CollidesWith(b2) );
     CPPUNIT_ASSERT( b2->CollidesWith(b1) );
   }
+
+  void testSweptTunnel() {
+    // A projectile that jumped clean over an alien in one step
+    auto p = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(100.0f, 160.0f), 19.0f, 18.0f));
+    auto a = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(100.0f, 100.0f), 32.0f, 34.0f));
+    float toi = -1.0f;
+
+    CPPUNIT_ASSERT( !p->CollidesWith(a) );
+    CPPUNIT_ASSERT( p->SweptCollidesWith(a, Vector2(0.0f, 120.0f), Vector2(0.0f, 0.0f), toi) );
+    CPPUNIT_ASSERT( toi >= 0.0f && toi <= 1.0f );
+    CPPUNIT_ASSERT( a->SweptCollidesWith(p, Vector2(0.0f, 0.0f), Vector2(0.0f, 120.0f), toi) );
+  }
+
+  void testSweptMiss() {
+    // Moving past the alien on a different column never touches it
+    auto p = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(200.0f, 160.0f), 19.0f, 18.0f));
+    auto a = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(100.0f, 100.0f), 32.0f, 34.0f));
+    float toi = -1.0f;
+
+    CPPUNIT_ASSERT( !p->SweptCollidesWith(a, Vector2(0.0f, 120.0f), Vector2(0.0f, -7.0f), toi) );
+  }
+
+  void testSweptTimeOfImpact() {
+    // Both move towards each other, closing a 20 unit gap over 40 units of travel
+    auto p = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(0.0f, 40.0f), 10.0f, 10.0f));
+    auto a = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(0.0f, 10.0f), 10.0f, 10.0f));
+    float toi = -1.0f;
+
+    // p started at y=10, a started at y=40, gap between edges was 20
+    CPPUNIT_ASSERT( p->SweptCollidesWith(a, Vector2(0.0f, 30.0f), Vector2(0.0f, -30.0f), toi) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 20.0f / 60.0f, toi, 0.0001f );
+  }
+
+  void testSweptStationary() {
+    // With no movement the swept test agrees with the discrete one
+    auto b1 = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(0.0f, 0.0f), 5.0f, 5.0f));
+    auto b2 = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(2.5f, 2.5f), 5.0f, 5.0f));
+    auto b3 = make_shared<SFBoundingBox>(SFBoundingBox(Vector2(20.0f, 20.0f), 5.0f, 5.0f));
+    Vector2 still(0.0f, 0.0f);
+    float toi = -1.0f;
+
+    CPPUNIT_ASSERT( b1->SweptCollidesWith(b2, still, still, toi) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, toi, 0.0001f );
+    CPPUNIT_ASSERT( !b1->SweptCollidesWith(b3, still, still, toi) );
+  }
 };
 
 #endif
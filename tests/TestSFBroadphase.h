@@ -0,0 +1,288 @@
+#ifndef TESTSFBROADPHASE_H
+#define TESTSFBROADPHASE_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+#include "SFBroadphase.h"
+#include "SFAABBTree.h"
+#include "SFSweepAndPrune.h"
+
+class TestSFBroadphase : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFBroadphase );
+  CPPUNIT_TEST( testAABB );
+  CPPUNIT_TEST( testRayHit );
+  CPPUNIT_TEST( testTreeMatchesBrute );
+  CPPUNIT_TEST( testTreeMove );
+  CPPUNIT_TEST( testTreeDestroy );
+  CPPUNIT_TEST( testFactions );
+  CPPUNIT_TEST( testPairsMatchBrute );
+  CPPUNIT_TEST( testSapMatchesBrute );
+  CPPUNIT_TEST( testSapFalling );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSFBroadphase( ) : CppUnit::TestCase( "TestSFBroadphase" ) {}
+  TestSFBroadphase( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testAABB() {
+    SFAABB a = { 0.0f, 0.0f, 10.0f, 10.0f }, b = { 5.0f, 2.0f, 15.0f, 8.0f }, c = { 20.0f, 0.0f, 30.0f, 10.0f };
+
+    CPPUNIT_ASSERT( a.Overlaps(b) && b.Overlaps(a) );
+    CPPUNIT_ASSERT( !a.Overlaps(c) );
+    CPPUNIT_ASSERT( Union(a, c).Contains(b) );
+    CPPUNIT_ASSERT( a.Contains(Point2(10.0f, 0.0f)) );
+    CPPUNIT_ASSERT( !a.Contains(Point2(10.5f, 0.0f)) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 40.0f, a.Perimeter(), 0.0001f );
+  }
+
+  void testRayHit() {
+    SFAABB a = { 10.0f, -5.0f, 20.0f, 5.0f };
+    float fraction;
+
+    CPPUNIT_ASSERT( a.RayHit(Point2(0.0f, 0.0f), Vector2(40.0f, 0.0f), fraction) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.25f, fraction, 0.0001f );
+
+    // Too short, pointing away and passing above
+    CPPUNIT_ASSERT( !a.RayHit(Point2(0.0f, 0.0f), Vector2(5.0f, 0.0f), fraction) );
+    CPPUNIT_ASSERT( !a.RayHit(Point2(0.0f, 0.0f), Vector2(-40.0f, 0.0f), fraction) );
+    CPPUNIT_ASSERT( !a.RayHit(Point2(0.0f, 10.0f), Vector2(40.0f, 0.0f), fraction) );
+
+    // Starting inside
+    CPPUNIT_ASSERT( a.RayHit(Point2(15.0f, 0.0f), Vector2(0.0f, 100.0f), fraction) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, fraction, 0.0001f );
+  }
+
+  // With no margin the tree has to give exactly what brute force does
+  void testTreeMatchesBrute() {
+    SFAABBTree tree(0.0f, 0.0f);
+    SFBruteForceBroadphase brute;
+    srand(33);
+    Fill(tree, brute, 300);
+    CPPUNIT_ASSERT( tree.Validate() );
+    CPPUNIT_ASSERT_EQUAL( 300, tree.GetProxyCount() );
+
+    for(int i = 0; i < 100; i++) {
+      SFAABB q = RandomBox();
+      CPPUNIT_ASSERT( Found(tree, q) == Found(brute, q) );
+
+      Point2 p(rand() % 640, rand() % 480);
+      CPPUNIT_ASSERT( FoundPoint(tree, p) == FoundPoint(brute, p) );
+
+      Point2 from(rand() % 640, rand() % 480), to(rand() % 640, rand() % 480);
+      CPPUNIT_ASSERT( FoundRay(tree, from, to) == FoundRay(brute, from, to) );
+    }
+  }
+
+  // Fat boxes mean the tree can give extra candidates, but never miss one
+  void testTreeMove() {
+    SFAABBTree tree;
+    SFBruteForceBroadphase brute;
+    srand(34);
+    vector<SFProxyId> treeIds = Fill(tree, brute, 200);
+
+    for(int tick = 0; tick < 100; tick++) {
+      for(size_t i = 0; i < treeIds.size(); i++) {
+        // Most things fall steadily, every tenth one jumps somewhere new
+        Vector2 d(0.0f, -2.0f - (i % 5));
+        boxes[i] = i % 10 ? Shift(boxes[i], d) : RandomBox();
+        tree.MoveProxy(treeIds[i], boxes[i], d);
+        brute.MoveProxy(i, boxes[i], d);
+        CPPUNIT_ASSERT( tree.GetFatAABB(treeIds[i]).Contains(boxes[i]) );
+      }
+      CPPUNIT_ASSERT( tree.Validate() );
+
+      SFAABB q = RandomBox();
+      set<intptr_t> exact = Found(brute, q), maybe = Found(tree, q);
+      CPPUNIT_ASSERT( includes(maybe.begin(), maybe.end(), exact.begin(), exact.end()) );
+    }
+    CPPUNIT_ASSERT( tree.GetRefits() > 0 );
+    CPPUNIT_ASSERT( tree.GetReinserts() > 0 );
+  }
+
+  void testTreeDestroy() {
+    SFAABBTree tree(0.0f, 0.0f);
+    SFBruteForceBroadphase brute;
+    srand(35);
+    vector<SFProxyId> treeIds = Fill(tree, brute, 100);
+
+    for(size_t i = 0; i < treeIds.size(); i += 2) {
+      tree.DestroyProxy(treeIds[i]);
+      brute.DestroyProxy(i);
+    }
+    CPPUNIT_ASSERT( tree.Validate() );
+    CPPUNIT_ASSERT_EQUAL( 50, tree.GetProxyCount() );
+    CPPUNIT_ASSERT_EQUAL( 50, brute.GetProxyCount() );
+
+    SFAABB all = { -1000.0f, -1000.0f, 2000.0f, 2000.0f };
+    CPPUNIT_ASSERT( Found(tree, all) == Found(brute, all) );
+
+    for(size_t i = 1; i < treeIds.size(); i += 2) {
+      tree.DestroyProxy(treeIds[i]);
+    }
+    CPPUNIT_ASSERT( tree.Validate() );
+    CPPUNIT_ASSERT( Found(tree, all).empty() );
+  }
+
+  void testFactions() {
+    CPPUNIT_ASSERT( SFFactionsMeet(SFFACTION_PPROJECTILE, SFFACTION_ALIEN) );
+    CPPUNIT_ASSERT( SFFactionsMeet(SFFACTION_ALIEN, SFFACTION_PPROJECTILE) );
+    CPPUNIT_ASSERT( SFFactionsMeet(SFFACTION_PLAYER, SFFACTION_PICKUP) );
+    CPPUNIT_ASSERT( SFFactionsMeet(SFFACTION_PLAYER, SFFACTION_EPROJECTILE) );
+    CPPUNIT_ASSERT( !SFFactionsMeet(SFFACTION_ALIEN, SFFACTION_ALIEN) );
+    CPPUNIT_ASSERT( !SFFactionsMeet(SFFACTION_PPROJECTILE, SFFACTION_EPROJECTILE) );
+    CPPUNIT_ASSERT( !SFFactionsMeet(SFFACTION_ALIEN, SFFACTION_PICKUP) );
+  }
+
+  void testPairsMatchBrute() {
+    SFAABBTree tree(0.0f, 0.0f);
+    SFBruteForceBroadphase brute;
+    srand(36);
+    Fill(tree, brute, 300);
+
+    set<pair<intptr_t, intptr_t>> exact = Pairs(brute);
+    CPPUNIT_ASSERT( !exact.empty() );
+    CPPUNIT_ASSERT( Pairs(tree) == exact );
+  }
+
+  void testSapMatchesBrute() {
+    SFSweepAndPrune sap;
+    SFBruteForceBroadphase brute;
+    srand(37);
+    Fill(sap, brute, 300);
+
+    CPPUNIT_ASSERT( Pairs(sap) == Pairs(brute) );
+    CPPUNIT_ASSERT( sap.IsSorted() );
+
+    for(int i = 0; i < 50; i++) {
+      SFAABB q = RandomBox();
+      CPPUNIT_ASSERT( Found(sap, q) == Found(brute, q) );
+
+      Point2 p(rand() % 640, rand() % 480);
+      CPPUNIT_ASSERT( FoundPoint(sap, p) == FoundPoint(brute, p) );
+    }
+  }
+
+  // Everything falling at its own speed, with some coming and going, like the game
+  void testSapFalling() {
+    SFSweepAndPrune sap;
+    SFBruteForceBroadphase brute;
+    srand(38);
+    vector<SFProxyId> sapIds = Fill(sap, brute, 200), bruteIds;
+    for(size_t i = 0; i < sapIds.size(); i++) {
+      bruteIds.push_back(i);
+    }
+
+    for(int tick = 0; tick < 100; tick++) {
+      for(size_t i = 0; i < sapIds.size(); i++) {
+        Vector2 d(0.0f, i % 4 == 1 ? 10.0f : -2.0f - (i % 3));
+        boxes[i] = Shift(boxes[i], d);
+        sap.MoveProxy(sapIds[i], boxes[i], d);
+        brute.MoveProxy(bruteIds[i], boxes[i], d);
+      }
+
+      // Swap one out for a new one every few ticks
+      if(tick % 5 == 0) {
+        size_t i = rand() % sapIds.size();
+        sap.DestroyProxy(sapIds[i]);
+        brute.DestroyProxy(bruteIds[i]);
+        boxes[i] = RandomBox();
+        SFFACTION faction = (SFFACTION) (rand() % SFFACTION_LAST);
+        sapIds[i] = sap.CreateProxy(boxes[i], (void *) (intptr_t) (1000 + tick), faction);
+        bruteIds[i] = brute.CreateProxy(boxes[i], (void *) (intptr_t) (1000 + tick), faction);
+      }
+
+      CPPUNIT_ASSERT( Pairs(sap) == Pairs(brute) );
+      CPPUNIT_ASSERT( sap.IsSorted() );
+    }
+    CPPUNIT_ASSERT_EQUAL( 200, sap.GetProxyCount() );
+  }
+
+private:
+  // The boxes given to Fill, where they are now
+  vector<SFAABB> boxes;
+
+  // Mixed sizes, from projectiles up to the size of the stars background
+  SFAABB RandomBox() {
+    static const float sizes[][2] = { {19, 18}, {50, 50}, {32, 32}, {163, 52}, {700, 700} };
+    const float * size = sizes[rand() % 5];
+    float x = rand() % 640, y = rand() % 480;
+    SFAABB b = { x, y, x + size[0], y + size[1] };
+    return b;
+  }
+
+  SFAABB Shift(const SFAABB & b, const Vector2 & d) {
+    SFAABB s = { b.lo_x + d.getX(), b.lo_y + d.getY(), b.hi_x + d.getX(), b.hi_y + d.getY() };
+    return s;
+  }
+
+  // Puts the same boxes in both, the user data is the box's number (from 1)
+  vector<SFProxyId> Fill(SFBroadphase & a, SFBroadphase & b, int count) {
+    vector<SFProxyId> ids;
+    boxes.clear();
+    for(int i = 0; i < count; i++) {
+      SFAABB box = RandomBox();
+      boxes.push_back(box);
+      SFFACTION faction = (SFFACTION) (i % SFFACTION_LAST);
+      ids.push_back(a.CreateProxy(box, (void *) (intptr_t) (i + 1), faction));
+      b.CreateProxy(box, (void *) (intptr_t) (i + 1), faction);
+    }
+    return ids;
+  }
+
+  set<intptr_t> Found(SFBroadphase & bp, const SFAABB & q) {
+    vector<SFProxyId> out;
+    bp.Query(q, out);
+    return UserData(bp, out);
+  }
+
+  set<intptr_t> FoundPoint(SFBroadphase & bp, const Point2 & p) {
+    vector<SFProxyId> out;
+    bp.QueryPoint(p, out);
+    return UserData(bp, out);
+  }
+
+  set<intptr_t> FoundRay(SFBroadphase & bp, const Point2 & from, const Point2 & to) {
+    vector<SFRayHit> hits;
+    vector<SFProxyId> out;
+    bp.RayCast(from, to, hits);
+    for(auto hit : hits) {
+      out.push_back(hit.proxy);
+    }
+    return UserData(bp, out);
+  }
+
+  // Pairs by user data, checking the lower faction comes first
+  set<pair<intptr_t, intptr_t>> Pairs(SFBroadphase & bp) {
+    vector<SFProxyPair> out;
+    bp.FindPairs(out);
+
+    set<pair<intptr_t, intptr_t>> found;
+    for(auto p : out) {
+      CPPUNIT_ASSERT( bp.GetFaction(p.a) < bp.GetFaction(p.b) );
+      found.insert(make_pair((intptr_t) bp.GetUserData(p.a), (intptr_t) bp.GetUserData(p.b)));
+    }
+    CPPUNIT_ASSERT_EQUAL( out.size(), found.size() );
+    return found;
+  }
+
+  set<intptr_t> UserData(SFBroadphase & bp, const vector<SFProxyId> & ids) {
+    set<intptr_t> found;
+    for(auto id : ids) {
+      found.insert((intptr_t) bp.GetUserData(id));
+    }
+    return found;
+  }
+};
+
+#endif
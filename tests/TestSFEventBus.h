@@ -0,0 +1,98 @@
+#ifndef TESTSFEVENTBUS_H
+#define TESTSFEVENTBUS_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+using namespace std;
+
+#include "SFEventBus.h"
+
+class TestSFEventBus : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFEventBus );
+  CPPUNIT_TEST( testBatches );
+  CPPUNIT_TEST( testOnlyWhenPosted );
+  CPPUNIT_TEST( testChained );
+  CPPUNIT_TEST_SUITE_END();
+
+  // Counts what it's given, and turns every kill into 10 points like the game does
+  struct Listener : public SFGameListener {
+    SFEventBus * bus = nullptr;
+    int killCalls = 0, kills = 0, scoreCalls = 0, lastScore = 0;
+
+    void OnKills(const vector<SFKillEvent> & events) {
+      killCalls++;
+      kills += events.size();
+      if(bus) {
+        SFScoreEvent e = { 10 * kills, 10 };
+        bus->Post(e);
+      }
+    }
+    void OnScoreChanges(const vector<SFScoreEvent> & events) {
+      scoreCalls++;
+      lastScore = events.back().score;
+    }
+  };
+
+public:
+  TestSFEventBus( ) : CppUnit::TestCase( "TestSFEventBus" ) {}
+  TestSFEventBus( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testBatches() {
+    SFEventBus bus;
+    Listener a, b;
+    bus.Subscribe(&a);
+    bus.Subscribe(&b);
+
+    SFKillEvent kill = { SF_NULL_HANDLE, Point2(0.0f, 0.0f), SFFACTION_PPROJECTILE };
+    for(int i = 0; i < 5; i++) {
+      bus.Post(kill);
+    }
+    bus.Dispatch();
+
+    // Each listener got all five in one call
+    CPPUNIT_ASSERT_EQUAL( 1, a.killCalls );
+    CPPUNIT_ASSERT_EQUAL( 5, a.kills );
+    CPPUNIT_ASSERT_EQUAL( 5, b.kills );
+    CPPUNIT_ASSERT_EQUAL( 5L, bus.GetPosted() );
+    CPPUNIT_ASSERT_EQUAL( 1L, bus.GetBatches() );
+  }
+
+  void testOnlyWhenPosted() {
+    SFEventBus bus;
+    Listener a;
+    bus.Subscribe(&a);
+
+    bus.Dispatch();
+    SFScoreEvent score = { 3, 3 };
+    bus.Post(score);
+    bus.Dispatch();
+    bus.Dispatch();
+
+    CPPUNIT_ASSERT_EQUAL( 0, a.killCalls );
+    CPPUNIT_ASSERT_EQUAL( 1, a.scoreCalls );
+    CPPUNIT_ASSERT_EQUAL( 3, a.lastScore );
+  }
+
+  // Events posted by a listener go out before Dispatch returns
+  void testChained() {
+    SFEventBus bus;
+    Listener a;
+    a.bus = &bus;
+    bus.Subscribe(&a);
+
+    SFKillEvent kill = { SF_NULL_HANDLE, Point2(0.0f, 0.0f), SFFACTION_PPROJECTILE };
+    bus.Post(kill);
+    bus.Post(kill);
+    bus.Dispatch();
+
+    CPPUNIT_ASSERT_EQUAL( 1, a.scoreCalls );
+    CPPUNIT_ASSERT_EQUAL( 20, a.lastScore );
+  }
+};
+
+#endif
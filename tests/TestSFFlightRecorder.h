@@ -0,0 +1,92 @@
+#ifndef TESTSFFLIGHTRECORDER_H
+#define TESTSFFLIGHTRECORDER_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+#include "SFFlightRecorder.h"
+
+class TestSFFlightRecorder : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFFlightRecorder );
+  CPPUNIT_TEST( testNoHitch );
+  CPPUNIT_TEST( testDumpAroundHitch );
+  CPPUNIT_TEST( testFlushEarly );
+  CPPUNIT_TEST_SUITE_END();
+
+  // A frame that took ms, all of it moving things
+  SFFrameRecord Frame(long frame, double ms) {
+    SFFrameRecord r = {};
+    r.frame = frame;
+    r.intervalMs = 16.0;
+    r.phaseMs[SFPHASE_MOVEMENT] = ms;
+    return r;
+  }
+
+  // Lines in a file, header included
+  int Lines(const string & name) {
+    ifstream in(name.c_str());
+    string line;
+    int lines = 0;
+    while(getline(in, line)) {
+      lines++;
+    }
+    return lines;
+  }
+
+public:
+  TestSFFlightRecorder( ) : CppUnit::TestCase( "TestSFFlightRecorder" ) {}
+  TestSFFlightRecorder( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testNoHitch() {
+    SFFlightRecorder recorder(33.0, 10, 5, "TestHitch");
+    for(long f = 1; f <= 100; f++) {
+      recorder.Record(Frame(f, 5.0));
+    }
+    recorder.Flush();
+    CPPUNIT_ASSERT_EQUAL( 0, recorder.GetHitches() );
+    CPPUNIT_ASSERT_EQUAL( 0, recorder.GetDumps() );
+    CPPUNIT_ASSERT_EQUAL( string(""), recorder.GetLastFile() );
+  }
+
+  void testDumpAroundHitch() {
+    SFFlightRecorder recorder(33.0, 10, 5, "TestHitch");
+    for(long f = 1; f <= 100; f++) {
+      recorder.Record(Frame(f, f == 50 ? 80.0 : 5.0));
+    }
+    recorder.Flush();
+    CPPUNIT_ASSERT_EQUAL( 1, recorder.GetHitches() );
+    CPPUNIT_ASSERT_EQUAL( 1, recorder.GetDumps() );
+    CPPUNIT_ASSERT_EQUAL( 0, recorder.GetDropped() );
+
+    // Ten frames before, the hitch and five after, under a header
+    string name = recorder.GetLastFile();
+    CPPUNIT_ASSERT( name.find("TestHitch_") == 0 );
+    CPPUNIT_ASSERT( name.find("_f50.csv") != string::npos );
+    CPPUNIT_ASSERT_EQUAL( 17, Lines(name) );
+    remove(name.c_str());
+  }
+
+  void testFlushEarly() {
+    SFFlightRecorder recorder(33.0, 10, 5, "TestHitch");
+    for(long f = 1; f <= 3; f++) {
+      recorder.Record(Frame(f, f == 2 ? 80.0 : 5.0));
+    }
+
+    // Flushing doesn't wait for the frames after, it saves what there is
+    recorder.Flush();
+    CPPUNIT_ASSERT_EQUAL( 1, recorder.GetDumps() );
+    string name = recorder.GetLastFile();
+    CPPUNIT_ASSERT_EQUAL( 4, Lines(name) );
+    remove(name.c_str());
+  }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef TESTSFGOVERNOR_H
+#define TESTSFGOVERNOR_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace std;
+
+#include "SFGovernor.h"
+
+class TestSFGovernor : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFGovernor );
+  CPPUNIT_TEST( testSteps );
+  CPPUNIT_TEST( testSpikes );
+  CPPUNIT_TEST( testHysteresis );
+  CPPUNIT_TEST_SUITE_END();
+
+  // Frames of ms each until the quality changes, or frames have gone by. How many it took.
+  static int Run(SFGovernor & governor, double ms, int frames) {
+    for(int i = 1; i <= frames; i++) {
+      if(governor.AddFrame(ms)) {
+        return i;
+      }
+    }
+    return frames + 1;
+  }
+
+public:
+  TestSFGovernor( ) : CppUnit::TestCase( "TestSFGovernor" ) {}
+  TestSFGovernor( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testSteps() {
+    SFGovernor governor(16.0, 10);
+    CPPUNIT_ASSERT_EQUAL( SFQUALITY_HIGH, governor.GetQuality() );
+
+    // Over budget: down a level after each full window, no lower than low
+    CPPUNIT_ASSERT_EQUAL( 10, Run(governor, 20.0, 100) );
+    CPPUNIT_ASSERT_EQUAL( SFQUALITY_MEDIUM, governor.GetQuality() );
+    CPPUNIT_ASSERT_EQUAL( 10, Run(governor, 20.0, 100) );
+    CPPUNIT_ASSERT_EQUAL( SFQUALITY_LOW, governor.GetQuality() );
+    CPPUNIT_ASSERT_EQUAL( 101, Run(governor, 20.0, 100) );
+
+    // Well under: back up once nine in ten of the window are fast (it's been at low long enough)...
+    CPPUNIT_ASSERT_EQUAL( 9, Run(governor, 5.0, 100) );
+    CPPUNIT_ASSERT_EQUAL( SFQUALITY_MEDIUM, governor.GetQuality() );
+    // ...then after two windows at the new level
+    CPPUNIT_ASSERT_EQUAL( 20, Run(governor, 5.0, 100) );
+    CPPUNIT_ASSERT_EQUAL( SFQUALITY_HIGH, governor.GetQuality() );
+    CPPUNIT_ASSERT_EQUAL( 4L, governor.GetChanges() );
+    CPPUNIT_ASSERT_EQUAL( 149L, governor.GetFrames(SFQUALITY_LOW) + governor.GetFrames(SFQUALITY_MEDIUM) + governor.GetFrames(SFQUALITY_HIGH) );
+
+    // Switched off it never changes
+    SFGovernor off(0.0, 10);
+    CPPUNIT_ASSERT_EQUAL( 101, Run(off, 100.0, 100) );
+    CPPUNIT_ASSERT_EQUAL( 100L, off.GetFrames(SFQUALITY_HIGH) );
+  }
+
+  void testSpikes() {
+    // One slow frame in ten is past the 90th percentile, so it doesn't count
+    SFGovernor governor(16.0, 10);
+    for(int i = 0; i < 200; i++) {
+      governor.AddFrame(i % 10 == 0 ? 50.0 : 8.0);
+    }
+    CPPUNIT_ASSERT_EQUAL( SFQUALITY_HIGH, governor.GetQuality() );
+    CPPUNIT_ASSERT_EQUAL( 0L, governor.GetChanges() );
+  }
+
+  void testHysteresis() {
+    // Between the thresholds nothing changes either way
+    SFGovernor governor(16.0, 10);
+    Run(governor, 20.0, 100);
+    CPPUNIT_ASSERT_EQUAL( 1001, Run(governor, 12.0, 1000) );
+    CPPUNIT_ASSERT_EQUAL( SFQUALITY_MEDIUM, governor.GetQuality() );
+
+    // A level that only fits in the budget some of the time: the step back up has to wait longer each time it fails
+    int waits[3];
+    for(int i = 0; i < 3; i++) {
+      waits[i] = Run(governor, 5.0, 10000);
+      CPPUNIT_ASSERT_EQUAL( SFQUALITY_HIGH, governor.GetQuality() );
+      CPPUNIT_ASSERT_EQUAL( 10, Run(governor, 20.0, 100) );
+      CPPUNIT_ASSERT_EQUAL( SFQUALITY_MEDIUM, governor.GetQuality() );
+    }
+    // The first only waits for the window to be fast, it's been at medium long enough
+    CPPUNIT_ASSERT_EQUAL( 9, waits[0] );
+    CPPUNIT_ASSERT_EQUAL( 40, waits[1] );
+    CPPUNIT_ASSERT_EQUAL( 80, waits[2] );
+  }
+};
+
+#endif
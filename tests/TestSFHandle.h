@@ -0,0 +1,135 @@
+#ifndef TESTSFHANDLE_H
+#define TESTSFHANDLE_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <set>
+#include <vector>
+
+using namespace std;
+
+#include "SFCommon.h"
+#include "SFHandle.h"
+
+class TestSFHandle : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFHandle );
+  CPPUNIT_TEST( testLookup );
+  CPPUNIT_TEST( testStale );
+  CPPUNIT_TEST( testReuse );
+  CPPUNIT_TEST( testGenerationWraps );
+  CPPUNIT_TEST( testManyLive );
+  CPPUNIT_TEST( testLimits );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSFHandle( ) : CppUnit::TestCase( "TestSFHandle" ) {}
+  TestSFHandle( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testLookup() {
+    SFHandleTable table;
+    int a, b;
+    SFHandle ha = table.Create(&a), hb = table.Create(&b);
+
+    CPPUNIT_ASSERT( ha != SF_NULL_HANDLE && hb != SF_NULL_HANDLE && ha != hb );
+    CPPUNIT_ASSERT( table.Get(ha) == &a );
+    CPPUNIT_ASSERT( table.Get(hb) == &b );
+    CPPUNIT_ASSERT( table.Get(SF_NULL_HANDLE) == nullptr );
+    CPPUNIT_ASSERT_EQUAL( 2, table.GetLive() );
+  }
+
+  void testStale() {
+    SFHandleTable table;
+    int a, b;
+    SFHandle ha = table.Create(&a);
+    table.Destroy(ha);
+
+    CPPUNIT_ASSERT( !table.IsValid(ha) );
+    CPPUNIT_ASSERT( table.Get(ha) == nullptr );
+
+    // The slot is taken again, but the old handle must not find the new object
+    SFHandle hb = table.Create(&b);
+    CPPUNIT_ASSERT_EQUAL( SFHandleIndex(ha), SFHandleIndex(hb) );
+    CPPUNIT_ASSERT( table.Get(ha) == nullptr );
+    CPPUNIT_ASSERT( table.Get(hb) == &b );
+
+    // Destroying a stale handle leaves the new object alone
+    table.Destroy(ha);
+    CPPUNIT_ASSERT( table.Get(hb) == &b );
+    CPPUNIT_ASSERT_EQUAL( 1, table.GetLive() );
+  }
+
+  void testReuse() {
+    SFHandleTable table;
+    int object;
+    vector<SFHandle> handles;
+    for(int i = 0; i < 10; i++) {
+      handles.push_back(table.Create(&object));
+    }
+
+    // Churning through spawns and deaths doesn't grow the table
+    for(int i = 0; i < 1000; i++) {
+      table.Destroy(handles[i % 10]);
+      handles[i % 10] = table.Create(&object);
+    }
+    CPPUNIT_ASSERT_EQUAL( 10, table.GetCapacity() );
+    CPPUNIT_ASSERT_EQUAL( 10, table.GetLive() );
+
+    set<SFHandle> unique(handles.begin(), handles.end());
+    CPPUNIT_ASSERT_EQUAL( (size_t) 10, unique.size() );
+  }
+
+  void testGenerationWraps() {
+    SFHandleTable table;
+    int object;
+    SFHandle first = table.Create(&object), h = first;
+    for(uint32_t generation = 2; generation < SF_HANDLE_GENERATIONS; generation++) {
+      table.Destroy(h);
+      h = table.Create(&object);
+      CPPUNIT_ASSERT_EQUAL( generation, SFHandleGeneration(h) );
+      CPPUNIT_ASSERT_EQUAL( SFHandleIndex(first), SFHandleIndex(h) );
+    }
+    // Every generation but 0 has been used, so the next one is 1 again
+    table.Destroy(h);
+    h = table.Create(&object);
+    CPPUNIT_ASSERT_EQUAL( (uint32_t) 1, SFHandleGeneration(h) );
+    CPPUNIT_ASSERT( table.Get(h) == &object );
+  }
+
+  void testManyLive() {
+    // More live at once than a 16 bit slot number could count, as a big stress test has
+    SFHandleTable table;
+    int object;
+    vector<SFHandle> handles;
+    for(int i = 0; i < 70000; i++) {
+      handles.push_back(table.Create(&object));
+    }
+    CPPUNIT_ASSERT_EQUAL( 70000, table.GetLive() );
+    CPPUNIT_ASSERT_EQUAL( (uint32_t) 69999, SFHandleIndex(handles.back()) );
+    CPPUNIT_ASSERT( table.Get(handles.back()) == &object );
+    table.Destroy(handles[0]);
+    CPPUNIT_ASSERT( table.Get(handles[0]) == nullptr );
+    CPPUNIT_ASSERT( table.Get(handles[1]) == &object );
+  }
+
+  void testLimits() {
+    // Handles stay 32 bits, split between the slot and the generation
+    CPPUNIT_ASSERT_EQUAL( (size_t) 4, sizeof(SFHandle) );
+    CPPUNIT_ASSERT_EQUAL( (uint64_t) 1 << 32, (uint64_t) SF_HANDLE_MAX * SF_HANDLE_GENERATIONS );
+
+    SFHandle last = ((SF_HANDLE_GENERATIONS - 1) << SF_HANDLE_BITS) | (SF_HANDLE_MAX - 1);
+    CPPUNIT_ASSERT_EQUAL( SF_HANDLE_MAX - 1, SFHandleIndex(last) );
+    CPPUNIT_ASSERT_EQUAL( SF_HANDLE_GENERATIONS - 1, SFHandleGeneration(last) );
+
+    // A slot past the end of the table isn't valid, whatever its generation
+    SFHandleTable table;
+    int object;
+    table.Create(&object);
+    CPPUNIT_ASSERT( !table.IsValid(last) );
+    CPPUNIT_ASSERT( table.Get(last) == nullptr );
+  }
+};
+
+#endif
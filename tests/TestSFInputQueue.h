@@ -0,0 +1,155 @@
+#ifndef TESTSFINPUTQUEUE_H
+#define TESTSFINPUTQUEUE_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <thread>
+
+using namespace std;
+
+#include "SFInputQueue.h"
+
+class TestSFInputQueue : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFInputQueue );
+  CPPUNIT_TEST( testOrder );
+  CPPUNIT_TEST( testFull );
+  CPPUNIT_TEST( testTwoThreads );
+  CPPUNIT_TEST( testTapBetweenTicks );
+  CPPUNIT_TEST( testFires );
+  CPPUNIT_TEST_SUITE_END();
+
+  static SFKeyEvent Key(uint64_t time, SFKEY key, bool down, bool repeat = false) {
+    SFKeyEvent e;
+    e.time   = time;
+    e.key    = key;
+    e.down   = down;
+    e.repeat = repeat;
+    return e;
+  }
+
+public:
+  TestSFInputQueue( ) : CppUnit::TestCase( "TestSFInputQueue" ) {}
+  TestSFInputQueue( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testOrder() {
+    SFInputQueue queue(5);
+    CPPUNIT_ASSERT_EQUAL( 8, queue.GetCapacity() );
+
+    // Round the ring a few times, a few at a time
+    SFKeyEvent e;
+    uint64_t pushed = 0, popped = 0;
+    for(int round = 0; round < 10; round++) {
+      for(int i = 0; i < 5; i++) {
+        CPPUNIT_ASSERT( queue.Push(Key(pushed++, SFKEY_FIRE, true)) );
+      }
+      for(int i = 0; i < 5; i++) {
+        CPPUNIT_ASSERT( queue.Pop(e) );
+        CPPUNIT_ASSERT_EQUAL( popped++, e.time );
+      }
+      CPPUNIT_ASSERT( !queue.Pop(e) );
+    }
+  }
+
+  void testFull() {
+    SFInputQueue queue(4);
+    for(int i = 0; i < 6; i++) {
+      CPPUNIT_ASSERT_EQUAL( i < 4, queue.Push(Key(i, SFKEY_UP, true)) );
+    }
+    CPPUNIT_ASSERT_EQUAL( 2L, queue.GetDropped() );
+
+    // The ones that fitted are still there, and there's room again after taking one
+    SFKeyEvent e;
+    CPPUNIT_ASSERT( queue.Pop(e) );
+    CPPUNIT_ASSERT_EQUAL( (uint64_t) 0, e.time );
+    CPPUNIT_ASSERT( queue.Push(Key(9, SFKEY_UP, true)) );
+  }
+
+  void testTwoThreads() {
+    // Everything pushed from one thread comes out of the other once, in order
+    SFInputQueue queue(16);
+    const uint64_t count = 200000;
+    thread producer([&queue, count]() {
+      for(uint64_t i = 0; i < count; ) {
+        if(queue.Push(Key(i, (SFKEY) (i % SFKEY_LAST), i % 2 == 0))) {
+          i++;
+        }
+        else {
+          this_thread::yield();
+        }
+      }
+    });
+
+    SFKeyEvent e;
+    bool inOrder = true;
+    for(uint64_t next = 0; next < count; ) {
+      if(queue.Pop(e)) {
+        inOrder = inOrder && e.time == next && e.key == (SFKEY) (next % SFKEY_LAST) && e.down == (next % 2 == 0);
+        next++;
+      }
+      else {
+        this_thread::yield();
+      }
+    }
+    producer.join();
+    CPPUNIT_ASSERT( inOrder );
+    CPPUNIT_ASSERT( !queue.Pop(e) );
+  }
+
+  void testTapBetweenTicks() {
+    SFInputQueue queue;
+    SFInputTracker tracker(1000);
+
+    // Tapped and let go before the tick still moves for that tick, but not the next
+    queue.Push(Key(0, SFKEY_LEFT, true));
+    queue.Push(Key(5, SFKEY_LEFT, false));
+    CPPUNIT_ASSERT( tracker.Tick(queue, 16).left );
+    CPPUNIT_ASSERT( !tracker.Tick(queue, 32).left );
+
+    // Held until it's let go, repeats or not
+    queue.Push(Key(40, SFKEY_UP, true));
+    CPPUNIT_ASSERT( tracker.Tick(queue, 48).up );
+    queue.Push(Key(50, SFKEY_UP, true, true));
+    CPPUNIT_ASSERT( tracker.Tick(queue, 64).up );
+    CPPUNIT_ASSERT( tracker.Tick(queue, 80).up );
+
+    // An arrow and WASD for the same way: still held until both are let go
+    queue.Push(Key(81, SFKEY_UP, true));
+    queue.Push(Key(82, SFKEY_UP, false));
+    CPPUNIT_ASSERT( tracker.Tick(queue, 96).up );
+    queue.Push(Key(97, SFKEY_UP, false));
+    CPPUNIT_ASSERT( !tracker.Tick(queue, 112).up );
+
+    // Letting go of a key that was down before anyone was watching doesn't leave it stuck
+    queue.Push(Key(113, SFKEY_DOWN, false));
+    queue.Push(Key(114, SFKEY_DOWN, true));
+    queue.Push(Key(115, SFKEY_DOWN, false));
+    tracker.Tick(queue, 128);
+    CPPUNIT_ASSERT( !tracker.Tick(queue, 144).down );
+
+    // The wait is from when each event was read to the tick that took it
+    CPPUNIT_ASSERT_EQUAL( 10L, tracker.GetEvents() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 16.0, tracker.GetWorstWaitMs(), 1e-9 );
+  }
+
+  void testFires() {
+    SFInputQueue queue;
+    SFInputTracker tracker(1000);
+
+    // Every press counts, including the keyboard's repeats while it's held, but not the release
+    queue.Push(Key(0, SFKEY_FIRE, true));
+    queue.Push(Key(1, SFKEY_FIRE, false));
+    queue.Push(Key(2, SFKEY_FIRE, true));
+    queue.Push(Key(3, SFKEY_FIRE, true, true));
+    SFInputState input = tracker.Tick(queue, 16);
+    CPPUNIT_ASSERT_EQUAL( 3, input.fires );
+    CPPUNIT_ASSERT( !input.up && !input.down && !input.left && !input.right );
+
+    // Only counted once
+    CPPUNIT_ASSERT_EQUAL( 0, tracker.Tick(queue, 32).fires );
+  }
+};
+
+#endif
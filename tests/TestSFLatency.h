@@ -0,0 +1,100 @@
+#ifndef TESTSFLATENCY_H
+#define TESTSFLATENCY_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+
+using namespace std;
+
+#include "SFLatency.h"
+
+class TestSFLatency : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFLatency );
+  CPPUNIT_TEST( testHistogram );
+  CPPUNIT_TEST( testStages );
+  CPPUNIT_TEST( testSkippedPresent );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSFLatency( ) : CppUnit::TestCase( "TestSFLatency" ) {}
+  TestSFLatency( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testHistogram() {
+    SFLatencyHistogram histogram;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, histogram.GetPercentileMs(0.5), 1e-9 );
+
+    // 1 to 100 ms, then one far past the last bucket
+    for(int i = 1; i <= 100; i++) {
+      histogram.Add(i - 0.5);
+    }
+    histogram.Add(250.0);
+    CPPUNIT_ASSERT_EQUAL( 101L, histogram.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( 1L, histogram.GetBucket(0) );
+    CPPUNIT_ASSERT_EQUAL( 1L, histogram.GetBucket(SFLatencyHistogram::SF_LATENCY_BUCKETS) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 51.0, histogram.GetPercentileMs(0.50), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 96.0, histogram.GetPercentileMs(0.95), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 250.0, histogram.GetPercentileMs(1.0), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 250.0, histogram.GetWorstMs(), 1e-9 );
+
+    // A percentile is never past the worst, even in the same bucket
+    SFLatencyHistogram one;
+    one.Add(16.25);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 16.25, one.GetPercentileMs(0.5), 1e-9 );
+  }
+
+  void testStages() {
+    // Counter ticks are microseconds
+    SFLatencyTracer tracer(1000000);
+    vector<uint64_t> arrivals;
+    arrivals.push_back(1000);
+    arrivals.push_back(9000);
+
+    tracer.Consume(arrivals, 17000);
+    CPPUNIT_ASSERT_EQUAL( 2, tracer.GetPending() );
+    tracer.Presenting(20000);
+    tracer.Presented(SFPRESENT_VSYNC, 26000);
+    CPPUNIT_ASSERT_EQUAL( 0, tracer.GetPending() );
+
+    // 25 and 17 ms, all of it in the vsync histogram
+    const SFLatencyHistogram & vsync = tracer.GetHistogram(SFPRESENT_VSYNC);
+    CPPUNIT_ASSERT_EQUAL( 2L, vsync.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( 0L, tracer.GetHistogram(SFPRESENT_IMMEDIATE).GetCount() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 21.0, vsync.GetMeanMs(), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 25.0, vsync.GetWorstMs(), 1e-9 );
+
+    // Waiting for the tick, the tick itself and the present add up to it
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 12.0, tracer.GetQueueMs(SFPRESENT_VSYNC), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, tracer.GetFrameMs(SFPRESENT_VSYNC), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 6.0, tracer.GetPresentMs(SFPRESENT_VSYNC), 1e-9 );
+
+    // Only modes that presented something are printed
+    ostringstream out;
+    tracer.Print(out);
+    CPPUNIT_ASSERT( out.str().find("vsync") != string::npos );
+    CPPUNIT_ASSERT( out.str().find("immediate") == string::npos );
+  }
+
+  void testSkippedPresent() {
+    SFLatencyTracer tracer(1000);
+    vector<uint64_t> arrivals(1, 0);
+
+    // A frame cap skipped the draw for the tick that took the key, so the next present shows it
+    tracer.Consume(arrivals, 16);
+    tracer.Consume(vector<uint64_t>(), 33);
+    tracer.Presenting(40);
+    tracer.Presented(SFPRESENT_IMMEDIATE, 41);
+    CPPUNIT_ASSERT_EQUAL( 1L, tracer.GetHistogram(SFPRESENT_IMMEDIATE).GetCount() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 41.0, tracer.GetHistogram(SFPRESENT_IMMEDIATE).GetWorstMs(), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 24.0, tracer.GetFrameMs(SFPRESENT_IMMEDIATE), 1e-9 );
+
+    // Nothing pending, nothing counted
+    tracer.Presented(SFPRESENT_IMMEDIATE, 60);
+    CPPUNIT_ASSERT_EQUAL( 1L, tracer.GetHistogram(SFPRESENT_IMMEDIATE).GetCount() );
+  }
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef TESTSFMASK_H
+#define TESTSFMASK_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdlib>
+
+using namespace std;
+
+#include "SFMask.h"
+
+class TestSFMask : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFMask );
+  CPPUNIT_TEST( testBuild );
+  CPPUNIT_TEST( testCorners );
+  CPPUNIT_TEST( testMatchesPixels );
+  CPPUNIT_TEST_SUITE_END();
+
+  // A disc of solid pixels filling a w by h image, see-through in the corners
+  static SFImage Disc(int w, int h) {
+    SFImage image(w, h);
+    for(int y = 0; y < h; y++) {
+      for(int x = 0; x < w; x++) {
+        float u = (x + 0.5f) / w - 0.5f, v = (y + 0.5f) / h - 0.5f;
+        image.GetPixels()[y * w + x] = SFRgba(255, 255, 255, u * u + v * v <= 0.25f ? 255 : 0);
+      }
+    }
+    return image;
+  }
+
+  // Random pixels, about one in density solid
+  static SFImage Noise(int w, int h, int density) {
+    SFImage image(w, h);
+    for(int i = 0; i < w * h; i++) {
+      image.GetPixels()[i] = SFRgba(0, 0, 0, rand() % density == 0 ? 255 : 0);
+    }
+    return image;
+  }
+
+  // The slow way: every pixel of a against the pixel of b on top of it
+  static bool PixelsOverlap(const SFMask & a, const SFMask & b, int dx, int dy) {
+    for(int y = 0; y < a.GetHeight(); y++) {
+      for(int x = 0; x < a.GetWidth(); x++) {
+        if(a.Get(x, y) && b.Get(x - dx, y - dy)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+public:
+  TestSFMask( ) : CppUnit::TestCase( "TestSFMask" ) {}
+  TestSFMask( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testBuild() {
+    uint32_t pixels[6] = { SFRgba(0, 0, 0, 0),   SFRgba(0, 0, 0, 127), SFRgba(0, 0, 0, 128),
+                           SFRgba(0, 0, 0, 255), SFRgba(0, 0, 0, 0),   SFRgba(0, 0, 0, 200) };
+    SFMask mask(SFImage(3, 2, pixels));
+    CPPUNIT_ASSERT_EQUAL( 3, mask.GetWidth() );
+    CPPUNIT_ASSERT_EQUAL( 2, mask.GetHeight() );
+    CPPUNIT_ASSERT( !mask.Get(0, 0) );
+    CPPUNIT_ASSERT( !mask.Get(1, 0) );
+    CPPUNIT_ASSERT( mask.Get(2, 0) );
+    CPPUNIT_ASSERT( mask.Get(0, 1) );
+    CPPUNIT_ASSERT_EQUAL( 3, mask.GetSolid() );
+
+    // Off the edges is never solid
+    CPPUNIT_ASSERT( !mask.Get(-1, 1) );
+    CPPUNIT_ASSERT( !mask.Get(3, 0) );
+
+    // A lower threshold takes in more
+    CPPUNIT_ASSERT_EQUAL( 4, SFMask(SFImage(3, 2, pixels), 1).GetSolid() );
+  }
+
+  void testCorners() {
+    // Two discs whose boxes overlap only at the corners don't touch
+    SFMask a(Disc(60, 44)), b(Disc(32, 34));
+    CPPUNIT_ASSERT( !SFMask::Overlaps(a, b, 55, 40) );
+    CPPUNIT_ASSERT( !SFMask::Overlaps(a, b, -28, -30) );
+
+    // Side by side they do, and far apart they don't
+    CPPUNIT_ASSERT( SFMask::Overlaps(a, b, 40, 5) );
+    CPPUNIT_ASSERT( SFMask::Overlaps(b, a, -40, -5) );
+    CPPUNIT_ASSERT( !SFMask::Overlaps(a, b, 100, 0) );
+  }
+
+  void testMatchesPixels() {
+    // Wider than a word, so lining the rows up has to carry bits between words
+    srand(11);
+    for(int i = 0; i < 20; i++) {
+      SFMask a(Noise(70 + rand() % 90, 1 + rand() % 12, 40)), b(Noise(1 + rand() % 140, 1 + rand() % 12, 40));
+      for(int dx = -b.GetWidth() - 2; dx <= a.GetWidth() + 2; dx += 1 + rand() % 7) {
+        for(int dy = -b.GetHeight(); dy <= a.GetHeight(); dy++) {
+          CPPUNIT_ASSERT_EQUAL( PixelsOverlap(a, b, dx, dy), SFMask::Overlaps(a, b, dx, dy) );
+        }
+      }
+    }
+  }
+};
+
+#endif
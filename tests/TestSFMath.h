@@ -0,0 +1,73 @@
+#ifndef TESTSFMATH_H
+#define TESTSFMATH_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <type_traits>
+
+using namespace std;
+
+#include "SFMath.h"
+
+// These need to hold for the compiler to copy and fold the types freely
+static_assert(is_trivially_copyable<Vector2>::value, "Vector2 should be trivially copyable");
+static_assert(is_trivially_copyable<Point2>::value, "Point2 should be trivially copyable");
+static_assert(dot(Vector2(1.0f, 2.0f), Vector2(3.0f, 4.0f)) == 11.0f, "dot should be constexpr");
+
+class TestSFMath : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFMath );
+  CPPUNIT_TEST( testVectorOps );
+  CPPUNIT_TEST( testPointOps );
+  CPPUNIT_TEST( testMinMaxClamp );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSFMath( ) : CppUnit::TestCase( "TestSFMath" ) {}
+  TestSFMath( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testVectorOps() {
+    Vector2 a(1.0f, 2.0f), b(4.0f, -3.0f);
+
+    Vector2 d = a - b;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -3.0f, d.getX(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 5.0f, d.getY(), 0.0001f );
+
+    Vector2 n = -a;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -1.0f, n.getX(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -2.0f, n.getY(), 0.0001f );
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( -2.0f, dot(a, b), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 25.0f, lengthSqr(b), 0.0001f );
+  }
+
+  void testPointOps() {
+    Point2 p(10.0f, 20.0f), q(4.0f, 8.0f);
+
+    Vector2 v = p - q;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 6.0f, v.getX(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 12.0f, v.getY(), 0.0001f );
+
+    Point2 r = q + v;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( p.getX(), r.getX(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( p.getY(), r.getY(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 20.0f, projection(p, yAxis()), 0.0001f );
+  }
+
+  void testMinMaxClamp() {
+    Vector2 a(1.0f, 8.0f), b(3.0f, 2.0f);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, minPerElem(a, b).getX(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0f, minPerElem(a, b).getY(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0f, maxPerElem(a, b).getX(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 8.0f, maxPerElem(a, b).getY(), 0.0001f );
+
+    Vector2 c = clampPerElem(Vector2(-5.0f, 50.0f), Vector2(0.0f, 0.0f), Vector2(10.0f, 10.0f));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0f, c.getX(), 0.0001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 10.0f, c.getY(), 0.0001f );
+  }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef TESTSFPARTICLES_H
+#define TESTSFPARTICLES_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#include "SFParticles.h"
+
+class TestSFParticles : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFParticles );
+  CPPUNIT_TEST( testKernelsAgree );
+  CPPUNIT_TEST( testMoveAndDie );
+  CPPUNIT_TEST( testFullPoolDrops );
+  CPPUNIT_TEST( testSprites );
+  CPPUNIT_TEST_SUITE_END();
+
+  // A 2x2 sheet of 16 pixel frames, growing from 10 to 30 pixels across
+  static SFParticleStyle Style() {
+    SFParticleStyle style = { -0.5f, 0.9f, 10.0f, 30.0f, 4, 2, 16, 16 };
+    return style;
+  }
+
+  static float Random() {
+    return (rand() % 20001 - 10000) / 100.0f;
+  }
+
+public:
+  TestSFParticles( ) : CppUnit::TestCase( "TestSFParticles" ) {}
+  TestSFParticles( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testKernelsAgree() {
+#ifdef SF_RASTER_SSE2
+    srand(11);
+    // Odd lengths so the scalar tail gets used too
+    for(int n = 1; n < 40; n += 3) {
+      vector<float> a[5], b[5];
+      for(int f = 0; f < 5; f++) {
+        for(int i = 0; i < n; i++) {
+          a[f].push_back(Random());
+        }
+        b[f] = a[f];
+      }
+      for(int tick = 0; tick < 10; tick++) {
+        SFParticleStepScalar(a[0].data(), a[1].data(), a[2].data(), a[3].data(), a[4].data(), n, 0.93f, -0.2f);
+        SFParticleStepSSE2(b[0].data(), b[1].data(), b[2].data(), b[3].data(), b[4].data(), n, 0.93f, -0.2f);
+      }
+      for(int f = 0; f < 5; f++) {
+        CPPUNIT_ASSERT( a[f] == b[f] );
+      }
+    }
+#endif
+  }
+
+  void testMoveAndDie() {
+    SFParticlePool pool(8, Style());
+    pool.Emit(0.0f, 100.0f, 10.0f, 0.0f, 2.0f);
+    pool.Emit(0.0f, 100.0f, 0.0f, 0.0f, 5.0f);
+
+    // Drag first, then gravity, then move
+    pool.Update();
+    CPPUNIT_ASSERT_EQUAL( 2, pool.GetCount() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 9.0, pool.GetX(0), 1e-5 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 99.5, pool.GetY(0), 1e-5 );
+
+    // The first one's life is up after two ticks and the second takes its place
+    pool.Update();
+    CPPUNIT_ASSERT_EQUAL( 1, pool.GetCount() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, pool.GetX(0), 1e-5 );
+
+    for(int i = 0; i < 3; i++) {
+      pool.Update();
+    }
+    CPPUNIT_ASSERT_EQUAL( 0, pool.GetCount() );
+  }
+
+  void testFullPoolDrops() {
+    SFParticlePool pool(3, Style());
+    for(int i = 0; i < 5; i++) {
+      pool.Emit(0.0f, 0.0f, 0.0f, 0.0f, 10.0f);
+    }
+    CPPUNIT_ASSERT_EQUAL( 3, pool.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( 2L, pool.GetDropped() );
+  }
+
+  void testSprites() {
+    SFParticlePool pool(8, Style());
+    pool.Emit(100.0f, 380.0f, 0.0f, 0.5f, 4.0f);
+    pool.Emit(-500.0f, 100.0f, 0.0f, 0.5f, 4.0f);
+
+    vector<SFSprite> sprites;
+    pool.BuildSprites(sprites, 640, 480);
+    // The one off the screen isn't drawn
+    CPPUNIT_ASSERT_EQUAL( (size_t) 1, sprites.size() );
+    // Centred on it, with y turned the screen's way up, on the first frame and not faded
+    CPPUNIT_ASSERT_EQUAL( 95, sprites[0].dst.x );
+    CPPUNIT_ASSERT_EQUAL( 95, sprites[0].dst.y );
+    CPPUNIT_ASSERT_EQUAL( 10, sprites[0].dst.w );
+    CPPUNIT_ASSERT_EQUAL( 0, sprites[0].src.x );
+    CPPUNIT_ASSERT_EQUAL( 255, (int) sprites[0].alpha );
+
+    // Three quarters through its life: the last frame (bottom right), bigger and mostly faded
+    for(int i = 0; i < 3; i++) {
+      pool.Update();
+    }
+    sprites.clear();
+    pool.BuildSprites(sprites, 640, 480);
+    CPPUNIT_ASSERT_EQUAL( 16, sprites[0].src.x );
+    CPPUNIT_ASSERT_EQUAL( 16, sprites[0].src.y );
+    CPPUNIT_ASSERT_EQUAL( 25, sprites[0].dst.w );
+    CPPUNIT_ASSERT_EQUAL( 63, (int) sprites[0].alpha );
+  }
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef TESTSFPERFGATE_H
+#define TESTSFPERFGATE_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+#include "SFPerfGate.h"
+
+class TestSFPerfGate : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFPerfGate );
+  CPPUNIT_TEST( testSummary );
+  CPPUNIT_TEST( testSameRunPasses );
+  CPPUNIT_TEST( testSlowerPhaseFails );
+  CPPUNIT_TEST( testNoiseIsTolerated );
+  CPPUNIT_TEST( testBaselineRoundTrip );
+  CPPUNIT_TEST_SUITE_END();
+
+  // frames frames where movement takes ms, give or take jitter, and every spikeEvery-th frame twice that
+  static vector<SFFrameSample> Run(int frames, double ms, double jitter, int spikeEvery = 0) {
+    vector<SFFrameSample> samples(frames);
+    for(int i = 0; i < frames; i++) {
+      SFFrameSample & s = samples[i];
+      for(int p = 0; p < SFPHASE_LAST; p++) {
+        s.phaseMs[p] = 0.01;
+      }
+      s.phaseMs[SFPHASE_MOVEMENT] = ms + jitter * ((i * 7919) % 101 - 50) / 50.0;
+      if(spikeEvery > 0 && i % spikeEvery == 0) {
+        s.phaseMs[SFPHASE_MOVEMENT] *= 2.0;
+      }
+      s.allocs = 0;
+    }
+    return samples;
+  }
+
+public:
+  TestSFPerfGate( ) : CppUnit::TestCase( "TestSFPerfGate" ) {}
+  TestSFPerfGate( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testSummary() {
+    SFRunSummary s = SFRunSummary::Of(Run(1000, 2.0, 0.0, 50));
+    CPPUNIT_ASSERT_EQUAL( 1000L, s.frames );
+    // 2% of frames doubling moves neither the median nor the 95th percentile
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, s.median[SFPHASE_MOVEMENT], 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, s.p95[SFPHASE_MOVEMENT], 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, s.mad[SFPHASE_MOVEMENT], 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0 + 0.01 * (SFPHASE_LAST - 1), s.median[SF_PERF_FRAME], 1e-9 );
+
+    // 10% of them does move the 95th
+    s = SFRunSummary::Of(Run(1000, 2.0, 0.0, 10));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 4.0, s.p95[SFPHASE_MOVEMENT], 1e-9 );
+  }
+
+  void testSameRunPasses() {
+    SFRunSummary base = SFRunSummary::Of(Run(600, 2.0, 0.2));
+    ostringstream out;
+    CPPUNIT_ASSERT( SFPerfCompare(base, base, SFPerfTolerance(), out) );
+  }
+
+  void testSlowerPhaseFails() {
+    SFRunSummary base = SFRunSummary::Of(Run(600, 2.0, 0.2));
+    SFRunSummary now  = SFRunSummary::Of(Run(600, 2.6, 0.2));
+    ostringstream out;
+    CPPUNIT_ASSERT( !SFPerfCompare(base, now, SFPerfTolerance(), out) );
+    // and says which phase it was
+    CPPUNIT_ASSERT( out.str().find("SLOWER") != string::npos );
+    CPPUNIT_ASSERT( out.str().find(SFPerfMetricName(SFPHASE_MOVEMENT)) != string::npos );
+
+    // More allocations fail too, even if nothing is slower
+    now = base;
+    now.allocs = base.allocs + 1.0;
+    CPPUNIT_ASSERT( !SFPerfCompare(base, now, SFPerfTolerance(), out) );
+  }
+
+  void testNoiseIsTolerated() {
+    // A few frames, all over the place: 15% slower is within the noise
+    SFRunSummary base = SFRunSummary::Of(Run(30, 2.0, 1.5));
+    SFRunSummary now  = SFRunSummary::Of(Run(30, 2.3, 1.5));
+    ostringstream out;
+    CPPUNIT_ASSERT( SFPerfCompare(base, now, SFPerfTolerance(), out) );
+
+    // The same from lots of steady frames isn't
+    base = SFRunSummary::Of(Run(2000, 2.0, 0.05));
+    now  = SFRunSummary::Of(Run(2000, 2.3, 0.05));
+    CPPUNIT_ASSERT( !SFPerfCompare(base, now, SFPerfTolerance(), out) );
+  }
+
+  void testBaselineRoundTrip() {
+    SFRunSummary run = SFRunSummary::Of(Run(100, 1.5, 0.1));
+    run.allocs = 3.5;
+    SFPerfBaseline saved;
+    saved.Set("strafe", run);
+    CPPUNIT_ASSERT( saved.Save("test_baseline.csv") );
+
+    SFPerfBaseline loaded;
+    CPPUNIT_ASSERT( loaded.Load("test_baseline.csv") );
+    remove("test_baseline.csv");
+
+    CPPUNIT_ASSERT( loaded.Has("strafe") );
+    CPPUNIT_ASSERT( !loaded.Has("dodge") );
+    const SFRunSummary & back = loaded.Get("strafe");
+    CPPUNIT_ASSERT_EQUAL( 100L, back.frames );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.5, back.allocs, 1e-6 );
+    for(int m = 0; m < SF_PERF_METRICS; m++) {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL( run.median[m], back.median[m], 1e-6 );
+      CPPUNIT_ASSERT_DOUBLES_EQUAL( run.p95[m], back.p95[m], 1e-6 );
+      CPPUNIT_ASSERT_DOUBLES_EQUAL( run.mad[m], back.mad[m], 1e-6 );
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef TESTSFRASTER_H
+#define TESTSFRASTER_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+#include "SFRaster.h"
+
+class TestSFRaster : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFRaster );
+  CPPUNIT_TEST( testBlend );
+  CPPUNIT_TEST( testKernelsAgree );
+  CPPUNIT_TEST( testBlitClipped );
+  CPPUNIT_TEST( testBlitScaled );
+  CPPUNIT_TEST( testLayerComposite );
+  CPPUNIT_TEST( testGoldenFrame );
+  CPPUNIT_TEST_SUITE_END();
+
+  // A sprite with every kind of pixel: clear corners, a soft edge and a solid middle
+  SFImage Sprite(int w, int h, uint8_t r, uint8_t g, uint8_t b) {
+    SFImage sprite(w, h);
+    for(int y = 0; y < h; y++) {
+      for(int x = 0; x < w; x++) {
+        int edge = min(min(x, w - 1 - x), min(y, h - 1 - y));
+        uint8_t a = edge == 0 ? 0 : (edge == 1 ? 96 : 255);
+        sprite.GetPixels()[y * w + x] = SFRgba(r, g, b, a);
+      }
+    }
+    return sprite;
+  }
+
+public:
+  TestSFRaster( ) : CppUnit::TestCase( "TestSFRaster" ) {}
+  TestSFRaster( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testBlend() {
+    uint32_t dst[3] = { SFRgba(0, 0, 255), SFRgba(0, 0, 255), SFRgba(10, 20, 30, 40) };
+    uint32_t src[3] = { SFRgba(255, 0, 0, 128), SFRgba(255, 0, 0, 0), SFRgba(1, 2, 3, 255) };
+    SFBlendSpan(dst, src, 3);
+
+    // Half red over blue, rounded to the nearest
+    CPPUNIT_ASSERT_EQUAL( SFRgba(128, 0, 127, 255), dst[0] );
+    // Clear leaves it alone, opaque replaces it
+    CPPUNIT_ASSERT_EQUAL( SFRgba(0, 0, 255), dst[1] );
+    CPPUNIT_ASSERT_EQUAL( SFRgba(1, 2, 3, 255), dst[2] );
+
+    // Blending onto something see-through adds up the alpha
+    uint32_t clear = SFRgba(0, 0, 0, 0);
+    SFBlendFill(&clear, SFRgba(255, 255, 255, 51), 1);
+    CPPUNIT_ASSERT_EQUAL( SFRgba(51, 51, 51, 51), clear );
+  }
+
+  void testKernelsAgree() {
+#ifdef SF_RASTER_SSE2
+    srand(7);
+    // Odd lengths so the scalar tail gets used too
+    for(int n = 1; n < 70; n += 3) {
+      vector<uint32_t> src(n), a(n), b(n);
+      for(int i = 0; i < n; i++) {
+        uint8_t alpha = (rand() % 3 == 0) ? 255 : (rand() % 3 == 0 ? 0 : rand() % 256);
+        src[i] = SFRgba(rand() % 256, rand() % 256, rand() % 256, alpha);
+        a[i] = b[i] = SFRgba(rand() % 256, rand() % 256, rand() % 256, rand() % 256);
+      }
+      SFBlendSpanScalar(a.data(), src.data(), n);
+      SFBlendSpanSSE2(b.data(), src.data(), n);
+      CPPUNIT_ASSERT( a == b );
+    }
+#endif
+  }
+
+  void testBlitClipped() {
+    SFImage frame(8, 8, SFRgba(0, 0, 0));
+    SFImage sprite(4, 4, SFRgba(255, 255, 255));
+
+    // Hanging off the top left, only the bottom right quarter lands
+    SFRect dst = { -2, -2, 4, 4 };
+    frame.Blit(sprite, NULL, dst);
+    CPPUNIT_ASSERT_EQUAL( SFRgba(255, 255, 255), frame.GetPixel(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( SFRgba(255, 255, 255), frame.GetPixel(1, 1) );
+    CPPUNIT_ASSERT_EQUAL( SFRgba(0, 0, 0), frame.GetPixel(2, 0) );
+    CPPUNIT_ASSERT_EQUAL( SFRgba(0, 0, 0), frame.GetPixel(0, 2) );
+
+    // Entirely off the image draws nothing
+    SFRect away = { 100, 100, 4, 4 };
+    uint32_t before = frame.Checksum();
+    frame.Blit(sprite, NULL, away);
+    CPPUNIT_ASSERT_EQUAL( before, frame.Checksum() );
+  }
+
+  void testBlitScaled() {
+    uint32_t pixels[4] = { SFRgba(255, 0, 0), SFRgba(0, 255, 0), SFRgba(0, 0, 255), SFRgba(255, 255, 255) };
+    SFImage sprite(2, 2, pixels);
+    SFImage frame(4, 4);
+
+    // Each source pixel becomes a 2x2 block
+    SFRect dst = { 0, 0, 4, 4 };
+    frame.Blit(sprite, NULL, dst);
+    CPPUNIT_ASSERT_EQUAL( pixels[0], frame.GetPixel(1, 1) );
+    CPPUNIT_ASSERT_EQUAL( pixels[1], frame.GetPixel(2, 0) );
+    CPPUNIT_ASSERT_EQUAL( pixels[2], frame.GetPixel(1, 3) );
+    CPPUNIT_ASSERT_EQUAL( pixels[3], frame.GetPixel(3, 2) );
+
+    // Just the bottom right source pixel, stretched over everything
+    SFRect src = { 1, 1, 1, 1 };
+    frame.Blit(sprite, &src, dst);
+    CPPUNIT_ASSERT_EQUAL( pixels[3], frame.GetPixel(0, 0) );
+  }
+
+  void testLayerComposite() {
+    // Overlapping soft edged sprites, straight onto a background...
+    SFImage direct(24, 24, SFRgba(30, 60, 90));
+    SFImage a = Sprite(12, 12, 255, 0, 0), b = Sprite(10, 14, 0, 200, 255);
+    SFRect at = { 4, 4, 12, 12 }, bt = { 9, 6, 10, 14 };
+    direct.Blit(a, NULL, at);
+    direct.Blit(b, NULL, bt);
+
+    // ...and into a clear layer that's put on the background afterwards
+    SFImage layer(24, 24, SFRgba(0, 0, 0, 0));
+    layer.Blit(a, NULL, at);
+    layer.Blit(b, NULL, bt);
+    SFImage cached(24, 24, SFRgba(30, 60, 90));
+    SFRect all = { 0, 0, 24, 24 };
+    cached.Blit(layer, NULL, all, 255, SFBLEND_PREMULTIPLIED);
+
+    // The same, but for rounding
+    for(int y = 0; y < 24; y++) {
+      for(int x = 0; x < 24; x++) {
+        uint32_t p = direct.GetPixel(x, y), q = cached.GetPixel(x, y);
+        for(int shift = 0; shift < 32; shift += 8) {
+          CPPUNIT_ASSERT( abs((int) ((p >> shift) & 0xFF) - (int) ((q >> shift) & 0xFF)) <= 2 );
+        }
+      }
+    }
+    // Where nothing was drawn the layer leaves the background as it was
+    CPPUNIT_ASSERT_EQUAL( SFRgba(30, 60, 90), cached.GetPixel(0, 0) );
+  }
+
+  /*
+   * Draws a small scene the way a frame of the game is drawn (a background,
+   * overlapping sprites with soft edges, some of them off the edge, a
+   * see-through box and a line) and checks it comes out the same bytes as
+   * it always has. If this fails on purpose, Save the frame, look at it and
+   * update the checksum.
+   */
+  void testGoldenFrame() {
+    SFImage frame(64, 48, SFRgba(0, 0, 0));
+    SFImage stars = Sprite(80, 80, 200, 200, 255);
+    SFImage alien = Sprite(10, 12, 40, 160, 40);
+    SFImage shot  = Sprite(5, 6, 255, 128, 0);
+
+    SFRect back = { -8, -16, 80, 80 };
+    frame.Blit(stars, NULL, back);
+    for(int i = 0; i < 6; i++) {
+      SFRect at = { i * 11 - 3, 4 + (i % 3) * 7, 10, 12 };
+      frame.Blit(alien, NULL, at);
+      SFRect below = { i * 11, 30 - i, 5, 6 };
+      frame.Blit(shot, NULL, below);
+    }
+    SFRect big = { 40, 30, 20, 24 };
+    frame.Blit(alien, NULL, big);
+
+    SFRect box = { 2, 36, 30, 10 };
+    frame.Fill(box, SFRgba(0, 0, 0, 160));
+    frame.Line(0, 47, 63, 20, SFRgba(80, 220, 80));
+
+    CPPUNIT_ASSERT_EQUAL( 1590946970u, frame.Checksum() );
+  }
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef TESTSFSESSION_H
+#define TESTSFSESSION_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+#include "SFSession.h"
+
+class TestSFSession : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFSession );
+  CPPUNIT_TEST( testRoundTrip );
+  CPPUNIT_TEST( testHandWritten );
+  CPPUNIT_TEST( testBadLine );
+  CPPUNIT_TEST_SUITE_END();
+
+  static SFInputState Held(bool up, bool down, bool left, bool right, int fires) {
+    SFInputState input;
+    input.up    = up;
+    input.down  = down;
+    input.left  = left;
+    input.right = right;
+    input.fires = fires;
+    return input;
+  }
+
+public:
+  TestSFSession( ) : CppUnit::TestCase( "TestSFSession" ) {}
+  TestSFSession( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testRoundTrip() {
+    SFSession recorded(42);
+    for(int i = 0; i < 50; i++) {
+      recorded.Record(Held(i < 20, false, i >= 30, false, i % 25 == 0 ? 2 : 0));
+    }
+    CPPUNIT_ASSERT( recorded.Save("test_session.sfs") );
+
+    SFSession loaded;
+    CPPUNIT_ASSERT( loaded.Load("test_session.sfs") );
+    remove("test_session.sfs");
+
+    CPPUNIT_ASSERT_EQUAL( 42u, loaded.GetSeed() );
+    CPPUNIT_ASSERT_EQUAL( recorded.GetFrames(), loaded.GetFrames() );
+    for(int i = 0; i < recorded.GetFrames(); i++) {
+      CPPUNIT_ASSERT( recorded.GetFrame(i) == loaded.GetFrame(i) );
+    }
+  }
+
+  void testHandWritten() {
+    ofstream out("test_session.sfs");
+    out << "# comment" << endl << "seed 9" << endl << "3 UL 0" << endl << endl << "1 - 1" << endl;
+    out.close();
+
+    SFSession session;
+    CPPUNIT_ASSERT( session.Load("test_session.sfs") );
+    remove("test_session.sfs");
+
+    CPPUNIT_ASSERT_EQUAL( 9u, session.GetSeed() );
+    CPPUNIT_ASSERT_EQUAL( 4, session.GetFrames() );
+    CPPUNIT_ASSERT( session.GetFrame(2) == Held(true, false, true, false, 0) );
+    CPPUNIT_ASSERT( session.GetFrame(3) == Held(false, false, false, false, 1) );
+  }
+
+  void testBadLine() {
+    ofstream out("test_session.sfs");
+    out << "seed 1" << endl << "3 UX 0" << endl;
+    out.close();
+
+    SFSession session;
+    CPPUNIT_ASSERT( !session.Load("test_session.sfs") );
+    remove("test_session.sfs");
+  }
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef TESTSFSTARFIELD_H
+#define TESTSFSTARFIELD_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+using namespace std;
+
+#include "SFStarfield.h"
+
+class TestSFStarfield : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFStarfield );
+  CPPUNIT_TEST( testLayers );
+  CPPUNIT_TEST( testScroll );
+  CPPUNIT_TEST( testWrap );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSFStarfield( ) : CppUnit::TestCase( "TestSFStarfield" ) {}
+  TestSFStarfield( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testLayers() {
+    SFStarfield field(7, 640, 480, 3, 200);
+    CPPUNIT_ASSERT_EQUAL( 3, field.GetLayers() );
+    CPPUNIT_ASSERT_EQUAL( 200, field.GetCount() );
+
+    // Nearer layers are faster, no smaller, no dimmer and have fewer stars
+    int total = 0;
+    for(int i = 0; i < field.GetLayers(); i++) {
+      total += field.GetLayer(i).count;
+      if(i > 0) {
+        CPPUNIT_ASSERT( field.GetLayer(i).speed > field.GetLayer(i - 1).speed );
+        CPPUNIT_ASSERT( field.GetLayer(i).size >= field.GetLayer(i - 1).size );
+        CPPUNIT_ASSERT( field.GetLayer(i).alpha > field.GetLayer(i - 1).alpha );
+        CPPUNIT_ASSERT( field.GetLayer(i).count < field.GetLayer(i - 1).count );
+      }
+    }
+    CPPUNIT_ASSERT_EQUAL( 200, total );
+    CPPUNIT_ASSERT_EQUAL( 1.0f, field.GetLayer(2).speed );
+
+    // The same seed always makes the same sky
+    SFStarfield again(7, 640, 480, 3, 200);
+    for(int i = 0; i < field.GetCount(); i++) {
+      CPPUNIT_ASSERT_EQUAL( field.GetX(i), again.GetX(i) );
+      CPPUNIT_ASSERT_EQUAL( field.GetY(i), again.GetY(i) );
+      CPPUNIT_ASSERT( field.GetX(i) >= 0 && field.GetX(i) < 640 );
+      CPPUNIT_ASSERT( field.GetY(i) >= 0 && field.GetY(i) < 480 );
+    }
+
+    // No stars, or no layers, is an empty sky
+    CPPUNIT_ASSERT_EQUAL( 0, SFStarfield(7, 640, 480, 3, 0).GetCount() );
+    CPPUNIT_ASSERT_EQUAL( 0, SFStarfield(7, 640, 480, 0, 200).GetCount() );
+  }
+
+  void testScroll() {
+    SFStarfield field(7, 640, 480, 2, 10);
+    // The near layer moves a pixel, the far one half a pixel, which doesn't show yet
+    int last = field.GetCount() - 1, y0 = field.GetY(0), yLast = field.GetY(last);
+    CPPUNIT_ASSERT( field.Scroll(1.0f) );
+    CPPUNIT_ASSERT_EQUAL( y0, field.GetY(0) );
+    CPPUNIT_ASSERT_EQUAL( (yLast + 1) % 480, field.GetY(last) );
+
+    // Less than a pixel for every layer doesn't move anything
+    SFStarfield slow(7, 640, 480, 2, 10);
+    CPPUNIT_ASSERT( !slow.Scroll(0.25f) );
+    CPPUNIT_ASSERT( slow.Scroll(0.75f) );
+
+    // A sprite for every star, where the star is
+    vector<SFSprite> sprites;
+    field.BuildSprites(sprites, 1, 1);
+    CPPUNIT_ASSERT_EQUAL( (size_t) field.GetCount(), sprites.size() );
+    CPPUNIT_ASSERT_EQUAL( field.GetX(last), sprites[last].dst.x );
+    CPPUNIT_ASSERT_EQUAL( field.GetY(last), sprites[last].dst.y );
+    CPPUNIT_ASSERT_EQUAL( field.GetLayer(1).size, sprites[last].dst.w );
+
+    // Leaving out the far layer leaves only the near one's stars
+    sprites.clear();
+    field.BuildSprites(sprites, 1, 1, 1);
+    CPPUNIT_ASSERT_EQUAL( (size_t) field.GetLayer(1).count, sprites.size() );
+    CPPUNIT_ASSERT_EQUAL( field.GetY(last), sprites.back().dst.y );
+  }
+
+  void testWrap() {
+    SFStarfield field(3, 640, 480, 1, 50);
+    vector<int> before;
+    for(int i = 0; i < field.GetCount(); i++) {
+      before.push_back(field.GetY(i));
+    }
+
+    // A whole screen later every star is back where it started, having wrapped from the bottom
+    for(int t = 0; t < 480; t++) {
+      field.Scroll(1.0f);
+      for(int i = 0; i < field.GetCount(); i++) {
+        CPPUNIT_ASSERT( field.GetY(i) >= 0 && field.GetY(i) < 480 );
+      }
+    }
+    for(int i = 0; i < field.GetCount(); i++) {
+      CPPUNIT_ASSERT_EQUAL( before[i], field.GetY(i) );
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef TESTSFTILEMAP_H
+#define TESTSFTILEMAP_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstring>
+
+using namespace std;
+
+#include "SFTileMap.h"
+
+class TestSFTileMap : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFTileMap );
+  CPPUNIT_TEST( testStreaming );
+  CPPUNIT_TEST( testSameLevel );
+  CPPUNIT_TEST( testCollision );
+  CPPUNIT_TEST_SUITE_END();
+
+  // Finds a wall in the slot's chunk, false if it has none
+  static bool FindWall(const SFChunk & chunk, int & row, int & column) {
+    for(row = 0; row < SF_CHUNK_ROWS; row++) {
+      for(column = 0; column < SF_CHUNK_COLUMNS; column++) {
+        if(chunk.tiles[row][column] == SFTILE_WALL) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+public:
+  TestSFTileMap( ) : CppUnit::TestCase( "TestSFTileMap" ) {}
+  TestSFTileMap( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testStreaming() {
+    SFTileMap map(1, 480);
+    // The screen and one chunk past the top of it
+    CPPUNIT_ASSERT_EQUAL( 3L, map.GetStreamed() );
+    CPPUNIT_ASSERT_EQUAL( 0, map.GetSlot(0).index );
+    CPPUNIT_ASSERT_EQUAL( 2, map.GetSlot(2).index );
+
+    // Far enough that chunk 0 has gone off the bottom
+    map.Advance(SF_CHUNK_H + 1.0f);
+    CPPUNIT_ASSERT_EQUAL( 1L, map.GetEvicted() );
+    for(int slot = 0; slot < SF_RESIDENT_CHUNKS; slot++) {
+      CPPUNIT_ASSERT( map.GetSlot(slot).index != 0 );
+    }
+
+    // A long way on, only ever the same few slots
+    for(int i = 0; i < 100; i++) {
+      map.Advance(SF_CHUNK_H / 4.0f);
+    }
+    int first = (int) (map.GetScroll() / SF_CHUNK_H);
+    CPPUNIT_ASSERT_EQUAL( first, map.GetSlot(first % SF_RESIDENT_CHUNKS).index );
+    long resident = 0;
+    for(int slot = 0; slot < SF_RESIDENT_CHUNKS; slot++) {
+      resident += map.GetSlot(slot).index >= 0 ? 1 : 0;
+    }
+    CPPUNIT_ASSERT_EQUAL( map.GetStreamed() - resident, map.GetEvicted() );
+  }
+
+  void testSameLevel() {
+    // A chunk comes out the same whenever it's streamed in
+    SFTileMap a(5, 480), b(5, 480);
+    a.Advance(SF_CHUNK_H * 10.0f);
+    for(int i = 0; i < 40; i++) {
+      b.Advance(SF_CHUNK_H / 4.0f);
+    }
+    for(int slot = 0; slot < SF_RESIDENT_CHUNKS; slot++) {
+      CPPUNIT_ASSERT_EQUAL( a.GetSlot(slot).index, b.GetSlot(slot).index );
+      if(a.GetSlot(slot).index < 0) {
+        continue;
+      }
+      CPPUNIT_ASSERT( memcmp(a.GetSlot(slot).tiles, b.GetSlot(slot).tiles, sizeof(a.GetSlot(slot).tiles)) == 0 );
+    }
+  }
+
+  void testCollision() {
+    SFTileMap map(1, 480);
+    CPPUNIT_ASSERT( !map.IsSolid(100.0f, 100.0f) );
+
+    // Scroll until a wall is on the screen, then find it
+    int row = 0, column = 0, slot = 0;
+    bool found = false;
+    while(!found && map.GetScroll() < 100 * SF_CHUNK_H) {
+      map.Advance(SF_CHUNK_H);
+      int bottom = (int) (map.GetScroll() / SF_CHUNK_H);
+      slot = bottom % SF_RESIDENT_CHUNKS;
+      found = FindWall(map.GetSlot(slot), row, column);
+    }
+    CPPUNIT_ASSERT( found );
+
+    // The middle of the tile in game space
+    float x = (column + 0.5f) * SF_TILE_W;
+    float y = map.GetChunkBottom(map.GetSlot(slot).index) + (row + 0.5f) * SF_TILE_H;
+    CPPUNIT_ASSERT( map.IsSolid(x, y) );
+    CPPUNIT_ASSERT_EQUAL( SFTILE_WALL, map.GetTile(x, y) );
+
+    // A box over it, and one that stops right at its edge
+    SFAABB over = { x - 20.0f, y - 20.0f, x + 20.0f, y + 20.0f };
+    CPPUNIT_ASSERT( map.IsSolid(over) );
+    float left = column * SF_TILE_W;
+    SFAABB touching = { left - 10.0f, y - 1.0f, left, y + 1.0f };
+    if(column > 0 && !map.IsSolid(left - 1.0f, y)) {
+      CPPUNIT_ASSERT( !map.IsSolid(touching) );
+    }
+
+    // Off the sides of the level is never solid
+    CPPUNIT_ASSERT( !map.IsSolid(-5.0f, y) );
+    CPPUNIT_ASSERT( !map.IsSolid(SF_CHUNK_COLUMNS * SF_TILE_W + 5.0f, y) );
+  }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef TESTSFTIMERWHEEL_H
+#define TESTSFTIMERWHEEL_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+#include "SFTimerWheel.h"
+
+class TestSFTimerWheel : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFTimerWheel );
+  CPPUNIT_TEST( testOneShot );
+  CPPUNIT_TEST( testRepeat );
+  CPPUNIT_TEST( testCancel );
+  CPPUNIT_TEST( testCascade );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSFTimerWheel( ) : CppUnit::TestCase( "TestSFTimerWheel" ) {}
+  TestSFTimerWheel( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testOneShot() {
+    SFTimerWheel wheel;
+    vector<SFTimerFired> fired;
+    SFTimerId id = wheel.Schedule(5, SFTIMER_EMITTER_FIRE, SF_NULL_HANDLE, 7);
+
+    wheel.Advance(4, fired);
+    CPPUNIT_ASSERT( fired.empty() );
+    CPPUNIT_ASSERT( wheel.IsPending(id) );
+
+    wheel.Advance(5, fired);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 1, fired.size() );
+    CPPUNIT_ASSERT( fired[0].id == id && fired[0].kind == SFTIMER_EMITTER_FIRE );
+    CPPUNIT_ASSERT_EQUAL( 7, fired[0].data );
+
+    // Gone once it went off
+    CPPUNIT_ASSERT( !wheel.IsPending(id) );
+    CPPUNIT_ASSERT_EQUAL( 0, wheel.GetPending() );
+    wheel.Advance(1000, fired);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 1, fired.size() );
+  }
+
+  void testRepeat() {
+    SFTimerWheel wheel;
+    vector<SFTimerFired> fired;
+    SFTimerId id = wheel.Repeat(30, 10, SFTIMER_EMITTER_FIRE);
+
+    wheel.Advance(100, fired);
+    // Ticks 10, 40, 70 and 100
+    CPPUNIT_ASSERT_EQUAL( (size_t) 4, fired.size() );
+    CPPUNIT_ASSERT( wheel.IsPending(id) );
+
+    wheel.Cancel(id);
+    wheel.Advance(1000, fired);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 4, fired.size() );
+  }
+
+  void testCancel() {
+    SFTimerWheel wheel;
+    vector<SFTimerFired> fired;
+    SFTimerId a = wheel.Schedule(10, SFTIMER_POWER_EXPIRE);
+    SFTimerId b = wheel.Schedule(10, SFTIMER_ENEMY_FIRE);
+    wheel.Cancel(a);
+    wheel.Cancel(a);
+
+    wheel.Advance(10, fired);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 1, fired.size() );
+    CPPUNIT_ASSERT( fired[0].id == b );
+
+    // Cancelling after it went off doesn't touch whatever reused its slot
+    SFTimerId c = wheel.Schedule(10, SFTIMER_ENEMY_FIRE);
+    wheel.Cancel(b);
+    CPPUNIT_ASSERT( wheel.IsPending(c) );
+  }
+
+  // Timers far enough off to start in the higher levels still go off on the right tick
+  void testCascade() {
+    SFTimerWheel wheel;
+    vector<SFTimerFired> fired;
+    map<SFTimerId, uint32_t> due;
+
+    srand(3);
+    for(int i = 0; i < 2000; i++) {
+      int delay = 1 + rand() % (i % 2 ? 300 : 100000);
+      due[wheel.Schedule(delay, SFTIMER_EMITTER_FIRE)] = delay;
+    }
+
+    for(uint32_t tick = 1; tick <= 100000; tick++) {
+      fired.clear();
+      wheel.Advance(tick, fired);
+      for(auto & f : fired) {
+        CPPUNIT_ASSERT_EQUAL( tick, due[f.id] );
+        due.erase(f.id);
+      }
+    }
+    CPPUNIT_ASSERT( due.empty() );
+    CPPUNIT_ASSERT( wheel.GetCascaded() > 0 );
+  }
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef TESTSFWAVE_H
+#define TESTSFWAVE_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestAssert.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <vector>
+
+using namespace std;
+
+#include "SFWave.h"
+
+class TestSFWave : public CPPUNIT_NS::TestCase {
+  CPPUNIT_TEST_SUITE( TestSFWave );
+  CPPUNIT_TEST( testSpreadOverFrames );
+  CPPUNIT_TEST( testWait );
+  CPPUNIT_TEST( testWaitFewer );
+  CPPUNIT_TEST( testRepeat );
+  CPPUNIT_TEST( testPatterns );
+  CPPUNIT_TEST( testCountOnly );
+  CPPUNIT_TEST_SUITE_END();
+
+  // Remembers where everything was spawned, and can pretend aliens died
+  struct Host : public SFWaveHost {
+    vector<Point2> spawned;
+    int dead = 0;
+
+    void SpawnWaveAlien(const Point2 & p) {
+      spawned.push_back(p);
+    }
+    int GetAlienCount() {
+      return spawned.size() - dead;
+    }
+  };
+
+public:
+  TestSFWave( ) : CppUnit::TestCase( "TestSFWave" ) {}
+  TestSFWave( std::string name ) : CppUnit::TestCase( name ) {}
+
+  void testSpreadOverFrames() {
+    Host host;
+    SFWaveRunner runner(2, 1000.0);
+    runner.Start(SFWave("nine").Spawn(9));
+
+    // Two a frame, so nine take five frames
+    for(int frame = 1; frame <= 4; frame++) {
+      runner.Update(host);
+      CPPUNIT_ASSERT_EQUAL( (size_t) 2 * frame, host.spawned.size() );
+      CPPUNIT_ASSERT_EQUAL( 1, runner.GetRunning() );
+    }
+    runner.Update(host);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 9, host.spawned.size() );
+    CPPUNIT_ASSERT_EQUAL( 0, runner.GetRunning() );
+    CPPUNIT_ASSERT_EQUAL( 9L, runner.GetSpawned() );
+    CPPUNIT_ASSERT_EQUAL( 4L, runner.GetDeferred() );
+  }
+
+  void testWait() {
+    Host host;
+    SFWaveRunner runner(10, 1000.0);
+    runner.Start(SFWave("wait").Spawn(1).Wait(3).Spawn(1));
+
+    runner.Update(host);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 1, host.spawned.size() );
+    for(int i = 0; i < 2; i++) {
+      runner.Update(host);
+      CPPUNIT_ASSERT_EQUAL( (size_t) 1, host.spawned.size() );
+    }
+    runner.Update(host);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 2, host.spawned.size() );
+    CPPUNIT_ASSERT_EQUAL( 0, runner.GetRunning() );
+  }
+
+  void testWaitFewer() {
+    Host host;
+    SFWaveRunner runner(10, 1000.0);
+    runner.Start(SFWave("fewer").Spawn(4).WaitFewer(2).Spawn(1));
+
+    for(int i = 0; i < 5; i++) {
+      runner.Update(host);
+    }
+    CPPUNIT_ASSERT_EQUAL( (size_t) 4, host.spawned.size() );
+
+    host.dead = 3;
+    runner.Update(host);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 5, host.spawned.size() );
+  }
+
+  void testRepeat() {
+    Host host;
+    SFWaveRunner runner(10, 1000.0);
+    runner.Start(SFWave("repeat").Spawn(2).Wait(1).Repeat(2));
+
+    for(int i = 0; i < 10; i++) {
+      runner.Update(host);
+    }
+    // Once, then twice more
+    CPPUNIT_ASSERT_EQUAL( (size_t) 6, host.spawned.size() );
+    CPPUNIT_ASSERT_EQUAL( 0, runner.GetRunning() );
+  }
+
+  void testPatterns() {
+    Host host;
+    SFWaveRunner runner(10, 1000.0);
+    runner.Start(SFWave("shapes").Spawn(3, SFWAVE_LINE).Spawn(3, SFWAVE_VEE));
+    runner.Update(host);
+    CPPUNIT_ASSERT_EQUAL( (size_t) 6, host.spawned.size() );
+
+    // A line is level and evenly spread
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( host.spawned[0].getY(), host.spawned[2].getY(), 0.001f );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( host.spawned[1].getX() - host.spawned[0].getX(), host.spawned[2].getX() - host.spawned[1].getX(), 0.001f );
+
+    // A vee's wings are level with each other and behind its point
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( host.spawned[4].getY(), host.spawned[5].getY(), 0.001f );
+    CPPUNIT_ASSERT( host.spawned[4].getY() > host.spawned[3].getY() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 640.0f, host.spawned[4].getX() + host.spawned[5].getX(), 0.001f );
+  }
+
+  void testCountOnly() {
+    // With no time limit however slow spawning is only the count stops it
+    SFSpawnBudget budget(3, 0.0, 50.0);
+    for(int i = 0; i < 3; i++) {
+      CPPUNIT_ASSERT( budget.CanSpawn() );
+      budget.Spent(50.0);
+    }
+    CPPUNIT_ASSERT( !budget.CanSpawn() );
+
+    // With one, a spawn that usually takes longer than what's left waits
+    SFSpawnBudget timed(3, 60.0, 50.0);
+    timed.Spent(50.0);
+    CPPUNIT_ASSERT( !timed.CanSpawn() );
+  }
+};
+
+#endif